@@ -4,6 +4,7 @@
 #include "binder/bound_expression.h"
 #include "binder/expressions/bound_constant.h"
 #include "binder/statement/set_show_statement.h"
+#include "binder/statement/vacuum_statement.h"
 #include "common/exception.h"
 namespace bustub {
 
@@ -23,4 +24,15 @@ auto Binder::BindVariableShow(duckdb_libpgquery::PGVariableShowStmt *stmt) -> st
   return std::make_unique<VariableShowStatement>(stmt->name);
 }
 
+auto Binder::BindVacuum(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<VacuumStatement> {
+  if ((stmt->options & duckdb_libpgquery::PG_VACOPT_VACUUM) == 0) {
+    throw bustub::NotImplementedException("ANALYZE is not supported");
+  }
+  if (stmt->relation != nullptr) {
+    // Free pages are tracked for the whole database file, not per table.
+    throw bustub::NotImplementedException("VACUUM of a single table is not supported");
+  }
+  return std::make_unique<VacuumStatement>((stmt->options & duckdb_libpgquery::PG_VACOPT_FULL) != 0);
+}
+
 }  // namespace bustub
@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_buffer.cpp
+//
+// Identification: src/buffer/access_buffer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/access_buffer.h"
+
+#include "common/metrics.h"
+
+namespace bustub {
+
+auto AccessBuffer::LocalStripe() -> Stripe & { return stripes_[ThreadStripe() % NUM_STRIPES]; }
+
+void AccessBuffer::Record(frame_id_t frame_id, AccessType access_type) {
+  auto &stripe = LocalStripe();
+  const uint64_t pos = stripe.write_pos_.fetch_add(1, std::memory_order_relaxed);
+  const uint64_t access = VALID_BIT | (static_cast<uint64_t>(access_type) << 32) | static_cast<uint32_t>(frame_id);
+  stripe.slots_[pos % STRIPE_SLOTS].store(access, std::memory_order_release);
+  stripe.counts_[static_cast<size_t>(access_type)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void AccessBuffer::Drain(const std::function<void(frame_id_t, AccessType)> &apply) {
+  for (auto &stripe : stripes_) {
+    const uint64_t end = stripe.write_pos_.load(std::memory_order_acquire);
+    uint64_t pos = stripe.read_pos_;
+    if (end - pos > STRIPE_SLOTS) {
+      pos = end - STRIPE_SLOTS;
+    }
+    for (; pos < end; pos++) {
+      // A writer that has taken a position but not stored yet is missed, its access lands in a later drain or is lost.
+      const uint64_t access = stripe.slots_[pos % STRIPE_SLOTS].exchange(0, std::memory_order_acquire);
+      if ((access & VALID_BIT) != 0) {
+        apply(static_cast<frame_id_t>(static_cast<uint32_t>(access)),
+              static_cast<AccessType>((access & ~VALID_BIT) >> 32));
+      }
+    }
+    stripe.read_pos_ = end;
+  }
+}
+
+auto AccessBuffer::GetCount(AccessType access_type) const -> uint64_t {
+  uint64_t count = 0;
+  for (const auto &stripe : stripes_) {
+    count += stripe.counts_[static_cast<size_t>(access_type)].load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+}  // namespace bustub
@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+ARCReplacer::ARCReplacer(size_t num_frames) : frames_(num_frames) {}
+
+auto ARCReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+  const bool prefer_t1 = !t1_.empty() && t1_.size() > target_;
+  auto victim = FindVictim(prefer_t1 ? t1_ : t2_);
+  if (!victim.has_value()) {
+    victim = FindVictim(prefer_t1 ? t2_ : t1_);
+  }
+  BUSTUB_ASSERT(victim.has_value(), "an evictable frame must be in T1 or T2");
+
+  auto &frame = frames_[*victim];
+  if (frame.page_id_ != INVALID_PAGE_ID) {
+    const bool in_b1 = frame.list_ == List::T1;
+    auto &ghost_list = in_b1 ? b1_ : b2_;
+    ghosts_[frame.page_id_] = Ghost{in_b1, ghost_list.insert(ghost_list.end(), frame.page_id_)};
+  }
+  EraseFrame(*victim);
+  TrimGhosts();
+  *frame_id = *victim;
+  return true;
+}
+
+void ARCReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, page_id_t page_id) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &frame = frames_[frame_id];
+  const bool is_scan = access_type == AccessType::Scan || access_type == AccessType::Prefetch;
+  if (frame.list_ != List::None) {
+    // Case I: a hit, the frame moves to the most recently used end of T2.
+    if (!is_scan) {
+      auto &list = frame.list_ == List::T1 ? t1_ : t2_;
+      t2_.splice(t2_.end(), list, frame.pos_);
+      frame.list_ = List::T2;
+    }
+    return;
+  }
+
+  frame.page_id_ = page_id;
+  auto ghost = ghosts_.find(page_id);
+  if (ghost != ghosts_.end()) {
+    const bool in_b1 = ghost->second.in_b1_;
+    if (!is_scan) {
+      // Cases II and III: the page was evicted too early, grow the side of the cache it was evicted from.
+      const size_t capacity = frames_.size();
+      if (in_b1) {
+        const size_t delta = std::max<size_t>(b2_.size() / b1_.size(), 1);
+        target_ = std::min(capacity, target_ + delta);
+      } else {
+        const size_t delta = std::max<size_t>(b1_.size() / b2_.size(), 1);
+        target_ = target_ > delta ? target_ - delta : 0;
+      }
+    }
+    (in_b1 ? b1_ : b2_).erase(ghost->second.pos_);
+    ghosts_.erase(ghost);
+    if (!is_scan) {
+      frame.list_ = List::T2;
+      frame.pos_ = t2_.insert(t2_.end(), frame_id);
+      return;
+    }
+  }
+  // Case IV: a miss, the page enters T1.
+  frame.list_ = List::T1;
+  frame.pos_ = t1_.insert(t1_.end(), frame_id);
+  TrimGhosts();
+}
+
+void ARCReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (frame.list_ == List::None || frame.is_evictable_ == set_evictable) {
+    return;
+  }
+  frame.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void ARCReplacer::Remove(frame_id_t frame_id) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (frames_[frame_id].list_ == List::None) {
+    return;
+  }
+  BUSTUB_ENSURE(frames_[frame_id].is_evictable_, "cannot remove a non-evictable frame");
+  EraseFrame(frame_id);
+}
+
+auto ARCReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+auto ARCReplacer::GetHotFrames() -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> frames(t2_.rbegin(), t2_.rend());
+  frames.insert(frames.end(), t1_.rbegin(), t1_.rend());
+  return frames;
+}
+
+auto ARCReplacer::GetTarget() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return target_;
+}
+
+auto ARCReplacer::FindVictim(const std::list<frame_id_t> &list) const -> std::optional<frame_id_t> {
+  for (auto frame_id : list) {
+    if (frames_[frame_id].is_evictable_) {
+      return frame_id;
+    }
+  }
+  return std::nullopt;
+}
+
+void ARCReplacer::EraseFrame(frame_id_t frame_id) {
+  auto &frame = frames_[frame_id];
+  (frame.list_ == List::T1 ? t1_ : t2_).erase(frame.pos_);
+  if (frame.is_evictable_) {
+    curr_size_--;
+  }
+  frame = Frame{};
+}
+
+void ARCReplacer::TrimGhosts() {
+  const size_t capacity = frames_.size();
+  while (!b1_.empty() && t1_.size() + b1_.size() > capacity) {
+    PopGhost(true);
+  }
+  while (t1_.size() + t2_.size() + b1_.size() + b2_.size() > 2 * capacity) {
+    PopGhost(b2_.empty());
+  }
+}
+
+void ARCReplacer::PopGhost(bool from_b1) {
+  auto &ghost_list = from_b1 ? b1_ : b2_;
+  ghosts_.erase(ghost_list.front());
+  ghost_list.pop_front();
+}
+
+}  // namespace bustub
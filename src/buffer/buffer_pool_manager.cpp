@@ -12,56 +12,1026 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <numeric>
+
+#include "buffer/replacer_factory.h"
+#include "common/config.h"
 #include "common/exception.h"
+#include "common/logger.h"
 #include "common/macros.h"
+#include "recovery/log_manager.h"
 #include "storage/page/page_guard.h"
 
 namespace bustub {
 
+namespace {
+
+/** @return true if no page id appears twice */
+auto AreDistinct(std::vector<page_id_t> page_ids) -> bool {
+  std::sort(page_ids.begin(), page_ids.end());
+  return std::adjacent_find(page_ids.begin(), page_ids.end()) == page_ids.end();
+}
+
+}  // namespace
+
+auto BufferPoolStats::operator+=(const BufferPoolStats &other) -> BufferPoolStats & {
+  for (size_t i = 0; i < NUM_ACCESS_TYPES; i++) {
+    hits_[i] += other.hits_[i];
+    misses_[i] += other.misses_[i];
+  }
+  evictions_ += other.evictions_;
+  write_backs_ += other.write_backs_;
+  flusher_writes_ += other.flusher_writes_;
+  pin_wait_ += other.pin_wait_;
+  compressed_hits_ += other.compressed_hits_;
+  compressed_pages_ += other.compressed_pages_;
+  compressed_bytes_ += other.compressed_bytes_;
+  return *this;
+}
+
+auto BufferPoolStats::GetHitRatio() const -> double {
+  uint64_t hits = 0;
+  uint64_t fetches = 0;
+  for (size_t i = 0; i < NUM_ACCESS_TYPES; i++) {
+    hits += hits_[i];
+    fetches += hits_[i] + misses_[i];
+  }
+  return fetches == 0 ? 0 : static_cast<double>(hits) / static_cast<double>(fetches);
+}
+
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // TODO(students): remove this line after you have implemented the buffer pool manager
-  throw NotImplementedException(
-      "BufferPoolManager is not implemented yet. If you have finished implementing BPM, please remove the throw "
-      "exception line in `buffer_pool_manager.cpp`.");
+                                     LogManager *log_manager, ReplacerType replacer_type,
+                                     const FrameArenaOptions &arena_options)
+    : BufferPoolManager(pool_size, 1, 0, disk_manager, replacer_k, log_manager, replacer_type, arena_options) {}
+
+BufferPoolManager::BufferPoolManager(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                     DiskManager *disk_manager, size_t replacer_k, LogManager *log_manager,
+                                     ReplacerType replacer_type, const FrameArenaOptions &arena_options)
+    : pool_size_(pool_size),
+      page_size_(disk_manager->GetPageSize()),
+      usable_page_size_(disk_manager->GetUsablePageSize()),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(instance_index < num_instances,
+                "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should "
+                "just be 0.");
 
   // we allocate a consecutive memory space for the buffer pool
+  arena_ = std::make_unique<FrameArena>(pool_size_, page_size_, arena_options);
   pages_ = new Page[pool_size_];
-  replacer_ = std::make_unique<LRUKReplacer>(pool_size, replacer_k);
+  for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].data_ = arena_->GetFrame(static_cast<frame_id_t>(i));
+    pages_[i].page_size_ = page_size_;
+  }
+  replacer_ = ReplacerFactory::CreateReplacer(replacer_type, pool_size, replacer_k);
+  page_table_ = std::make_unique<PageTable>(pool_size);
+  disk_scheduler_ = std::make_unique<DiskScheduler>(disk_manager);
+  frame_loads_.resize(pool_size_);
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
     free_list_.emplace_back(static_cast<int>(i));
   }
+  disk_manager_->RegisterPageBuffers(GetFrameBuffers());
 }
 
-BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
+BufferPoolManager::BufferPoolManager(size_t pool_size, size_t page_size, size_t usable_page_size)
+    : pool_size_(pool_size), page_size_(page_size), usable_page_size_(usable_page_size) {}
 
-auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * { return nullptr; }
+BufferPoolManager::~BufferPoolManager() {
+  // stop the I/O workers before the frames they may point into go away
+  StopWarmUp();
+  StopFlusher();
+  disk_scheduler_.reset();
+  if (pages_ != nullptr) {
+    disk_manager_->UnregisterPageBuffers(GetFrameBuffers());
+  }
+  delete[] pages_;
+}
 
-auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
-  return nullptr;
+auto BufferPoolManager::GetFrameBuffers() -> std::vector<char *> {
+  std::vector<char *> buffers;
+  buffers.reserve(pool_size_);
+  for (size_t i = 0; i < pool_size_; ++i) {
+    buffers.push_back(pages_[i].GetData());
+  }
+  return buffers;
+}
+
+auto BufferPoolManager::ScheduleIO(bool is_write, frame_id_t frame_id) -> std::future<bool> {
+  Page *page = &pages_[frame_id];
+  auto promise = disk_scheduler_->CreatePromise();
+  auto future = promise.get_future();
+  disk_scheduler_->Schedule({is_write, page->GetData(), page->GetPageId(), std::move(promise)});
+  return future;
+}
+
+auto BufferPoolManager::LoadPage(frame_id_t frame_id) -> std::future<bool> {
+  Page *page = &pages_[frame_id];
+  if (compressed_cache_ != nullptr && compressed_cache_->Take(page->GetPageId(), page->GetData())) {
+    std::promise<bool> loaded;
+    loaded.set_value(true);
+    return loaded.get_future();
+  }
+  return ScheduleIO(false, frame_id);
+}
+
+auto BufferPoolManager::AcquireFrame(frame_id_t *frame_id, Eviction *eviction) -> bool {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    pages_[*frame_id].pin_count_.fetch_add(FRAME_LOCKED);
+    return true;
+  }
+
+  // Hits pin frames without the latch and without telling the replacer, so it may offer a pinned frame. Such frames
+  // are handed back to the replacer as just accessed, which they are.
+  DrainAccesses();
+  std::vector<frame_id_t> pinned;
+  // Prefetched frames whose read is still in flight are passed over, so that nobody waits for a disk read under the
+  // latch. They are held locked until the search ends, and then go back to the replacer as the prefetches they are.
+  std::vector<frame_id_t> loading;
+  bool found = false;
+  while (!found && replacer_->Evict(frame_id)) {
+    if (!TryLockFrame(*frame_id)) {
+      pinned.push_back(*frame_id);
+    } else if (frame_loads_[*frame_id].valid() &&
+               frame_loads_[*frame_id].wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      loading.push_back(*frame_id);
+    } else {
+      found = true;
+    }
+  }
+  if (!found && !loading.empty()) {
+    // Every evictable frame is being prefetched. Waiting for the oldest of them beats failing the caller.
+    *frame_id = loading.front();
+    loading.erase(loading.begin());
+    found = true;
+  }
+  for (auto pinned_frame : pinned) {
+    replacer_->RecordAccess(pinned_frame, AccessType::Unknown, pages_[pinned_frame].GetPageId());
+    replacer_->SetEvictable(pinned_frame, true);
+  }
+  for (auto loading_frame : loading) {
+    UnlockFrame(loading_frame, 0);
+    replacer_->RecordAccess(loading_frame, AccessType::Prefetch, pages_[loading_frame].GetPageId());
+    replacer_->SetEvictable(loading_frame, true);
+  }
+  if (!found) {
+    return false;
+  }
+
+  const bool loaded = WaitForPrefetch(*frame_id);
+  Page *victim = &pages_[*frame_id];
+  page_table_->Erase(victim->GetPageId());
+  evictions_.Add();
+  // Invalidates optimistic reads of the victim page. Anyone reading the version from now on no longer finds the
+  // frame in the page table.
+  victim->version_.fetch_add(2);
+  if (victim->IsDirty()) {
+    // Scheduled under the latch, so a later read of the victim page is queued behind this write. The flusher is
+    // falling behind, wake it up.
+    eviction->write_back_ = ScheduleIO(true, *frame_id);
+    write_backs_.Add();
+    flusher_cv_.notify_one();
+  }
+  if (compressed_cache_ != nullptr && loaded && victim->GetPageId() != INVALID_PAGE_ID) {
+    // Compressed by FinishEviction, without the latch. Reserved under the latch, so that the copy is dropped if the
+    // page is fetched again or deleted before it lands.
+    eviction->cached_page_id_ = victim->GetPageId();
+    eviction->cache_ticket_ = compressed_cache_->Reserve(victim->GetPageId());
+  }
+  return true;
+}
+
+void BufferPoolManager::FinishEviction(frame_id_t frame_id, Eviction *eviction) {
+  if (eviction->cached_page_id_ != INVALID_PAGE_ID) {
+    // Nobody can change the victim before its frame is reused, so the copy is the page as it is, or is about to be,
+    // on disk.
+    compressed_cache_->Insert(eviction->cached_page_id_, pages_[frame_id].GetData(), eviction->cache_ticket_);
+    eviction->cached_page_id_ = INVALID_PAGE_ID;
+  }
+  if (eviction->write_back_.valid()) {
+    eviction->write_back_.get();
+  }
+}
+
+auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * { return NewPageNear(page_id, INVALID_PAGE_ID); }
+
+auto BufferPoolManager::NewPageNear(page_id_t *page_id, page_id_t hint) -> Page * {
+  return NewPageAt(page_id, hint, INVALID_SEGMENT_ID);
+}
+
+auto BufferPoolManager::NewPageInSegment(page_id_t *page_id, segment_id_t segment) -> Page * {
+  return NewPageAt(page_id, INVALID_PAGE_ID, segment);
+}
+
+auto BufferPoolManager::CreateSegment() -> segment_id_t { return disk_manager_->CreateSegment(); }
+
+auto BufferPoolManager::NewPageAt(page_id_t *page_id, page_id_t hint, segment_id_t segment) -> Page * {
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  Eviction eviction;
+  if (!AcquireFrame(&frame_id, &eviction)) {
+    return nullptr;
+  }
+
+  *page_id = AllocatePage(hint, segment);
+  Page *page = &pages_[frame_id];
+  page->page_id_ = *page_id;
+  page->is_dirty_ = false;
+  page_table_->Insert(*page_id, frame_id);
+
+  replacer_->RecordAccess(frame_id, AccessType::Unknown, *page_id);
+  replacer_->SetEvictable(frame_id, true);
+  UnlockFrame(frame_id, 1);
+
+  if (!eviction.IsPending()) {
+    page->ResetMemory();
+    page_table_->SetReady(*page_id);
+    return page;
+  }
+
+  std::promise<bool> loaded;
+  frame_loads_[frame_id] = loaded.get_future().share();
+  lock.unlock();
+
+  // The frame is pinned, so nobody else touches it while we wait for the victim to reach the disk.
+  {
+    ScopedLatency wait(&pin_wait_);
+    FinishEviction(frame_id, &eviction);
+  }
+  page->ResetMemory();
+  loaded.set_value(true);
+
+  lock.lock();
+  frame_loads_[frame_id] = {};
+  page_table_->SetReady(*page_id);
+  return page;
+}
+
+auto BufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type) -> Page * {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "cannot fetch an invalid page");
+  frame_id_t frame_id;
+  if (page_table_->FindReady(page_id, &frame_id) && TryPinReady(page_id, frame_id)) {
+    access_buffer_.Record(frame_id, access_type);
+    return &pages_[frame_id];
+  }
+
+  std::unique_lock<std::mutex> lock(latch_);
+  if (page_table_->Find(page_id, &frame_id)) {
+    Page *page = &pages_[frame_id];
+    page->pin_count_.fetch_add(1);
+    access_buffer_.Record(frame_id, access_type);
+    if (frame_loads_[frame_id].valid()) {
+      auto load = frame_loads_[frame_id];
+      if (load.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        // Another thread (or a prefetch) is still reading the page in, wait for it without holding the latch.
+        lock.unlock();
+        {
+          ScopedLatency wait(&pin_wait_);
+          load.wait();
+        }
+        if (auto error = LoadError(load)) {
+          lock.lock();
+          DiscardFailedLoad(frame_id);
+          std::rethrow_exception(error);
+        }
+        return page;
+      }
+      if (auto error = LoadError(load)) {
+        // A prefetch of a corrupt page.
+        DiscardFailedLoad(frame_id);
+        std::rethrow_exception(error);
+      }
+      // A prefetch that has already landed, nobody else is going to clear it.
+      frame_loads_[frame_id] = {};
+    }
+    page_table_->SetReady(page_id);
+    return page;
+  }
+
+  // A reader that found page_id in a page it had not latched may be late: the page may have been deleted since.
+  // Deletion happens under the latch, so reading it back in now would resurrect it under an id that gets reused.
+  if (!disk_manager_->IsAllocated(page_id)) {
+    return nullptr;
+  }
+  Eviction eviction;
+  if (!AcquireFrame(&frame_id, &eviction)) {
+    return nullptr;
+  }
+
+  Page *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page->is_dirty_ = false;
+  page_table_->Insert(page_id, frame_id);
+  misses_[static_cast<size_t>(access_type)]++;
+
+  replacer_->RecordAccess(frame_id, access_type, page_id);
+  replacer_->SetEvictable(frame_id, true);
+  UnlockFrame(frame_id, 1);
+
+  std::promise<bool> loaded;
+  frame_loads_[frame_id] = loaded.get_future().share();
+  lock.unlock();
+
+  // The frame is pinned, so it stays ours while the I/O runs without the latch. Any pending write of page_id was
+  // scheduled under the latch before it left the page table, so the read below is queued behind it.
+  std::exception_ptr error;
+  {
+    ScopedLatency wait(&pin_wait_);
+    FinishEviction(frame_id, &eviction);
+    try {
+      LoadPage(frame_id).get();
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }
+  if (error != nullptr) {
+    loaded.set_exception(error);
+    lock.lock();
+    DiscardFailedLoad(frame_id);
+    std::rethrow_exception(error);
+  }
+  loaded.set_value(true);
+
+  lock.lock();
+  frame_loads_[frame_id] = {};
+  page_table_->SetReady(page_id);
+  return page;
+}
+
+auto BufferPoolManager::FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<Page *> {
+  auto batch = StartFetchPages(page_ids, access_type);
+  return FinishFetchPages(&batch);
+}
+
+auto BufferPoolManager::StartFetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> FetchBatch {
+  BUSTUB_ASSERT(AreDistinct(page_ids), "page ids must be distinct");
+  FetchBatch batch;
+  batch.pages_.resize(page_ids.size(), nullptr);
+  // The pages to read from disk in page id order, each with its position in page_ids.
+  std::map<page_id_t, size_t> misses;
+  std::vector<Eviction> evictions;
+
+  std::unique_lock<std::mutex> lock(latch_);
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    BUSTUB_ASSERT(page_ids[i] != INVALID_PAGE_ID, "cannot fetch an invalid page");
+    frame_id_t frame_id;
+    if (!page_table_->Find(page_ids[i], &frame_id)) {
+      misses[page_ids[i]] = i;
+      continue;
+    }
+    batch.pages_[i] = &pages_[frame_id];
+    batch.pages_[i]->pin_count_.fetch_add(1);
+    access_buffer_.Record(frame_id, access_type);
+    if (frame_loads_[frame_id].valid()) {
+      auto load = frame_loads_[frame_id];
+      if (load.wait_for(std::chrono::seconds(0)) != std::future_status::ready || LoadError(load) != nullptr) {
+        batch.loading_.emplace_back(frame_id, std::move(load));
+        continue;
+      }
+      frame_loads_[frame_id] = {};
+    }
+    page_table_->SetReady(page_ids[i]);
+  }
+
+  for (auto &[page_id, position] : misses) {
+    // Like FetchPage, a deleted page is not read back in.
+    if (!disk_manager_->IsAllocated(page_id)) {
+      continue;
+    }
+    frame_id_t frame_id;
+    Eviction eviction;
+    if (!AcquireFrame(&frame_id, &eviction)) {
+      // Every frame is pinned, the remaining pages are left out.
+      break;
+    }
+    Page *page = &pages_[frame_id];
+    page->page_id_ = page_id;
+    page->is_dirty_ = false;
+    page_table_->Insert(page_id, frame_id);
+    misses_[static_cast<size_t>(access_type)]++;
+
+    replacer_->RecordAccess(frame_id, access_type, page_id);
+    replacer_->SetEvictable(frame_id, true);
+    UnlockFrame(frame_id, 1);
+    batch.pages_[position] = page;
+
+    FetchBatch::Read read{frame_id, {}, {}, {}};
+    read.load_ = read.loaded_.get_future().share();
+    frame_loads_[frame_id] = read.load_;
+    batch.reads_.push_back(std::move(read));
+    evictions.push_back(std::move(eviction));
+  }
+  lock.unlock();
+
+  if (batch.reads_.empty()) {
+    return batch;
+  }
+  ScopedLatency wait(&pin_wait_);
+  // The write-backs are already in flight. Once the frames are free, every read is scheduled, FinishFetchPages waits
+  // for them.
+  for (size_t i = 0; i < evictions.size(); i++) {
+    FinishEviction(batch.reads_[i].frame_id_, &evictions[i]);
+  }
+  for (auto &read : batch.reads_) {
+    read.done_ = LoadPage(read.frame_id_);
+  }
+  return batch;
+}
+
+auto BufferPoolManager::FinishFetchPages(FetchBatch *batch) -> std::vector<Page *> {
+  if (batch->reads_.empty() && batch->loading_.empty()) {
+    return std::move(batch->pages_);
+  }
+  {
+    ScopedLatency wait(&pin_wait_);
+    for (auto &read : batch->reads_) {
+      try {
+        read.done_.get();
+        read.loaded_.set_value(true);
+      } catch (...) {
+        read.loaded_.set_exception(std::current_exception());
+      }
+    }
+    for (auto &[frame_id, load] : batch->loading_) {
+      load.wait();
+    }
+  }
+
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::exception_ptr error;
+  std::vector<frame_id_t> failed;
+  for (auto &read : batch->reads_) {
+    // A fetch that found the failed read may have discarded the frame already, the read keeps its own future.
+    if (auto read_error = LoadError(read.load_)) {
+      error = read_error;
+      failed.push_back(read.frame_id_);
+      continue;
+    }
+    frame_loads_[read.frame_id_] = {};
+    page_table_->SetReady(pages_[read.frame_id_].GetPageId());
+  }
+  for (auto &[frame_id, load] : batch->loading_) {
+    if (auto load_error = LoadError(load)) {
+      error = load_error;
+      failed.push_back(frame_id);
+    }
+  }
+  if (error == nullptr) {
+    return std::move(batch->pages_);
+  }
+  // The caller gets nothing but the exception, so every pin taken by this call goes back.
+  for (auto *page : batch->pages_) {
+    if (page == nullptr) {
+      continue;
+    }
+    const auto frame_id = static_cast<frame_id_t>(page - pages_);
+    if (std::find(failed.begin(), failed.end(), frame_id) != failed.end()) {
+      DiscardFailedLoad(frame_id);
+    } else {
+      ReleasePin(page, false);
+    }
+  }
+  std::rethrow_exception(error);
 }
 
 auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
+  frame_id_t frame_id;
+  if (page_table_->FindReady(page_id, &frame_id) && pages_[frame_id].GetPageId() == page_id) {
+    // The caller holds a pin, so the frame cannot change hands while we release it.
+    return ReleasePin(&pages_[frame_id], is_dirty);
+  }
+
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (!page_table_->Find(page_id, &frame_id)) {
+    return false;
+  }
+  return ReleasePin(&pages_[frame_id], is_dirty);
+}
+
+auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "cannot flush an invalid page");
+  std::scoped_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!page_table_->Find(page_id, &frame_id)) {
+    return false;
+  }
+  // Loads complete without the latch, so it is safe to wait for them here. A page that could not be loaded has
+  // nothing worth writing.
+  if (frame_loads_[frame_id].valid()) {
+    frame_loads_[frame_id].wait();
+    if (LoadError(frame_loads_[frame_id]) != nullptr) {
+      return false;
+    }
+  }
+  // Cleared before the write, so that a change made while it runs marks the page dirty again.
+  pages_[frame_id].is_dirty_ = false;
+  ScheduleIO(true, frame_id).get();
+  return true;
+}
+
+void BufferPoolManager::FlushAllPages() {
+  // Pages deleted from here on may still be pointed to by pages this flush misses, they are saved by the next one.
+  const auto free_pages = disk_manager_->GetFreePages();
+  std::unique_lock<std::mutex> lock(latch_);
+  std::vector<std::future<bool>> writes;
+  writes.reserve(page_table_->Size());
+  for (size_t i = 0; i < pool_size_; i++) {
+    const auto frame_id = static_cast<frame_id_t>(i);
+    // Frames on the free list hold no page, every other frame is in the page table.
+    if (pages_[frame_id].GetPageId() == INVALID_PAGE_ID) {
+      continue;
+    }
+    if (frame_loads_[frame_id].valid()) {
+      frame_loads_[frame_id].wait();
+      if (LoadError(frame_loads_[frame_id]) != nullptr) {
+        continue;
+      }
+    }
+    pages_[frame_id].is_dirty_ = false;
+    writes.emplace_back(ScheduleIO(true, frame_id));
+  }
+  for (auto &write : writes) {
+    write.get();
+  }
+  // Writes are not synced one by one, this is the point where the whole pool becomes durable.
+  disk_manager_->Sync();
+  lock.unlock();
+  disk_manager_->SaveFreeSpaceMap(free_pages);
+  SaveHotSetFile();
+}
+
+auto BufferPoolManager::Vacuum() -> size_t {
+  const auto free_pages = disk_manager_->GetFreePages();
+  FlushAllPages();
+  return disk_manager_->Vacuum(free_pages);
+}
+
+auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!page_table_->Find(page_id, &frame_id)) {
+    if (compressed_cache_ != nullptr) {
+      compressed_cache_->Erase(page_id);
+    }
+    DeallocatePage(page_id);
+    return true;
+  }
+  if (!TryLockFrame(frame_id)) {
+    return false;
+  }
+
+  WaitForPrefetch(frame_id);
+  replacer_->Remove(frame_id);
+  page_table_->Erase(page_id);
+
+  Page *page = &pages_[frame_id];
+  page->version_.fetch_add(2);
+  page->ResetMemory();
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  UnlockFrame(frame_id, 0);
+  free_list_.push_back(frame_id);
+
+  DeallocatePage(page_id);
+  return true;
+}
+
+auto BufferPoolManager::Prefetch(page_id_t page_id, bool evict) -> bool {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "cannot prefetch an invalid page");
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (page_table_->Find(page_id, &frame_id) || !disk_manager_->IsAllocated(page_id)) {
+    return false;
+  }
+  Eviction eviction;
+  if ((!evict && free_list_.empty()) || !AcquireFrame(&frame_id, &eviction)) {
+    return false;
+  }
+
+  Page *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page->is_dirty_ = false;
+  page_table_->Insert(page_id, frame_id);
+
+  // The frame is evictable right away. AcquireFrame and DeletePage wait for the read before reusing it.
+  replacer_->RecordAccess(frame_id, AccessType::Prefetch, page_id);
+  replacer_->SetEvictable(frame_id, true);
+  UnlockFrame(frame_id, 0);
+
+  // The disk scheduler completes the load, nobody waits for it here. The page becomes visible to lock-free hits the
+  // first time it is fetched.
+  auto loaded = disk_scheduler_->CreatePromise();
+  frame_loads_[frame_id] = loaded.get_future().share();
+  lock.unlock();
+  FinishEviction(frame_id, &eviction);
+  if (compressed_cache_ != nullptr && compressed_cache_->Take(page_id, page->GetData())) {
+    loaded.set_value(true);
+    return true;
+  }
+  disk_scheduler_->Schedule({false, page->GetData(), page_id, std::move(loaded)});
+  return true;
+}
+
+auto BufferPoolManager::PrefetchRange(page_id_t first_page_id, size_t num_pages) -> size_t {
+  size_t scheduled = 0;
+  for (size_t i = 0; i < num_pages; i++) {
+    if (Prefetch(first_page_id + static_cast<page_id_t>(i))) {
+      scheduled++;
+    }
+  }
+  return scheduled;
+}
+
+auto BufferPoolManager::GetHotPages() -> std::vector<page_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  DrainAccesses();
+  std::vector<page_id_t> pages;
+  for (auto frame_id : replacer_->GetHotFrames()) {
+    const page_id_t page_id = pages_[frame_id].GetPageId();
+    if (page_id != INVALID_PAGE_ID) {
+      pages.push_back(page_id);
+    }
+  }
+  return pages;
+}
+
+auto BufferPoolManager::SaveHotSet(const std::string &file_name) -> bool {
+  const std::string tmp_file_name = file_name + ".tmp";
+  {
+    std::ofstream out(tmp_file_name, std::ios::trunc);
+    for (auto page_id : GetHotPages()) {
+      out << page_id << '\n';
+    }
+    if (!out.good()) {
+      LOG_WARN("can't write hot set file %s", tmp_file_name.c_str());
+      return false;
+    }
+  }
+  return std::rename(tmp_file_name.c_str(), file_name.c_str()) == 0;
+}
+
+void BufferPoolManager::SetHotSetFile(const std::string &file_name) { hot_set_file_ = file_name; }
+
+void BufferPoolManager::SaveHotSetFile() {
+  if (!hot_set_file_.empty()) {
+    SaveHotSet(hot_set_file_);
+  }
+}
+
+auto BufferPoolManager::WarmUp(const std::string &file_name, size_t pages_per_second) -> size_t {
+  std::vector<page_id_t> pages;
+  std::ifstream in(file_name);
+  page_id_t page_id;
+  while (pages.size() < pool_size_ && in >> page_id) {
+    if (page_id >= 0) {
+      pages.push_back(page_id);
+    }
+  }
+  // The file lists the hottest pages first. Once the ones that fit are picked, read them in disk order.
+  std::sort(pages.begin(), pages.end());
+  pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+  const auto start = std::chrono::steady_clock::now();
+  size_t scheduled = 0;
+  for (size_t i = 0; i < pages.size(); i++) {
+    if (i % WARM_UP_BATCH_PAGES == 0) {
+      auto deadline = start;
+      if (pages_per_second > 0) {
+        deadline += std::chrono::microseconds(i * 1000000 / pages_per_second);
+      }
+      std::unique_lock<std::mutex> lock(warm_up_latch_);
+      if (warm_up_cv_.wait_until(lock, deadline, [this] { return warm_up_stop_; })) {
+        break;
+      }
+    }
+    if (Prefetch(pages[i], false)) {
+      scheduled++;
+    }
+  }
+  return scheduled;
+}
+
+void BufferPoolManager::StartWarmUp(const std::string &file_name, size_t pages_per_second) {
+  std::scoped_lock<std::mutex> lock(warm_up_latch_);
+  if (warm_up_.joinable()) {
+    return;
+  }
+  warm_up_stop_ = false;
+  warm_up_ = std::thread([this, file_name, pages_per_second] { WarmUp(file_name, pages_per_second); });
+}
+
+void BufferPoolManager::StopWarmUp() {
+  {
+    std::scoped_lock<std::mutex> lock(warm_up_latch_);
+    if (!warm_up_.joinable()) {
+      return;
+    }
+    warm_up_stop_ = true;
+  }
+  warm_up_cv_.notify_one();
+  warm_up_.join();
+  std::scoped_lock<std::mutex> lock(warm_up_latch_);
+  warm_up_stop_ = false;
+}
+
+auto BufferPoolManager::GetHitCount(AccessType access_type) -> uint64_t {
+  return access_buffer_.GetCount(access_type);
+}
+
+auto BufferPoolManager::GetMissCount(AccessType access_type) -> uint64_t {
+  return misses_[static_cast<size_t>(access_type)];
+}
+
+auto BufferPoolManager::GetStats() -> BufferPoolStats {
+  BufferPoolStats stats;
+  for (size_t i = 0; i < NUM_ACCESS_TYPES; i++) {
+    stats.hits_[i] = access_buffer_.GetCount(static_cast<AccessType>(i));
+    stats.misses_[i] = misses_[i];
+  }
+  stats.evictions_ = evictions_.Get();
+  stats.write_backs_ = write_backs_.Get();
+  stats.flusher_writes_ = flusher_writes_.Get();
+  stats.pin_wait_ = pin_wait_.GetSnapshot();
+  if (compressed_cache_ != nullptr) {
+    stats.compressed_hits_ = compressed_cache_->GetHitCount();
+    stats.compressed_pages_ = compressed_cache_->GetNumPages();
+    stats.compressed_bytes_ = compressed_cache_->GetSize();
+  }
+  return stats;
+}
+
+void BufferPoolManager::SetCompressedCacheSize(size_t capacity) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  compressed_cache_ = capacity == 0 ? nullptr : std::make_unique<CompressedPageCache>(capacity, page_size_);
+}
+
+auto BufferPoolManager::TryPinReady(page_id_t page_id, frame_id_t frame_id) -> bool {
+  Page *page = &pages_[frame_id];
+  // Pin first, which keeps the frame from being evicted, then check that it still holds the page. A frame that is
+  // being evicted has a negative pin count, and one that was reused since the lookup no longer maps to the page.
+  if (page->pin_count_.fetch_add(1) >= 0 && page->GetPageId() == page_id) {
+    frame_id_t current;
+    if (page_table_->FindReady(page_id, &current) && current == frame_id) {
+      return true;
+    }
+  }
+  page->pin_count_.fetch_sub(1);
   return false;
 }
 
-auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool { return false; }
+auto BufferPoolManager::ReleasePin(Page *page, bool is_dirty) -> bool {
+  int pin_count = page->pin_count_.load();
+  if (pin_count <= 0) {
+    return false;
+  }
+  // Marked before the pin is released, so that whoever evicts the frame next sees it.
+  if (is_dirty) {
+    page->is_dirty_ = true;
+  }
+  while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1)) {
+    if (pin_count <= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto BufferPoolManager::TryLockFrame(frame_id_t frame_id) -> bool {
+  int unpinned = 0;
+  return pages_[frame_id].pin_count_.compare_exchange_strong(unpinned, FRAME_LOCKED);
+}
+
+void BufferPoolManager::UnlockFrame(frame_id_t frame_id, int pin_count) {
+  pages_[frame_id].pin_count_.fetch_add(pin_count - FRAME_LOCKED);
+}
+
+void BufferPoolManager::DrainAccesses() {
+  access_buffer_.Drain([this](frame_id_t frame_id, AccessType access_type) {
+    // Skip frames that went back to the free list since the access.
+    const page_id_t page_id = pages_[frame_id].GetPageId();
+    if (page_id != INVALID_PAGE_ID) {
+      replacer_->RecordAccess(frame_id, access_type, page_id);
+    }
+  });
+}
+
+auto BufferPoolManager::WaitForPrefetch(frame_id_t frame_id) -> bool {
+  if (!frame_loads_[frame_id].valid()) {
+    return true;
+  }
+  frame_loads_[frame_id].wait();
+  const bool loaded = LoadError(frame_loads_[frame_id]) == nullptr;
+  frame_loads_[frame_id] = {};
+  return loaded;
+}
+
+void BufferPoolManager::DiscardFailedLoad(frame_id_t frame_id) {
+  Page *page = &pages_[frame_id];
+  if (page->GetPageId() != INVALID_PAGE_ID) {
+    page_table_->Erase(page->GetPageId());
+    page->version_.fetch_add(2);
+    page->page_id_ = INVALID_PAGE_ID;
+    page->is_dirty_ = false;
+    frame_loads_[frame_id] = {};
+  }
+  // Others waiting for the same load still hold pins, the last one to leave frees the frame.
+  if (page->pin_count_.fetch_sub(1) == 1 && TryLockFrame(frame_id)) {
+    replacer_->Remove(frame_id);
+    page->ResetMemory();
+    UnlockFrame(frame_id, 0);
+    free_list_.push_back(frame_id);
+  }
+}
+
+auto BufferPoolManager::LoadError(const std::shared_future<bool> &load) -> std::exception_ptr {
+  try {
+    load.get();
+  } catch (...) {
+    return std::current_exception();
+  }
+  return nullptr;
+}
+
+auto BufferPoolManager::AllocatePage(page_id_t hint, segment_id_t segment) -> page_id_t {
+  const page_id_t page_id = disk_manager_->AllocatePage(hint, num_instances_, instance_index_, segment);
+  ValidatePageId(page_id);
+  // FetchPage refuses deleted pages, so a page being reused cannot be in the buffer pool already.
+  [[maybe_unused]] frame_id_t frame_id;
+  BUSTUB_ASSERT(!page_table_->Find(page_id, &frame_id), "a deleted page was fetched");
+  return page_id;
+}
+
+void BufferPoolManager::ValidatePageId(const page_id_t page_id) const {
+  // allocated pages mod back to this BPI
+  BUSTUB_ASSERT(static_cast<uint32_t>(page_id) % num_instances_ == instance_index_,
+                "page id does not belong to this instance");
+}
+
+void BufferPoolManager::StartFlusher(size_t target_clean_percent) {
+  BUSTUB_ASSERT(target_clean_percent <= 100, "target_clean_percent is a percentage");
+  std::scoped_lock<std::mutex> lock(flusher_latch_);
+  if (flusher_.joinable()) {
+    return;
+  }
+  flusher_target_ = pool_size_ * target_clean_percent / 100;
+  flusher_stop_ = false;
+  flusher_ = std::thread([this] { RunFlusher(); });
+}
 
-void BufferPoolManager::FlushAllPages() {}
+void BufferPoolManager::StopFlusher() {
+  {
+    std::scoped_lock<std::mutex> lock(flusher_latch_);
+    if (!flusher_.joinable()) {
+      return;
+    }
+    flusher_stop_ = true;
+  }
+  flusher_cv_.notify_one();
+  flusher_.join();
+}
+
+void BufferPoolManager::RunFlusher() {
+  std::unique_lock<std::mutex> lock(flusher_latch_);
+  while (!flusher_stop_) {
+    lock.unlock();
+    FlushAhead();
+    lock.lock();
+    if (!flusher_stop_) {
+      flusher_cv_.wait_for(lock, std::chrono::milliseconds(FLUSHER_INTERVAL_MS));
+    }
+  }
+}
+
+void BufferPoolManager::FlushAhead() {
+  // Free frames are unpinned and clean too. The count is only a hint, frames change state while it runs.
+  size_t clean = 0;
+  for (size_t i = 0; i < pool_size_; i++) {
+    if (pages_[i].GetPinCount() == 0 && !pages_[i].IsDirty()) {
+      clean++;
+    }
+  }
+
+  const bool check_wal = enable_logging && log_manager_ != nullptr;
+  std::vector<frame_id_t> batch;
+  std::vector<std::future<bool>> writes;
+  auto complete_batch = [&] {
+    for (size_t i = 0; i < batch.size(); i++) {
+      writes[i].get();
+      pages_[batch[i]].RUnlatch();
+      ReleasePin(&pages_[batch[i]], false);
+    }
+    batch.clear();
+    writes.clear();
+  };
+
+  for (size_t scanned = 0; scanned < pool_size_ && clean < flusher_target_; scanned++) {
+    const auto frame_id = static_cast<frame_id_t>(flusher_hand_);
+    flusher_hand_ = (flusher_hand_ + 1) % pool_size_;
+    Page *page = &pages_[frame_id];
+    const page_id_t page_id = page->GetPageId();
+    if (page_id == INVALID_PAGE_ID || !page->IsDirty() || page->GetPinCount() != 0) {
+      continue;
+    }
+    // The pin keeps the frame from being evicted while it is written. Busy pages are skipped rather than waited for:
+    // they are not about to be evicted, and the flusher must not block on a latch while it holds others.
+    if (!TryPinReady(page_id, frame_id)) {
+      continue;
+    }
+    if (!page->TryRLatch()) {
+      ReleasePin(page, false);
+      continue;
+    }
+    // Write-ahead logging: the log records of the latest change must be on disk before the page is.
+    if (check_wal && page->GetLSN() > log_manager_->GetPersistentLSN()) {
+      page->RUnlatch();
+      ReleasePin(page, false);
+      continue;
+    }
+    // Cleared before the write, so that a change made once the latch is released marks the page dirty again.
+    page->is_dirty_ = false;
+    batch.push_back(frame_id);
+    writes.push_back(ScheduleIO(true, frame_id));
+    flusher_writes_.Add();
+    clean++;
+    if (batch.size() == static_cast<size_t>(FLUSHER_BATCH_PAGES)) {
+      complete_batch();
+    }
+  }
+  complete_batch();
+}
 
-auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool { return false; }
+auto BufferPoolManager::FetchPageBasic(page_id_t page_id, AccessType access_type) -> BasicPageGuard {
+  return {this, FetchPage(page_id, access_type)};
+}
 
-auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
+auto BufferPoolManager::FetchPageRead(page_id_t page_id, AccessType access_type) -> ReadPageGuard {
+  Page *page = FetchPage(page_id, access_type);
+  if (page != nullptr) {
+    page->RLatch();
+  }
+  return {this, page};
+}
 
-auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard { return {this, nullptr}; }
+auto BufferPoolManager::FetchPagesRead(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<ReadPageGuard> {
+  auto pages = FetchPages(page_ids, access_type);
+  std::vector<size_t> order(page_ids.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return page_ids[a] < page_ids[b]; });
+  for (auto position : order) {
+    if (pages[position] != nullptr) {
+      pages[position]->RLatch();
+    }
+  }
+  std::vector<ReadPageGuard> guards;
+  guards.reserve(pages.size());
+  for (auto *page : pages) {
+    guards.emplace_back(this, page);
+  }
+  return guards;
+}
 
-auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard { return {this, nullptr}; }
+auto BufferPoolManager::FetchPageWrite(page_id_t page_id, AccessType access_type) -> WritePageGuard {
+  Page *page = FetchPage(page_id, access_type);
+  if (page != nullptr) {
+    page->WLatch();
+  }
+  return {this, page};
+}
 
-auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard { return {this, nullptr}; }
+auto BufferPoolManager::FetchPageOptimistic(page_id_t page_id, AccessType access_type) -> OptimisticPageGuard {
+  frame_id_t frame_id;
+  if (!page_table_->FindReady(page_id, &frame_id)) {
+    return {};
+  }
+  Page *page = &pages_[frame_id];
+  const uint64_t version = page->GetVersion();
+  // Looked up again after reading the version: a frame that is reused is erased from the page table before its
+  // version changes, so finding it again means that version belongs to page_id.
+  frame_id_t current;
+  if ((version & 1) != 0 || !page_table_->FindReady(page_id, &current) || current != frame_id ||
+      page->GetPageId() != page_id) {
+    return {};
+  }
+  access_buffer_.Record(frame_id, access_type);
+  return {page, page_id, version};
+}
 
-auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard { return {this, nullptr}; }
+auto BufferPoolManager::NewPageGuarded(page_id_t *page_id, page_id_t hint) -> BasicPageGuard {
+  return {this, NewPageNear(page_id, hint)};
+}
 
 }  // namespace bustub
@@ -11,19 +11,95 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/clock_replacer.h"
+#include "common/exception.h"
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : frames_(num_pages) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto ClockReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+  // The first sweep clears the reference bits of all evictable frames, so the second one is bound to find a victim.
+  for (size_t i = 0; i < 2 * frames_.size(); i++) {
+    auto &frame = frames_[hand_];
+    auto current = hand_;
+    hand_ = (hand_ + 1) % frames_.size();
+    if (!frame.is_tracked_ || !frame.is_evictable_) {
+      continue;
+    }
+    if (frame.reference_) {
+      frame.reference_ = false;
+      continue;
+    }
+    frame = Frame{};
+    curr_size_--;
+    *frame_id = static_cast<frame_id_t>(current);
+    return true;
+  }
+  UNREACHABLE("an evictable frame must be found within two sweeps");
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, [[maybe_unused]] page_id_t page_id) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (!frame.is_tracked_) {
+    frame.is_tracked_ = true;
+    frame.reference_ = access_type != AccessType::Scan && access_type != AccessType::Prefetch;
+    return;
+  }
+  frame.reference_ = true;
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (!frame.is_tracked_ || frame.is_evictable_ == set_evictable) {
+    return;
+  }
+  frame.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
 
-auto ClockReplacer::Size() -> size_t { return 0; }
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (!frame.is_tracked_) {
+    return;
+  }
+  BUSTUB_ENSURE(frame.is_evictable_, "cannot remove a non-evictable frame");
+  frame = Frame{};
+  curr_size_--;
+}
+
+auto ClockReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+auto ClockReplacer::GetHotFrames() -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // Clock keeps no order beyond the reference bit: referenced frames survive the next sweep, the others may not.
+  std::vector<frame_id_t> frames;
+  for (bool referenced : {true, false}) {
+    for (size_t i = 0; i < frames_.size(); i++) {
+      if (frames_[i].is_tracked_ && frames_[i].reference_ == referenced) {
+        frames.push_back(static_cast<frame_id_t>(i));
+      }
+    }
+  }
+  return frames;
+}
 
 }  // namespace bustub
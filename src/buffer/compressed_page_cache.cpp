@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.cpp
+//
+// Identification: src/buffer/compressed_page_cache.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include "common/util/compression_util.h"
+
+namespace bustub {
+
+CompressedPageCache::CompressedPageCache(size_t capacity, size_t page_size)
+    : capacity_(capacity), page_size_(page_size) {}
+
+auto CompressedPageCache::Reserve(page_id_t page_id) -> uint64_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (auto it = entries_.find(page_id); it != entries_.end()) {
+    EraseEntry(it->second);
+  }
+  const uint64_t ticket = ++next_ticket_;
+  reservations_[page_id] = ticket;
+  return ticket;
+}
+
+auto CompressedPageCache::Insert(page_id_t page_id, const char *data, uint64_t ticket) -> bool {
+  std::vector<char> compressed;
+  const size_t size = CompressionUtil::Compress(data, page_size_, &compressed);
+  const bool worth_it = size * 100 <= page_size_ * COMPRESSED_CACHE_MAX_PERCENT && size <= capacity_;
+  if (worth_it) {
+    compressed.shrink_to_fit();
+  }
+
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto reservation = reservations_.find(page_id);
+  if (reservation == reservations_.end() || reservation->second != ticket) {
+    // The page came back into the buffer pool, or was deleted, while it was being compressed.
+    return false;
+  }
+  reservations_.erase(reservation);
+  if (!worth_it) {
+    return false;
+  }
+  while (size_ + size > capacity_) {
+    EraseEntry(std::prev(lru_.end()));
+  }
+  lru_.push_front({page_id, std::move(compressed)});
+  entries_[page_id] = lru_.begin();
+  size_ += size;
+  return true;
+}
+
+auto CompressedPageCache::Take(page_id_t page_id, char *data) -> bool {
+  std::vector<char> compressed;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    reservations_.erase(page_id);
+    auto it = entries_.find(page_id);
+    if (it == entries_.end()) {
+      return false;
+    }
+    compressed = std::move(it->second->data_);
+    size_ -= compressed.size();
+    lru_.erase(it->second);
+    entries_.erase(it);
+  }
+  // A copy that does not decompress is only a lost hit, the page is still on disk.
+  if (!CompressionUtil::Decompress(compressed.data(), compressed.size(), data, page_size_)) {
+    return false;
+  }
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void CompressedPageCache::Erase(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  reservations_.erase(page_id);
+  if (auto it = entries_.find(page_id); it != entries_.end()) {
+    EraseEntry(it->second);
+  }
+}
+
+auto CompressedPageCache::GetSize() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return size_;
+}
+
+auto CompressedPageCache::GetNumPages() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return entries_.size();
+}
+
+void CompressedPageCache::EraseEntry(std::list<Entry>::iterator entry) {
+  size_ -= entry->data_.size();
+  entries_.erase(entry->page_id_);
+  lru_.erase(entry);
+}
+
+}  // namespace bustub
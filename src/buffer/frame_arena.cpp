@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <linux/mempolicy.h>
+#include <sanitizer/asan_interface.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+namespace {
+
+#if defined(__SANITIZE_ADDRESS__)
+constexpr size_t FRAME_GUARD_SIZE = BUSTUB_PAGE_SIZE;
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+constexpr size_t FRAME_GUARD_SIZE = BUSTUB_PAGE_SIZE;
+#else
+constexpr size_t FRAME_GUARD_SIZE = 0;
+#endif
+#else
+constexpr size_t FRAME_GUARD_SIZE = 0;
+#endif
+
+/** Size of the huge pages of the hugetlbfs pool, the mapping length must be a multiple of it. */
+constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+
+auto RoundUp(size_t size, size_t alignment) -> size_t { return (size + alignment - 1) / alignment * alignment; }
+
+/** @return the mask of the online NUMA nodes, as listed in sysfs (e.g. "0-3,6"), or just node 0 if it is unknown */
+auto OnlineNodeMask() -> unsigned long {  // NOLINT
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string list;
+  if (!(online >> list)) {
+    return 1;
+  }
+  unsigned long mask = 0;  // NOLINT
+  std::stringstream ranges(list);
+  std::string range;
+  while (std::getline(ranges, range, ',')) {
+    const auto dash = range.find('-');
+    const int first = std::stoi(range.substr(0, dash));
+    const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int node = first; node <= last && node < 64; node++) {
+      mask |= 1UL << node;
+    }
+  }
+  return mask == 0 ? 1 : mask;
+}
+
+}  // namespace
+
+FrameArena::FrameArena(size_t num_frames, size_t page_size, const FrameArenaOptions &options)
+    : num_frames_(num_frames),
+      page_size_(page_size),
+      stride_(page_size + FRAME_GUARD_SIZE),
+      size_(num_frames * stride_) {
+  BUSTUB_ASSERT(page_size_ % BUSTUB_PAGE_ALIGNMENT == 0, "frames must stay aligned in the arena");
+  if (size_ == 0) {
+    return;
+  }
+
+  void *memory = MAP_FAILED;
+  if (options.huge_pages_ == HugePageMode::Explicit) {
+    size_ = RoundUp(size_, HUGE_PAGE_SIZE);
+    memory = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (memory == MAP_FAILED) {
+      LOG_WARN("cannot map %zu bytes of huge pages, falling back to transparent huge pages", size_);
+    } else {
+      huge_tlb_ = true;
+    }
+  }
+  if (memory == MAP_FAILED) {
+    memory = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (memory == MAP_FAILED) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY,
+                      "cannot map " + std::to_string(size_) + " bytes of frames: " + strerror(errno));
+    }
+    if (options.huge_pages_ != HugePageMode::None && madvise(memory, size_, MADV_HUGEPAGE) != 0) {
+      LOG_DEBUG("madvise(MADV_HUGEPAGE) failed: %s", strerror(errno));
+    }
+  }
+  base_ = static_cast<char *>(memory);
+
+  if (options.numa_placement_ == NumaPlacement::Interleave) {
+    // The kernel reads one bit less than maxnode says.
+    const unsigned long node_mask = OnlineNodeMask();  // NOLINT
+    if (syscall(SYS_mbind, base_, size_, MPOL_INTERLEAVE, &node_mask, sizeof(node_mask) * 8 + 1, 0) != 0) {
+      LOG_WARN("cannot interleave frames over NUMA nodes: %s", strerror(errno));
+    }
+  }
+
+  for (size_t i = 0; FRAME_GUARD_SIZE > 0 && i < num_frames_; i++) {
+    ASAN_POISON_MEMORY_REGION(base_ + i * stride_ + page_size_, FRAME_GUARD_SIZE);
+  }
+}
+
+FrameArena::~FrameArena() {
+  if (base_ == nullptr) {
+    return;
+  }
+  ASAN_UNPOISON_MEMORY_REGION(base_, size_);
+  munmap(base_, size_);
+}
+
+}  // namespace bustub
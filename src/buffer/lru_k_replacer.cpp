@@ -15,16 +15,129 @@
 
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : replacer_size_(num_frames), k_(k), history_store_(num_frames * k) {
+  BUSTUB_ASSERT(k > 0, "k must be positive");
+  node_store_.reserve(num_frames);
+  for (size_t i = 0; i < num_frames; i++) {
+    node_store_.emplace_back(k_, static_cast<frame_id_t>(i), &history_store_[i * k_]);
+  }
+}
 
-auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool { return false; }
+auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (evictable_.empty()) {
+    return false;
+  }
+  *frame_id = std::get<2>(*evictable_.begin());
+  EraseNode(&node_store_[*frame_id]);
+  return true;
+}
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type) {}
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, [[maybe_unused]] page_id_t page_id) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  const bool is_prefetch = access_type == AccessType::Prefetch;
+  const bool is_scan = access_type == AccessType::Scan || is_prefetch;
+  auto &node = node_store_[frame_id];
+  if (node.HasHistory() && is_scan && !node.IsScanOnly()) {
+    // A scan passing over a page of the working set leaves its history alone.
+    return;
+  }
 
-void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {}
+  if (node.IsEvictable()) {
+    evictable_.erase(node.EvictionKey());
+  }
+  if (!node.HasHistory()) {
+    node.SetScanOnly(is_scan);
+    node.SetPrefetched(is_prefetch);
+  } else if (!is_scan && node.IsScanOnly()) {
+    // The frame joins the working set, the scans that read it before do not count towards its k accesses.
+    node.SetScanOnly(false);
+    node.SetPrefetched(false);
+    node.ClearHistory();
+  } else if (!is_prefetch) {
+    // The scan the page was read ahead for got to it.
+    node.SetPrefetched(false);
+  }
+  if (is_prefetch) {
+    prefetched_.emplace_back(current_timestamp_, frame_id);
+  }
+  node.RecordAccess(current_timestamp_++);
+  if (node.IsEvictable()) {
+    evictable_.insert(node.EvictionKey());
+  }
+  AgePrefetched();
+}
 
-void LRUKReplacer::Remove(frame_id_t frame_id) {}
+void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &node = node_store_[frame_id];
+  if (!node.HasHistory() || node.IsEvictable() == set_evictable) {
+    return;
+  }
+  node.SetEvictable(set_evictable);
+  if (set_evictable) {
+    evictable_.insert(node.EvictionKey());
+  } else {
+    evictable_.erase(node.EvictionKey());
+  }
+}
 
-auto LRUKReplacer::Size() -> size_t { return 0; }
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &node = node_store_[frame_id];
+  if (!node.HasHistory()) {
+    return;
+  }
+  BUSTUB_ENSURE(node.IsEvictable(), "cannot remove a non-evictable frame");
+  EraseNode(&node);
+}
+
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return evictable_.size();
+}
+
+auto LRUKReplacer::GetHotFrames() -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> frames;
+  for (const auto &node : node_store_) {
+    if (node.HasHistory() && !node.IsEvictable()) {
+      frames.push_back(node.GetFrameId());
+    }
+  }
+  for (auto it = evictable_.rbegin(); it != evictable_.rend(); ++it) {
+    frames.push_back(std::get<2>(*it));
+  }
+  return frames;
+}
+
+void LRUKReplacer::EraseNode(LRUKNode *node) {
+  evictable_.erase(node->EvictionKey());
+  node->SetEvictable(false);
+  node->SetScanOnly(false);
+  node->SetPrefetched(false);
+  node->ClearHistory();
+}
+
+void LRUKReplacer::AgePrefetched() {
+  while (!prefetched_.empty() && prefetched_.front().first + replacer_size_ < current_timestamp_) {
+    auto &node = node_store_[prefetched_.front().second];
+    // The entry is stale if the scan got to the frame, or if the frame was evicted and prefetched again since.
+    if (node.IsPrefetched() && node.LatestTimestamp() == prefetched_.front().first) {
+      if (node.IsEvictable()) {
+        evictable_.erase(node.EvictionKey());
+      }
+      node.SetPrefetched(false);
+      if (node.IsEvictable()) {
+        evictable_.insert(node.EvictionKey());
+      }
+    }
+    prefetched_.pop_front();
+  }
+}
 
 }  // namespace bustub
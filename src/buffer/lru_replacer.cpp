@@ -11,19 +11,84 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/lru_replacer.h"
+#include "common/exception.h"
 
 namespace bustub {
 
-LRUReplacer::LRUReplacer(size_t num_pages) {}
+LRUReplacer::LRUReplacer(size_t num_pages) : frames_(num_pages) {}
 
 LRUReplacer::~LRUReplacer() = default;
 
-auto LRUReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto LRUReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+  for (auto it = lru_list_.begin(); it != lru_list_.end(); ++it) {
+    auto &frame = frames_[*it];
+    if (frame.is_evictable_) {
+      *frame_id = *it;
+      lru_list_.erase(it);
+      frame = Frame{};
+      curr_size_--;
+      return true;
+    }
+  }
+  UNREACHABLE("an evictable frame must be in the lru list");
+}
 
-void LRUReplacer::Pin(frame_id_t frame_id) {}
+void LRUReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, [[maybe_unused]] page_id_t page_id) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &frame = frames_[frame_id];
+  const bool is_scan = access_type == AccessType::Scan || access_type == AccessType::Prefetch;
+  if (!frame.is_tracked_) {
+    frame.is_tracked_ = true;
+    const bool to_front = access_type == AccessType::Scan;
+    frame.pos_ = lru_list_.insert(to_front ? lru_list_.begin() : lru_list_.end(), frame_id);
+    return;
+  }
+  if (!is_scan) {
+    lru_list_.splice(lru_list_.end(), lru_list_, frame.pos_);
+  }
+}
 
-void LRUReplacer::Unpin(frame_id_t frame_id) {}
+void LRUReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (!frame.is_tracked_ || frame.is_evictable_ == set_evictable) {
+    return;
+  }
+  frame.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
 
-auto LRUReplacer::Size() -> size_t { return 0; }
+void LRUReplacer::Remove(frame_id_t frame_id) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (!frame.is_tracked_) {
+    return;
+  }
+  BUSTUB_ENSURE(frame.is_evictable_, "cannot remove a non-evictable frame");
+  lru_list_.erase(frame.pos_);
+  frame = Frame{};
+  curr_size_--;
+}
+
+auto LRUReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+auto LRUReplacer::GetHotFrames() -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return {lru_list_.rbegin(), lru_list_.rend()};
+}
 
 }  // namespace bustub
@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/buffer/page_table.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+#include <vector>
+
+namespace bustub {
+
+PageTable::PageTable(size_t num_frames) {
+  // At most half full, so that probe sequences stay short.
+  capacity_ = 16;
+  while (capacity_ < 2 * num_frames) {
+    capacity_ *= 2;
+  }
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity_);
+  for (size_t i = 0; i < capacity_; i++) {
+    slots_[i].store(EMPTY, std::memory_order_relaxed);
+  }
+}
+
+auto PageTable::HomeSlot(page_id_t page_id) const -> size_t {
+  // Page ids are mostly consecutive, Fibonacci hashing spreads them over the table.
+  return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >> 32) &
+         (capacity_ - 1);
+}
+
+auto PageTable::FindSlot(page_id_t page_id) const -> size_t {
+  size_t slot = HomeSlot(page_id);
+  for (size_t i = 0; i < capacity_; i++, slot = (slot + 1) & (capacity_ - 1)) {
+    const uint64_t entry = slots_[slot].load(std::memory_order_acquire);
+    if (entry == EMPTY) {
+      break;
+    }
+    if (entry != TOMBSTONE && PageOf(entry) == page_id) {
+      return slot;
+    }
+  }
+  return capacity_;
+}
+
+auto PageTable::Find(page_id_t page_id, frame_id_t *frame_id) const -> bool {
+  const size_t slot = FindSlot(page_id);
+  if (slot == capacity_) {
+    return false;
+  }
+  *frame_id = static_cast<frame_id_t>(ValueOf(slots_[slot].load(std::memory_order_relaxed)) & ~READY_BIT);
+  return true;
+}
+
+auto PageTable::FindReady(page_id_t page_id, frame_id_t *frame_id) const -> bool {
+  size_t slot = HomeSlot(page_id);
+  for (size_t i = 0; i < capacity_; i++, slot = (slot + 1) & (capacity_ - 1)) {
+    const uint64_t entry = slots_[slot].load(std::memory_order_acquire);
+    if (entry == EMPTY) {
+      return false;
+    }
+    if (entry != TOMBSTONE && PageOf(entry) == page_id) {
+      if ((ValueOf(entry) & READY_BIT) == 0) {
+        return false;
+      }
+      *frame_id = static_cast<frame_id_t>(ValueOf(entry) & ~READY_BIT);
+      return true;
+    }
+  }
+  return false;
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  BUSTUB_ASSERT(page_id >= 0 && frame_id >= 0, "invalid page table entry");
+  const uint64_t entry = Pack(page_id, static_cast<uint32_t>(frame_id));
+  size_t free_slot = capacity_;
+  size_t slot = HomeSlot(page_id);
+  for (size_t i = 0; i < capacity_; i++, slot = (slot + 1) & (capacity_ - 1)) {
+    const uint64_t current = slots_[slot].load(std::memory_order_relaxed);
+    if (current == EMPTY) {
+      if (free_slot == capacity_) {
+        free_slot = slot;
+      }
+      break;
+    }
+    if (current == TOMBSTONE) {
+      if (free_slot == capacity_) {
+        free_slot = slot;
+      }
+      continue;
+    }
+    if (PageOf(current) == page_id) {
+      slots_[slot].store(entry, std::memory_order_release);
+      return;
+    }
+  }
+  BUSTUB_ASSERT(free_slot != capacity_, "page table is full");
+  if (slots_[free_slot].load(std::memory_order_relaxed) == TOMBSTONE) {
+    tombstones_--;
+  }
+  slots_[free_slot].store(entry, std::memory_order_release);
+  size_++;
+}
+
+void PageTable::SetReady(page_id_t page_id) {
+  const size_t slot = FindSlot(page_id);
+  BUSTUB_ASSERT(slot != capacity_, "page is not in the page table");
+  const uint64_t entry = slots_[slot].load(std::memory_order_relaxed);
+  slots_[slot].store(entry | READY_BIT, std::memory_order_release);
+}
+
+void PageTable::Erase(page_id_t page_id) {
+  const size_t slot = FindSlot(page_id);
+  if (slot == capacity_) {
+    return;
+  }
+  slots_[slot].store(TOMBSTONE, std::memory_order_release);
+  size_--;
+  tombstones_++;
+  if (size_ + tombstones_ > capacity_ / 4 * 3) {
+    Rehash();
+  }
+}
+
+void PageTable::Rehash() {
+  std::vector<uint64_t> entries;
+  entries.reserve(size_);
+  for (size_t i = 0; i < capacity_; i++) {
+    const uint64_t entry = slots_[i].load(std::memory_order_relaxed);
+    if (entry != EMPTY && entry != TOMBSTONE) {
+      entries.push_back(entry);
+    }
+    slots_[i].store(EMPTY, std::memory_order_release);
+  }
+  tombstones_ = 0;
+  for (auto entry : entries) {
+    size_t slot = HomeSlot(PageOf(entry));
+    while (slots_[slot].load(std::memory_order_relaxed) != EMPTY) {
+      slot = (slot + 1) & (capacity_ - 1);
+    }
+    slots_[slot].store(entry, std::memory_order_release);
+  }
+}
+
+}  // namespace bustub
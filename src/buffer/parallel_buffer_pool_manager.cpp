@@ -0,0 +1,215 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <exception>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, ReplacerType replacer_type,
+                                                     const FrameArenaOptions &arena_options)
+    : BufferPoolManager(num_instances * pool_size, disk_manager->GetPageSize(), disk_manager->GetUsablePageSize()) {
+  BUSTUB_ASSERT(num_instances > 0, "a parallel buffer pool needs at least one instance");
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManager>(pool_size, static_cast<uint32_t>(num_instances),
+                                                                static_cast<uint32_t>(i), disk_manager, replacer_k,
+                                                                log_manager, replacer_type, arena_options));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  // The warm-up thread calls into the instances.
+  StopWarmUp();
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManager * {
+  return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
+}
+
+auto ParallelBufferPoolManager::NewPageNear(page_id_t *page_id, page_id_t hint) -> Page * {
+  const size_t start = hint == INVALID_PAGE_ID ? next_instance_.fetch_add(1) % instances_.size()
+                                               : static_cast<size_t>(hint + 1) % instances_.size();
+  for (size_t i = 0; i < instances_.size(); i++) {
+    Page *page = instances_[(start + i) % instances_.size()]->NewPageNear(page_id, hint);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::NewPageInSegment(page_id_t *page_id, segment_id_t segment) -> Page * {
+  const size_t start = next_instance_.fetch_add(1) % instances_.size();
+  for (size_t i = 0; i < instances_.size(); i++) {
+    Page *page = instances_[(start + i) % instances_.size()]->NewPageInSegment(page_id, segment);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id, access_type);
+}
+
+auto ParallelBufferPoolManager::FetchPageOptimistic(page_id_t page_id, AccessType access_type)
+    -> OptimisticPageGuard {
+  return GetBufferPoolManager(page_id)->FetchPageOptimistic(page_id, access_type);
+}
+
+auto ParallelBufferPoolManager::FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type)
+    -> std::vector<Page *> {
+  std::vector<std::vector<page_id_t>> instance_page_ids(instances_.size());
+  std::vector<std::vector<size_t>> positions(instances_.size());
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    const size_t instance = static_cast<size_t>(page_ids[i]) % instances_.size();
+    instance_page_ids[instance].push_back(page_ids[i]);
+    positions[instance].push_back(i);
+  }
+  // The reads of every instance are in flight before waiting for any of them.
+  std::vector<BufferPoolManager::FetchBatch> batches(instances_.size());
+  for (size_t instance = 0; instance < instances_.size(); instance++) {
+    if (!instance_page_ids[instance].empty()) {
+      batches[instance] = instances_[instance]->StartFetchPages(instance_page_ids[instance], access_type);
+    }
+  }
+  std::vector<Page *> pages(page_ids.size(), nullptr);
+  std::vector<size_t> fetched_instances;
+  std::exception_ptr error;
+  for (size_t instance = 0; instance < instances_.size(); instance++) {
+    if (instance_page_ids[instance].empty()) {
+      continue;
+    }
+    // Every batch is finished, so that none is left with reads nobody settles.
+    std::vector<Page *> instance_pages;
+    try {
+      instance_pages = instances_[instance]->FinishFetchPages(&batches[instance]);
+    } catch (...) {
+      error = std::current_exception();
+      continue;
+    }
+    for (size_t i = 0; i < instance_pages.size(); i++) {
+      pages[positions[instance][i]] = instance_pages[i];
+    }
+    fetched_instances.push_back(instance);
+  }
+  if (error == nullptr) {
+    return pages;
+  }
+  // The failed instance released its own pins, the caller gets nothing but the exception so the others go back too.
+  for (auto instance : fetched_instances) {
+    for (auto position : positions[instance]) {
+      if (pages[position] != nullptr) {
+        instances_[instance]->UnpinPage(page_ids[position], false);
+      }
+    }
+  }
+  std::rethrow_exception(error);
+}
+
+auto ParallelBufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type) -> bool {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty, access_type);
+}
+
+auto ParallelBufferPoolManager::FlushPage(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPages() {
+  for (auto &instance : instances_) {
+    instance->FlushAllPages();
+  }
+  SaveHotSetFile();
+}
+
+auto ParallelBufferPoolManager::Vacuum() -> size_t {
+  // The instances share the disk manager, every one of them is flushed before the first one shrinks the file.
+  FlushAllPages();
+  return instances_.front()->Vacuum();
+}
+
+auto ParallelBufferPoolManager::DeletePage(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+auto ParallelBufferPoolManager::Prefetch(page_id_t page_id, bool evict) -> bool {
+  return GetBufferPoolManager(page_id)->Prefetch(page_id, evict);
+}
+
+auto ParallelBufferPoolManager::GetHitCount(AccessType access_type) -> uint64_t {
+  uint64_t count = 0;
+  for (auto &instance : instances_) {
+    count += instance->GetHitCount(access_type);
+  }
+  return count;
+}
+
+auto ParallelBufferPoolManager::GetMissCount(AccessType access_type) -> uint64_t {
+  uint64_t count = 0;
+  for (auto &instance : instances_) {
+    count += instance->GetMissCount(access_type);
+  }
+  return count;
+}
+
+auto ParallelBufferPoolManager::GetStats() -> BufferPoolStats {
+  BufferPoolStats stats;
+  for (auto &instance : instances_) {
+    stats += instance->GetStats();
+  }
+  return stats;
+}
+
+void ParallelBufferPoolManager::SetCompressedCacheSize(size_t capacity) {
+  for (auto &instance : instances_) {
+    instance->SetCompressedCacheSize(capacity / instances_.size());
+  }
+}
+
+void ParallelBufferPoolManager::StartFlusher(size_t target_clean_percent) {
+  for (auto &instance : instances_) {
+    instance->StartFlusher(target_clean_percent);
+  }
+}
+
+void ParallelBufferPoolManager::StopFlusher() {
+  for (auto &instance : instances_) {
+    instance->StopFlusher();
+  }
+}
+
+auto ParallelBufferPoolManager::GetHotPages() -> std::vector<page_id_t> {
+  std::vector<std::vector<page_id_t>> instance_pages;
+  instance_pages.reserve(instances_.size());
+  for (auto &instance : instances_) {
+    instance_pages.emplace_back(instance->GetHotPages());
+  }
+  std::vector<page_id_t> pages;
+  for (size_t rank = 0, old_size = 1; pages.size() != old_size; rank++) {
+    old_size = pages.size();
+    for (auto &hot : instance_pages) {
+      if (rank < hot.size()) {
+        pages.push_back(hot[rank]);
+      }
+    }
+  }
+  return pages;
+}
+
+}  // namespace bustub
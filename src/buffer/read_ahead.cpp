@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.cpp
+//
+// Identification: src/buffer/read_ahead.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/read_ahead.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+ReadAhead::ReadAhead(BufferPoolManager *bpm, size_t window)
+    : bpm_(bpm), window_(bpm == nullptr ? 0 : std::min(window, bpm->GetPoolSize() / 4)) {}
+
+void ReadAhead::OnPageChange(page_id_t page_id) {
+  if (page_id == current_page_id_) {
+    return;
+  }
+  if (current_page_id_ != INVALID_PAGE_ID && page_id == current_page_id_ + 1) {
+    sequential_moves_++;
+  } else {
+    sequential_moves_ = 0;
+    prefetched_until_ = INVALID_PAGE_ID;
+  }
+  current_page_id_ = page_id;
+  if (page_id == INVALID_PAGE_ID || window_ == 0 || sequential_moves_ < SEQUENTIAL_THRESHOLD) {
+    return;
+  }
+
+  // Top the window up. Once it is full, every page the scan moves on issues a single prefetch.
+  const page_id_t first = std::max(page_id + 1, prefetched_until_);
+  const page_id_t end = page_id + 1 + static_cast<page_id_t>(window_);
+  if (first < end) {
+    bpm_->PrefetchRange(first, static_cast<size_t>(end - first));
+    prefetched_until_ = end;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_factory.cpp
+//
+// Identification: src/buffer/replacer_factory.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/replacer_factory.h"
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "common/exception.h"
+
+namespace bustub {
+
+auto ReplacerFactory::CreateReplacer(ReplacerType type, size_t num_frames, size_t k) -> std::unique_ptr<Replacer> {
+  switch (type) {
+    case ReplacerType::LRUK:
+      return std::make_unique<LRUKReplacer>(num_frames, k);
+    case ReplacerType::LRU:
+      return std::make_unique<LRUReplacer>(num_frames);
+    case ReplacerType::Clock:
+      return std::make_unique<ClockReplacer>(num_frames);
+    case ReplacerType::TwoQ:
+      return std::make_unique<TwoQueueReplacer>(num_frames);
+    case ReplacerType::ARC:
+      return std::make_unique<ARCReplacer>(num_frames);
+  }
+  throw Exception(ExceptionType::INVALID, "unknown replacer type");
+}
+
+auto ReplacerFactory::ParseReplacerType(const std::string &name) -> std::optional<ReplacerType> {
+  if (name == "lruk") {
+    return ReplacerType::LRUK;
+  }
+  if (name == "lru") {
+    return ReplacerType::LRU;
+  }
+  if (name == "clock") {
+    return ReplacerType::Clock;
+  }
+  if (name == "2q") {
+    return ReplacerType::TwoQ;
+  }
+  if (name == "arc") {
+    return ReplacerType::ARC;
+  }
+  return std::nullopt;
+}
+
+}  // namespace bustub
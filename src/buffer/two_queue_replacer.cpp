@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.cpp
+//
+// Identification: src/buffer/two_queue_replacer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+// The paper recommends Kin = 25% and Kout = 50% of the buffer pool.
+TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+    : frames_(num_frames), kin_(std::max<size_t>(num_frames / 4, 1)), kout_(std::max<size_t>(num_frames / 2, 1)) {}
+
+auto TwoQueueReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+  std::optional<frame_id_t> victim;
+  if (a1in_.size() > kin_) {
+    victim = FindVictim(a1in_);
+  }
+  if (!victim.has_value()) {
+    victim = FindVictim(am_);
+  }
+  if (!victim.has_value()) {
+    victim = FindVictim(a1in_);
+  }
+  BUSTUB_ASSERT(victim.has_value(), "an evictable frame must be in one of the queues");
+
+  auto &frame = frames_[*victim];
+  if (frame.queue_ == Queue::A1In && frame.page_id_ != INVALID_PAGE_ID) {
+    AddGhost(frame.page_id_);
+  }
+  EraseFrame(*victim);
+  *frame_id = *victim;
+  return true;
+}
+
+void TwoQueueReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, page_id_t page_id) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &frame = frames_[frame_id];
+  const bool is_scan = access_type == AccessType::Scan || access_type == AccessType::Prefetch;
+  if (frame.queue_ == Queue::Am) {
+    if (!is_scan) {
+      am_.splice(am_.end(), am_, frame.pos_);
+    }
+    return;
+  }
+  if (frame.queue_ == Queue::A1In) {
+    // Correlated references while the page is in A1in do not count as a second reference.
+    return;
+  }
+
+  frame.page_id_ = page_id;
+  auto ghost = a1out_index_.find(page_id);
+  if (ghost != a1out_index_.end()) {
+    a1out_.erase(ghost->second);
+    a1out_index_.erase(ghost);
+    if (!is_scan) {
+      frame.queue_ = Queue::Am;
+      frame.pos_ = am_.insert(am_.end(), frame_id);
+      return;
+    }
+  }
+  frame.queue_ = Queue::A1In;
+  frame.pos_ = a1in_.insert(a1in_.end(), frame_id);
+}
+
+void TwoQueueReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &frame = frames_[frame_id];
+  if (frame.queue_ == Queue::None || frame.is_evictable_ == set_evictable) {
+    return;
+  }
+  frame.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  CheckFrameId(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (frames_[frame_id].queue_ == Queue::None) {
+    return;
+  }
+  BUSTUB_ENSURE(frames_[frame_id].is_evictable_, "cannot remove a non-evictable frame");
+  EraseFrame(frame_id);
+}
+
+auto TwoQueueReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+auto TwoQueueReplacer::GetHotFrames() -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> frames(am_.rbegin(), am_.rend());
+  frames.insert(frames.end(), a1in_.rbegin(), a1in_.rend());
+  return frames;
+}
+
+auto TwoQueueReplacer::FindVictim(const std::list<frame_id_t> &queue) const -> std::optional<frame_id_t> {
+  for (auto frame_id : queue) {
+    if (frames_[frame_id].is_evictable_) {
+      return frame_id;
+    }
+  }
+  return std::nullopt;
+}
+
+void TwoQueueReplacer::EraseFrame(frame_id_t frame_id) {
+  auto &frame = frames_[frame_id];
+  (frame.queue_ == Queue::A1In ? a1in_ : am_).erase(frame.pos_);
+  if (frame.is_evictable_) {
+    curr_size_--;
+  }
+  frame = Frame{};
+}
+
+void TwoQueueReplacer::AddGhost(page_id_t page_id) {
+  a1out_index_[page_id] = a1out_.insert(a1out_.end(), page_id);
+  if (a1out_.size() > kout_) {
+    a1out_index_.erase(a1out_.front());
+    a1out_.pop_front();
+  }
+}
+
+}  // namespace bustub
@@ -14,6 +14,7 @@
 #include "binder/statement/index_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
+#include "binder/statement/vacuum_statement.h"
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
@@ -127,6 +128,10 @@ void BustubInstance::HandleExplainStatement(Transaction *txn, const ExplainState
 
 void BustubInstance::HandleVariableShowStatement(Transaction *txn, const VariableShowStatement &stmt,
                                                  ResultWriter &writer) {
+  if (StringUtil::Lower(stmt.variable_) == "bpm_stats") {
+    CmdDisplayBufferPoolStats(writer);
+    return;
+  }
   auto content = GetSessionVariable(stmt.variable_);
   WriteOneCell(fmt::format("{}={}", stmt.variable_, content), writer);
 }
@@ -136,4 +141,19 @@ void BustubInstance::HandleVariableSetStatement(Transaction *txn, const Variable
   session_variables_[stmt.variable_] = stmt.value_;
 }
 
+void BustubInstance::HandleVacuumStatement(Transaction *txn, const VacuumStatement &stmt, ResultWriter &writer) {
+  if (buffer_pool_manager_ == nullptr) {
+    throw Exception("the buffer pool is not available");
+  }
+  // Both flush the pool, which saves the free-space map. Only FULL gives the free tail of the file back.
+  size_t truncated_pages = 0;
+  if (stmt.full_) {
+    truncated_pages = buffer_pool_manager_->Vacuum();
+  } else {
+    buffer_pool_manager_->FlushAllPages();
+  }
+  WriteOneCell(fmt::format("truncated_pages={} free_pages={}", truncated_pages, disk_manager_->GetFreePages().size()),
+               writer);
+}
+
 }  // namespace bustub
@@ -1,7 +1,10 @@
+#include <array>
 #include <optional>
 #include <shared_mutex>
 #include <string>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
@@ -11,6 +14,7 @@
 #include "binder/statement/index_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
+#include "binder/statement/vacuum_statement.h"
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
@@ -34,6 +38,8 @@
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/disk/disk_manager_uring.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -42,23 +48,42 @@ auto BustubInstance::MakeExecutorContext(Transaction *txn, bool is_modify) -> st
   return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_, is_modify);
 }
 
-BustubInstance::BustubInstance(const std::string &db_file_name) {
+BustubInstance::BustubInstance(const std::string &db_file_name, DiskIOBackend disk_io_backend)
+    : BustubInstance(db_file_name, BustubOptions{disk_io_backend}) {}
+
+BustubInstance::BustubInstance(const std::string &db_file_name, const BustubOptions &options) {
   enable_logging = false;
 
   // Storage related.
-  disk_manager_ = new DiskManager(db_file_name);
+  switch (options.disk_io_backend_) {
+    case DiskIOBackend::FStream:
+      disk_manager_ = new DiskManager(db_file_name, options.page_size_, options.db_file_options_);
+      break;
+    case DiskIOBackend::Pread:
+      disk_manager_ = new DiskManagerPosix(db_file_name, false, options.page_size_, options.db_file_options_);
+      break;
+    case DiskIOBackend::PreadDirect:
+      disk_manager_ = new DiskManagerPosix(db_file_name, true, options.page_size_, options.db_file_options_);
+      break;
+    case DiskIOBackend::Uring:
+      disk_manager_ = new DiskManagerUring(db_file_name, false, URING_QUEUE_DEPTH, options.page_size_,
+                                           options.db_file_options_);
+      break;
+  }
 
   // Log related.
-  log_manager_ = new LogManager(disk_manager_);
+  log_manager_ = new LogManager(disk_manager_, options.log_buffer_size_);
 
-  // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
-  // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ =
+        new BufferPoolManager(options.buffer_pool_size_, disk_manager_, LRUK_REPLACER_K, log_manager_);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
   }
+  if (buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->SetCompressedCacheSize(options.compressed_cache_size_);
+  }
 
   // Transaction (txn) related.
 
@@ -68,8 +93,20 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
 
   lock_manager_->txn_manager_ = txn_manager_;
 
+  // Buffer pool warm-up: the hot set is kept next to the database file, like the log.
+  if (buffer_pool_manager_ != nullptr) {
+    hot_set_file_ = db_file_name.substr(0, db_file_name.rfind('.')) + ".hot";
+    buffer_pool_manager_->SetHotSetFile(hot_set_file_);
+  }
+
 #ifndef __EMSCRIPTEN__
   lock_manager_->StartDeadlockDetection();
+  if (buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->StartFlusher();
+    if (options.warm_up_) {
+      buffer_pool_manager_->StartWarmUp(hot_set_file_, options.warm_up_pages_per_second_);
+    }
+  }
 #endif
 
   // Checkpoint related.
@@ -82,23 +119,27 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
 
-BustubInstance::BustubInstance() {
+BustubInstance::BustubInstance() : BustubInstance(BustubOptions{}) {}
+
+BustubInstance::BustubInstance(const BustubOptions &options) {
   enable_logging = false;
 
   // Storage related.
-  disk_manager_ = new DiskManagerUnlimitedMemory();
+  disk_manager_ = new DiskManagerUnlimitedMemory(options.page_size_);
 
   // Log related.
-  log_manager_ = new LogManager(disk_manager_);
+  log_manager_ = new LogManager(disk_manager_, options.log_buffer_size_);
 
-  // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
-  // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ =
+        new BufferPoolManager(options.buffer_pool_size_, disk_manager_, LRUK_REPLACER_K, log_manager_);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
   }
+  if (buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->SetCompressedCacheSize(options.compressed_cache_size_);
+  }
 
   // Transaction (txn) related.
 
@@ -110,6 +151,9 @@ BustubInstance::BustubInstance() {
 
 #ifndef __EMSCRIPTEN__
   lock_manager_->StartDeadlockDetection();
+  if (buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->StartFlusher();
+  }
 #endif
 
   // Checkpoint related.
@@ -163,6 +207,54 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
   writer.EndTable();
 }
 
+void BustubInstance::CmdDisplayBufferPoolStats(ResultWriter &writer) {
+  if (buffer_pool_manager_ == nullptr) {
+    WriteOneCell("the buffer pool is not available", writer);
+    return;
+  }
+  std::vector<std::pair<std::string, std::string>> rows;
+  auto add_histogram = [&rows](const std::string &name, const LatencyHistogram::Snapshot &histogram) {
+    rows.emplace_back(name + ".count", fmt::format("{}", histogram.count_));
+    rows.emplace_back(name + ".mean_us", fmt::format("{:.1f}", histogram.MeanMicros()));
+    rows.emplace_back(name + ".p50_us", fmt::format("{}", histogram.PercentileMicros(50)));
+    rows.emplace_back(name + ".p99_us", fmt::format("{}", histogram.PercentileMicros(99)));
+  };
+
+  const auto stats = buffer_pool_manager_->GetStats();
+  rows.emplace_back("pool_size", fmt::format("{}", buffer_pool_manager_->GetPoolSize()));
+  rows.emplace_back("page_size", fmt::format("{}", buffer_pool_manager_->GetPageSize()));
+  rows.emplace_back("hit_ratio", fmt::format("{:.4f}", stats.GetHitRatio()));
+  const std::array<const char *, NUM_ACCESS_TYPES> access_types{"unknown", "get", "scan", "prefetch"};
+  for (size_t i = 0; i < NUM_ACCESS_TYPES; i++) {
+    rows.emplace_back(fmt::format("hits.{}", access_types[i]), fmt::format("{}", stats.hits_[i]));
+    rows.emplace_back(fmt::format("misses.{}", access_types[i]), fmt::format("{}", stats.misses_[i]));
+  }
+  rows.emplace_back("evictions", fmt::format("{}", stats.evictions_));
+  rows.emplace_back("write_backs", fmt::format("{}", stats.write_backs_));
+  rows.emplace_back("flusher_writes", fmt::format("{}", stats.flusher_writes_));
+  add_histogram("pin_wait", stats.pin_wait_);
+  rows.emplace_back("compressed_cache.hits", fmt::format("{}", stats.compressed_hits_));
+  rows.emplace_back("compressed_cache.pages", fmt::format("{}", stats.compressed_pages_));
+  rows.emplace_back("compressed_cache.bytes", fmt::format("{}", stats.compressed_bytes_));
+  add_histogram("disk_read", disk_manager_->GetReadLatency());
+  add_histogram("disk_write", disk_manager_->GetWriteLatency());
+  rows.emplace_back("log_flushes", fmt::format("{}", disk_manager_->GetNumFlushes()));
+  rows.emplace_back("free_pages", fmt::format("{}", disk_manager_->GetFreePages().size()));
+
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("name");
+  writer.WriteHeaderCell("value");
+  writer.EndHeader();
+  for (const auto &[name, value] : rows) {
+    writer.BeginRow();
+    writer.WriteCell(name);
+    writer.WriteCell(value);
+    writer.EndRow();
+  }
+  writer.EndTable();
+}
+
 void BustubInstance::WriteOneCell(const std::string &cell, ResultWriter &writer) {
   writer.BeginTable(true);
   writer.BeginRow();
@@ -176,6 +268,8 @@ void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
 
 \dt: show all tables
 \di: show all indices
+\bpm: show the buffer pool and disk I/O statistics, also `SHOW bpm_stats`
+`VACUUM FULL`: give the free pages at the end of the database file back to the OS
 \help: show this message again
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
@@ -216,6 +310,10 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       CmdDisplayIndices(writer);
       return true;
     }
+    if (sql == "\\bpm") {
+      CmdDisplayBufferPoolStats(writer);
+      return true;
+    }
     if (sql == "\\help") {
       CmdDisplayHelp(writer);
       return true;
@@ -256,6 +354,11 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         HandleVariableSetStatement(txn, set_stmt, writer);
         continue;
       }
+      case StatementType::VACUUM_STATEMENT: {
+        const auto &vacuum_stmt = dynamic_cast<const VacuumStatement &>(*statement);
+        HandleVacuumStatement(txn, vacuum_stmt, writer);
+        continue;
+      }
       case StatementType::EXPLAIN_STATEMENT: {
         const auto &explain_stmt = dynamic_cast<const ExplainStatement &>(*statement);
         HandleExplainStatement(txn, explain_stmt, writer);
@@ -351,6 +454,15 @@ void BustubInstance::GenerateMockTable() {
 }
 
 BustubInstance::~BustubInstance() {
+  // The flusher reads the log manager, stop it before anything goes away.
+  if (buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->StopWarmUp();
+    buffer_pool_manager_->StopFlusher();
+    // Only the page ids: dirty pages are left to the flusher and recovery, as before.
+    if (!hot_set_file_.empty()) {
+      buffer_pool_manager_->SaveHotSet(hot_set_file_);
+    }
+  }
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// metrics.cpp
+//
+// Identification: src/common/metrics.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/metrics.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+auto ThreadStripe() -> size_t {
+  static std::atomic<size_t> next_stripe{0};
+  static thread_local const size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % METRIC_STRIPES;
+  return stripe;
+}
+
+auto StripedCounter::Get() const -> uint64_t {
+  uint64_t value = 0;
+  for (const auto &stripe : stripes_) {
+    value += stripe.value_.load(std::memory_order_relaxed);
+  }
+  return value;
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency) {
+  const auto nanos = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+  // The bucket of a latency is the number of bits of its value in microseconds.
+  size_t bucket = 0;
+  for (uint64_t micros = nanos / 1000; micros != 0 && bucket < NUM_BUCKETS - 1; micros >>= 1) {
+    bucket++;
+  }
+  auto &stripe = stripes_[ThreadStripe()];
+  stripe.buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  stripe.total_ns_.fetch_add(nanos, std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::GetSnapshot() const -> Snapshot {
+  Snapshot snapshot;
+  for (const auto &stripe : stripes_) {
+    for (size_t i = 0; i < NUM_BUCKETS; i++) {
+      const uint64_t count = stripe.buckets_[i].load(std::memory_order_relaxed);
+      snapshot.buckets_[i] += count;
+      snapshot.count_ += count;
+    }
+    snapshot.total_ns_ += stripe.total_ns_.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+auto LatencyHistogram::Snapshot::operator+=(const Snapshot &other) -> Snapshot & {
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  total_ns_ += other.total_ns_;
+  return *this;
+}
+
+auto LatencyHistogram::Snapshot::MeanMicros() const -> double {
+  return count_ == 0 ? 0 : static_cast<double>(total_ns_) / 1000 / static_cast<double>(count_);
+}
+
+auto LatencyHistogram::Snapshot::PercentileMicros(double percentile) const -> uint64_t {
+  if (count_ == 0) {
+    return 0;
+  }
+  // The rank of the percentile, counting from 1.
+  const auto rank = std::max<uint64_t>(static_cast<uint64_t>(percentile / 100 * static_cast<double>(count_) + 0.5), 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return uint64_t{1} << i;
+    }
+  }
+  return uint64_t{1} << (NUM_BUCKETS - 1);
+}
+
+}  // namespace bustub
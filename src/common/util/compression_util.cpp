@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.cpp
+//
+// Identification: src/common/util/compression_util.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/compression_util.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+/** Shortest match worth encoding, a match costs at least 3 bytes. */
+constexpr size_t MIN_MATCH = 4;
+/** Farthest match the 2-byte distance can reach. */
+constexpr size_t MAX_DISTANCE = 65535;
+/** log2 of the number of slots of the match finder, which remembers the last position of every 4-byte hash. */
+constexpr size_t HASH_BITS = 12;
+/** A nibble of 15 says that length bytes follow. */
+constexpr size_t NIBBLE_MAX = 15;
+constexpr uint8_t LENGTH_BYTE_MAX = 255;
+
+auto Hash4(const char *data) -> uint32_t {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return (value * 2654435761U) >> (32 - HASH_BITS);
+}
+
+void WriteLength(size_t length, std::vector<char> *out) {
+  for (; length >= LENGTH_BYTE_MAX; length -= LENGTH_BYTE_MAX) {
+    out->push_back(static_cast<char>(LENGTH_BYTE_MAX));
+  }
+  out->push_back(static_cast<char>(length));
+}
+
+/** Append a pair of literals and match, or only literals if match_length is 0. */
+void WriteSequence(const char *literals, size_t num_literals, size_t distance, size_t match_length,
+                   std::vector<char> *out) {
+  const size_t match_nibble = match_length == 0 ? 0 : match_length - MIN_MATCH;
+  out->push_back(static_cast<char>((std::min(num_literals, NIBBLE_MAX) << 4) | std::min(match_nibble, NIBBLE_MAX)));
+  if (num_literals >= NIBBLE_MAX) {
+    WriteLength(num_literals - NIBBLE_MAX, out);
+  }
+  out->insert(out->end(), literals, literals + num_literals);
+  if (match_length == 0) {
+    return;
+  }
+  out->push_back(static_cast<char>(distance & 0xff));
+  out->push_back(static_cast<char>(distance >> 8));
+  if (match_nibble >= NIBBLE_MAX) {
+    WriteLength(match_nibble - NIBBLE_MAX, out);
+  }
+}
+
+/** Read the continuation of a length whose nibble was 15. @return false if the block ends first */
+auto ReadLength(const uint8_t **in, const uint8_t *end, size_t *length) -> bool {
+  uint8_t byte;
+  do {
+    if (*in == end) {
+      return false;
+    }
+    byte = *(*in)++;
+    *length += byte;
+  } while (byte == LENGTH_BYTE_MAX);
+  return true;
+}
+
+}  // namespace
+
+auto CompressionUtil::Compress(const char *src, size_t size, std::vector<char> *out) -> size_t {
+  out->clear();
+  out->reserve(size + size / LENGTH_BYTE_MAX + 16);
+  // Positions are stored plus one, so that 0 means an empty slot.
+  std::array<uint32_t, 1 << HASH_BITS> last_seen{};
+  size_t anchor = 0;
+  size_t pos = 0;
+  while (pos + MIN_MATCH <= size) {
+    auto &slot = last_seen[Hash4(src + pos)];
+    const size_t candidate = slot;
+    slot = static_cast<uint32_t>(pos + 1);
+    const size_t match = candidate - 1;
+    if (candidate == 0 || pos - match > MAX_DISTANCE || memcmp(src + match, src + pos, MIN_MATCH) != 0) {
+      pos++;
+      continue;
+    }
+    // A match may overlap the bytes it produces, which is how a run of zeros becomes a single pair.
+    size_t length = MIN_MATCH;
+    while (pos + length < size && src[match + length] == src[pos + length]) {
+      length++;
+    }
+    WriteSequence(src + anchor, pos - anchor, pos - match, length, out);
+    pos += length;
+    anchor = pos;
+  }
+  WriteSequence(src + anchor, size - anchor, 0, 0, out);
+  return out->size();
+}
+
+auto CompressionUtil::Decompress(const char *src, size_t src_size, char *dst, size_t dst_size) -> bool {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  const auto *end = in + src_size;
+  size_t out = 0;
+  while (in != end) {
+    const uint8_t token = *in++;
+    size_t num_literals = token >> 4;
+    if (num_literals == NIBBLE_MAX && !ReadLength(&in, end, &num_literals)) {
+      return false;
+    }
+    if (num_literals > static_cast<size_t>(end - in) || num_literals > dst_size - out) {
+      return false;
+    }
+    memcpy(dst + out, in, num_literals);
+    in += num_literals;
+    out += num_literals;
+    if (in == end) {
+      break;
+    }
+
+    if (end - in < 2) {
+      return false;
+    }
+    const size_t distance = in[0] | (static_cast<size_t>(in[1]) << 8);
+    in += 2;
+    size_t length = token & NIBBLE_MAX;
+    if (length == NIBBLE_MAX && !ReadLength(&in, end, &length)) {
+      return false;
+    }
+    length += MIN_MATCH;
+    if (distance == 0 || distance > out || length > dst_size - out) {
+      return false;
+    }
+    // Byte by byte, since the match may overlap what it writes.
+    for (size_t i = 0; i < length; i++, out++) {
+      dst[out] = dst[out - distance];
+    }
+  }
+  return out == dst_size;
+}
+
+}  // namespace bustub
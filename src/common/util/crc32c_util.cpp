@@ -0,0 +1,190 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// crc32c_util.cpp
+//
+// Identification: src/common/util/crc32c_util.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/crc32c_util.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace bustub {
+
+namespace {
+
+/** The CRC-32C polynomial, bit reflected. */
+constexpr uint32_t POLY = 0x82f63b78;
+
+/** Lookup table of the portable implementation: the CRC of every byte value. */
+struct ByteTable {
+  ByteTable() {
+    for (uint32_t byte = 0; byte < 256; byte++) {
+      uint32_t crc = byte;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 1) != 0 ? (crc >> 1) ^ POLY : crc >> 1;
+      }
+      table_[byte] = crc;
+    }
+  }
+  std::array<uint32_t, 256> table_;
+};
+
+auto UpdatePortable(uint32_t crc, const char *data, size_t size) -> uint32_t {
+  static const ByteTable TABLE;
+  for (size_t i = 0; i < size; i++) {
+    crc = TABLE.table_[(crc ^ static_cast<uint8_t>(data[i])) & 0xff] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+#if defined(__x86_64__)
+
+/**
+ * The three streams of the hardware implementation each cover one third of a block, and are combined by shifting the
+ * first two over the bytes that follow them. Long blocks amortize the shifts, short ones cover what is left of a page.
+ */
+constexpr size_t LONG_BLOCK = 1024;
+constexpr size_t SHORT_BLOCK = 128;
+
+/** @return mat * vec over GF(2), mat being a 32x32 bit matrix stored by column */
+auto Gf2MatrixTimes(const uint32_t *mat, uint32_t vec) -> uint32_t {
+  uint32_t sum = 0;
+  for (; vec != 0; vec >>= 1, mat++) {
+    if ((vec & 1) != 0) {
+      sum ^= *mat;
+    }
+  }
+  return sum;
+}
+
+void Gf2MatrixSquare(uint32_t *square, const uint32_t *mat) {
+  for (int n = 0; n < 32; n++) {
+    square[n] = Gf2MatrixTimes(mat, mat[n]);
+  }
+}
+
+/**
+ * Tables that apply the operator "run the CRC register over length zero bytes" one byte of the register at a time.
+ * length must be a power of two.
+ */
+struct ShiftTable {
+  explicit ShiftTable(size_t length) {
+    std::array<uint32_t, 32> even;
+    std::array<uint32_t, 32> odd;
+    // The operator for one zero bit, then two, four, ... zero bits, squaring until length bytes are covered.
+    odd[0] = POLY;
+    for (int n = 1; n < 32; n++) {
+      odd[n] = 1U << (n - 1);
+    }
+    Gf2MatrixSquare(even.data(), odd.data());
+    Gf2MatrixSquare(odd.data(), even.data());
+    const uint32_t *op;
+    while (true) {
+      Gf2MatrixSquare(even.data(), odd.data());
+      length >>= 1;
+      if (length == 0) {
+        op = even.data();
+        break;
+      }
+      Gf2MatrixSquare(odd.data(), even.data());
+      length >>= 1;
+      if (length == 0) {
+        op = odd.data();
+        break;
+      }
+    }
+    for (uint32_t n = 0; n < 256; n++) {
+      for (int byte = 0; byte < 4; byte++) {
+        table_[byte][n] = Gf2MatrixTimes(op, n << (8 * byte));
+      }
+    }
+  }
+
+  auto Shift(uint32_t crc) const -> uint32_t {
+    return table_[0][crc & 0xff] ^ table_[1][(crc >> 8) & 0xff] ^ table_[2][(crc >> 16) & 0xff] ^ table_[3][crc >> 24];
+  }
+
+  std::array<std::array<uint32_t, 256>, 4> table_;
+};
+
+auto Load64(const char *data) -> uint64_t {
+  uint64_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+/** Run the three streams over blocks of block_size bytes while they last. */
+__attribute__((target("sse4.2"))) auto UpdateBlocks(uint64_t crc, const char **data, size_t *size, size_t block_size,
+                                                     const ShiftTable &shift) -> uint64_t {
+  while (*size >= block_size * 3) {
+    uint64_t crc1 = 0;
+    uint64_t crc2 = 0;
+    const char *next = *data;
+    const char *end = next + block_size;
+    for (; next < end; next += 8) {
+      crc = _mm_crc32_u64(crc, Load64(next));
+      crc1 = _mm_crc32_u64(crc1, Load64(next + block_size));
+      crc2 = _mm_crc32_u64(crc2, Load64(next + block_size * 2));
+    }
+    crc = shift.Shift(static_cast<uint32_t>(crc)) ^ crc1;
+    crc = shift.Shift(static_cast<uint32_t>(crc)) ^ crc2;
+    *data += block_size * 3;
+    *size -= block_size * 3;
+  }
+  return crc;
+}
+
+__attribute__((target("sse4.2"))) auto UpdateHardware(uint32_t crc, const char *data, size_t size) -> uint32_t {
+  static const ShiftTable LONG_SHIFT(LONG_BLOCK);
+  static const ShiftTable SHORT_SHIFT(SHORT_BLOCK);
+  uint64_t crc64 = crc;
+  crc64 = UpdateBlocks(crc64, &data, &size, LONG_BLOCK, LONG_SHIFT);
+  crc64 = UpdateBlocks(crc64, &data, &size, SHORT_BLOCK, SHORT_SHIFT);
+  for (; size >= 8; data += 8, size -= 8) {
+    crc64 = _mm_crc32_u64(crc64, Load64(data));
+  }
+  crc = static_cast<uint32_t>(crc64);
+  for (; size > 0; data++, size--) {
+    crc = _mm_crc32_u8(crc, static_cast<uint8_t>(*data));
+  }
+  return crc;
+}
+
+#endif
+
+}  // namespace
+
+auto Crc32cUtil::IsHardwareAccelerated() -> bool {
+#if defined(__x86_64__)
+  static const bool SUPPORTED = __builtin_cpu_supports("sse4.2");
+  return SUPPORTED;
+#else
+  return false;
+#endif
+}
+
+auto Crc32cUtil::Checksum(const char *data, size_t size, uint32_t crc) -> uint32_t {
+#if defined(__x86_64__)
+  if (IsHardwareAccelerated()) {
+    return ~UpdateHardware(~crc, data, size);
+  }
+#endif
+  return ~UpdatePortable(~crc, data, size);
+}
+
+auto Crc32cUtil::ChecksumPortable(const char *data, size_t size, uint32_t crc) -> uint32_t {
+  return ~UpdatePortable(~crc, data, size);
+}
+
+}  // namespace bustub
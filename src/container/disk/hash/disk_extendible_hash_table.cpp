@@ -134,5 +134,9 @@ template class DiskExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>
 template class DiskExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
 template class DiskExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
 template class DiskExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+template class DiskExtendibleHashTable<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class DiskExtendibleHashTable<NormalizedKey<24>, RID, NormalizedComparator<24>>;
+template class DiskExtendibleHashTable<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class DiskExtendibleHashTable<NormalizedKey<64>, RID, NormalizedComparator<64>>;
 
 }  // namespace bustub
@@ -0,0 +1,31 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/vacuum_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+
+#include "binder/bound_statement.h"
+#include "common/enums/statement_type.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+/**
+ * VACUUM [FULL]. A plain VACUUM makes the freed pages durable in the free-space map, VACUUM FULL also truncates the
+ * free pages at the end of the database file.
+ */
+class VacuumStatement : public BoundStatement {
+ public:
+  explicit VacuumStatement(bool full) : BoundStatement(StatementType::VACUUM_STATEMENT), full_(full) {}
+
+  bool full_;
+
+  auto ToString() const -> std::string override { return fmt::format("BoundVacuum {{ full={} }}", full_); }
+};
+
+}  // namespace bustub
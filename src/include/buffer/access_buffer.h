@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_buffer.h
+//
+// Identification: src/include/buffer/access_buffer.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * AccessBuffer collects the accesses of buffer pool hits, so that they can be handed to the replacer in batches under
+ * the buffer pool latch rather than taking a lock on every hit (the BP-Wrapper scheme of Ding et al., ICDE 2009).
+ *
+ * Threads record into one of several stripes, each a ring of atomic slots on its own cache lines. Recording never
+ * blocks. If a ring wraps around before it is drained, the oldest accesses are overwritten, which only makes the
+ * replacement decisions a bit less precise. The stripes also count the accesses per access type, so that counting
+ * hits does not bounce a shared cache line between threads either.
+ */
+class AccessBuffer {
+ public:
+  AccessBuffer() = default;
+
+  DISALLOW_COPY_AND_MOVE(AccessBuffer);
+
+  ~AccessBuffer() = default;
+
+  /** @brief Record an access to a frame. */
+  void Record(frame_id_t frame_id, AccessType access_type);
+
+  /**
+   * @brief Hand every access recorded since the last call to apply, oldest first within a stripe. Calls must be
+   * serialized by the caller.
+   */
+  void Drain(const std::function<void(frame_id_t, AccessType)> &apply);
+
+  /** @return the number of accesses of the given type recorded so far, drained or not */
+  auto GetCount(AccessType access_type) const -> uint64_t;
+
+ private:
+  static constexpr size_t NUM_STRIPES = 16;
+  static constexpr size_t STRIPE_SLOTS = 128;
+  /** Set in every slot that holds an access, an empty slot is zero. */
+  static constexpr uint64_t VALID_BIT = 1ULL << 63;
+
+  struct alignas(64) Stripe {
+    std::atomic<uint64_t> write_pos_{0};
+    /** Only touched by Drain. */
+    uint64_t read_pos_{0};
+    std::array<std::atomic<uint64_t>, NUM_ACCESS_TYPES> counts_{};
+    std::array<std::atomic<uint64_t>, STRIPE_SLOTS> slots_{};
+  };
+
+  /** @return the stripe of the calling thread */
+  auto LocalStripe() -> Stripe &;
+
+  std::array<Stripe, NUM_STRIPES> stripes_;
+};
+
+}  // namespace bustub
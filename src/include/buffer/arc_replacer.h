@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy (Megiddo and Modha, FAST 2003).
+ *
+ * Resident frames live in T1 (seen once recently) or T2 (seen at least twice), both in LRU order. Pages evicted from
+ * T1 and T2 are remembered in the ghost lists B1 and B2. A page that comes back while in B1 means T1 was too small,
+ * and one in B2 means T2 was, so the target size p of T1 is moved accordingly. Evict takes the least recently used
+ * evictable frame of T1 while T1 is larger than p, and of T2 otherwise.
+ *
+ * AccessType::Scan and AccessType::Prefetch accesses never promote a frame to T2 and do not move p.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ARCReplacer.
+   * @param num_frames the number of frames the replacer tracks
+   */
+  explicit ARCReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ARCReplacer);
+
+  ~ARCReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto GetHotFrames() -> std::vector<frame_id_t> override;
+
+  /** @return the current target size of T1, for testing */
+  auto GetTarget() -> size_t;
+
+ private:
+  enum class List { None, T1, T2 };
+
+  struct Frame {
+    List list_{List::None};
+    bool is_evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    /** Position in the list of the frame, only valid while list_ is not List::None. */
+    std::list<frame_id_t>::iterator pos_;
+  };
+
+  struct Ghost {
+    /** Whether the page was evicted from T1, i.e. is in B1, rather than from T2. */
+    bool in_b1_;
+    std::list<page_id_t>::iterator pos_;
+  };
+
+  void CheckFrameId(frame_id_t frame_id) const {
+    BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  }
+
+  /** @return the least recently used evictable frame of the list */
+  auto FindVictim(const std::list<frame_id_t> &list) const -> std::optional<frame_id_t>;
+
+  /** Take a frame out of its list and forget it. */
+  void EraseFrame(frame_id_t frame_id);
+
+  /** Keep |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c by forgetting the oldest ghosts. */
+  void TrimGhosts();
+
+  void PopGhost(bool from_b1);
+
+  std::vector<Frame> frames_;
+  std::list<frame_id_t> t1_;
+  std::list<frame_id_t> t2_;
+  /** Ghost lists, least recently evicted first, and the position of every ghost page. */
+  std::list<page_id_t> b1_;
+  std::list<page_id_t> b2_;
+  std::unordered_map<page_id_t, Ghost> ghosts_;
+  /** Target size of T1, between 0 and the number of frames. */
+  size_t target_{0};
+  /** Number of evictable frames. */
+  size_t curr_size_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
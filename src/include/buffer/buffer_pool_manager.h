@@ -12,24 +12,66 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <future>  // NOLINT
+#include <limits>
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
-#include "buffer/lru_k_replacer.h"
+#include "buffer/access_buffer.h"
+#include "buffer/compressed_page_cache.h"
+#include "buffer/frame_arena.h"
+#include "buffer/page_table.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
+#include "common/metrics.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
 #include "storage/page/page.h"
 #include "storage/page/page_guard.h"
 
 namespace bustub {
 
+/** The counters of a buffer pool at some point in time, see BufferPoolManager::GetStats(). */
+struct BufferPoolStats {
+  /** Fetches that found their page in the buffer pool, per access type. */
+  std::array<uint64_t, NUM_ACCESS_TYPES> hits_{};
+  /** Fetches that had to read their page from disk, per access type. */
+  std::array<uint64_t, NUM_ACCESS_TYPES> misses_{};
+  /** Pages the replacer evicted to make room for another page. */
+  uint64_t evictions_{0};
+  /** Evicted pages that were dirty, i.e. that NewPage or FetchPage had to write back before reusing their frame. */
+  uint64_t write_backs_{0};
+  /** Pages written ahead of eviction by the background writer. */
+  uint64_t flusher_writes_{0};
+  /** How long NewPage and FetchPage calls that had to wait for disk I/O waited before handing out their page. */
+  LatencyHistogram::Snapshot pin_wait_;
+  /** Misses that were served from the compressed page cache rather than read from disk. */
+  uint64_t compressed_hits_{0};
+  /** Pages in the compressed page cache, and the bytes they take. */
+  uint64_t compressed_pages_{0};
+  uint64_t compressed_bytes_{0};
+
+  auto operator+=(const BufferPoolStats &other) -> BufferPoolStats &;
+
+  /** @return the share of fetches that were hits, over all access types, 0 if there were none */
+  auto GetHitRatio() const -> double;
+};
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
 class BufferPoolManager {
+  friend class ParallelBufferPoolManager;
+
  public:
   /**
    * @brief Creates a new BufferPoolManager.
@@ -37,24 +79,53 @@ class BufferPoolManager {
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_type the replacement policy
+   * @param arena_options how the memory of the frames is allocated
    */
   BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                    LogManager *log_manager = nullptr);
+                    LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRUK,
+                    const FrameArenaOptions &arena_options = {});
+
+  /**
+   * @brief Creates a new BufferPoolManager that is one instance of a ParallelBufferPoolManager.
+   *
+   * The instance only allocates page ids p with p % num_instances == instance_index, so that the parallel buffer pool
+   * can route every page id back to the instance that owns it.
+   *
+   * @param pool_size the size of the buffer pool
+   * @param num_instances the total number of instances in the parallel buffer pool
+   * @param instance_index the index of this instance in the parallel buffer pool
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy
+   * @param arena_options how the memory of the frames is allocated
+   */
+  BufferPoolManager(size_t pool_size, uint32_t num_instances, uint32_t instance_index, DiskManager *disk_manager,
+                    size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                    ReplacerType replacer_type = ReplacerType::LRUK, const FrameArenaOptions &arena_options = {});
 
   /**
    * @brief Destroy an existing BufferPoolManager.
    */
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager();
 
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t { return pool_size_; }
 
-  /** @brief Return the pointer to all the pages in the buffer pool. */
+  /** @brief Return the size of every page in the buffer pool, the page size of the database. */
+  auto GetPageSize() const -> size_t { return page_size_; }
+
+  /**
+   * @brief Return the number of bytes at the start of every page that page layouts may use, the rest holds the
+   * checksum of the page if the database has them. See DiskManager::GetUsablePageSize().
+   */
+  auto GetUsablePageSize() const -> size_t { return usable_page_size_; }
+
+  /** @brief Return the pointer to all the pages in the buffer pool, nullptr for a parallel buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Create a new page in the buffer pool. Set page_id to the new page's id, or nullptr if all frames
    * are currently in use and not evictable (in another word, pinned).
    *
@@ -64,16 +135,38 @@ class BufferPoolManager {
    *
    * Remember to "Pin" the frame by calling replacer.SetEvictable(frame_id, false)
    * so that the replacer wouldn't evict the frame before the buffer pool manager "Unpin"s it.
-   * Also, remember to record the access history of the frame in the replacer for the lru-k algorithm to work.
+   * Also, remember to record the access history of the frame in the replacer for the replacement policy to work.
    *
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  auto NewPage(page_id_t *page_id) -> Page *;
+  virtual auto NewPage(page_id_t *page_id) -> Page *;
 
   /**
-   * TODO(P1): Add implementation
+   * @brief Create a new page like NewPage, placed on disk as close as possible to another page. Pages freed by
+   * DeletePage are reused first, see DiskManager::AllocatePage().
    *
+   * @param[out] page_id id of created page
+   * @param hint a page the new one will be accessed together with, e.g. the page it is split from or the previous
+   * page of a heap; INVALID_PAGE_ID for none
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual auto NewPageNear(page_id_t *page_id, page_id_t hint) -> Page *;
+
+  /**
+   * @brief Create a new page like NewPage, in a segment of the database file. Later pages created near it with
+   * NewPageNear go to the same segment.
+   *
+   * @param[out] page_id id of created page
+   * @param segment a segment returned by CreateSegment()
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual auto NewPageInSegment(page_id_t *page_id, segment_id_t segment) -> Page *;
+
+  /** @return a new segment of the database file, for the pages of a table or an index, see DiskManager */
+  virtual auto CreateSegment() -> segment_id_t;
+
+  /**
    * @brief PageGuard wrapper for NewPage
    *
    * Functionality should be the same as NewPage, except that
@@ -81,13 +174,12 @@ class BufferPoolManager {
    * BasicPageGuard structure.
    *
    * @param[out] page_id, the id of the new page
+   * @param hint a page to place the new one close to, see NewPageNear
    * @return BasicPageGuard holding a new page
    */
-  auto NewPageGuarded(page_id_t *page_id) -> BasicPageGuard;
+  auto NewPageGuarded(page_id_t *page_id, page_id_t hint = INVALID_PAGE_ID) -> BasicPageGuard;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Fetch the requested page from the buffer pool. Return nullptr if page_id needs to be fetched from the disk
    * but all frames are currently in use and not evictable (in another word, pinned).
    *
@@ -98,15 +190,20 @@ class BufferPoolManager {
    *
    * In addition, remember to disable eviction and record the access history of the frame like you did for NewPage().
    *
+   * If the page fails its checksum or cannot be read, it is not kept in the buffer pool and the fetch throws; so does
+   * every fetch that was waiting for the same read.
+   *
+   * A page that is not in the buffer pool and not allocated on disk, e.g. one deleted while a reader that found its id
+   * in an unlatched page was on its way to it, is not read in either: nullptr is returned.
+   *
    * @param page_id id of page to be fetched
    * @param access_type type of access to the page, only needed for leaderboard tests.
    * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   * @throws PageCorruptionException if the page read from disk is corrupt, IOException if it cannot be read
    */
-  auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
+  virtual auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief PageGuard wrappers for FetchPage
    *
    * Functionality should be the same as FetchPage, except
@@ -115,15 +212,53 @@ class BufferPoolManager {
    * the returned page already has a read or write latch held, respectively.
    *
    * @param page_id, the id of the page to fetch
+   * @param access_type type of access to the page
    * @return PageGuard holding the fetched page
    */
-  auto FetchPageBasic(page_id_t page_id) -> BasicPageGuard;
-  auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
-  auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
+  auto FetchPageBasic(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> BasicPageGuard;
+  auto FetchPageRead(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> ReadPageGuard;
+  auto FetchPageWrite(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> WritePageGuard;
+
+  /**
+   * @brief Fetch and pin several pages at once, like calling FetchPage on each of them.
+   *
+   * The latch is taken once for the whole batch. The pages that are not in the buffer pool are read in page id order,
+   * and all of their reads are scheduled before waiting for any, so the disk scheduler serves them as one batch.
+   * Like FetchPagesRead, which needs it to latch every page once, the page ids must be distinct.
+   *
+   * @param page_ids distinct ids of the pages to fetch
+   * @param access_type type of access to the pages
+   * @return the pages, in the order of page_ids, with nullptr for the pages that are not allocated (see FetchPage())
+   * or that no frame could be found for
+   * @throws PageCorruptionException if one of the pages read from disk is corrupt, IOException if one cannot be read;
+   * either way none of the pages stays pinned
+   */
+  virtual auto FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<Page *>;
 
   /**
-   * TODO(P1): Add implementation
+   * @brief FetchPages wrapper that returns read latched guards. The latches are taken in page id order. A thread
+   * cannot hold the read latch of a page twice, so the page ids must be distinct.
    *
+   * @param page_ids distinct ids of the pages to fetch
+   * @param access_type type of access to the pages
+   * @return a guard for every page, in the order of page_ids, empty for the pages no frame could be found for
+   */
+  auto FetchPagesRead(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<ReadPageGuard>;
+
+  /**
+   * @brief Read a page without pinning or latching it. Only pages that are already in the buffer pool and not being
+   * written are served, nothing is read from disk.
+   *
+   * @param page_id id of the page to read
+   * @param access_type type of access to the page
+   * @return a guard on the page, or an empty guard if the caller has to fetch the page the regular way
+   */
+  virtual auto FetchPageOptimistic(page_id_t page_id, AccessType access_type = AccessType::Unknown)
+      -> OptimisticPageGuard;
+
+  /**
    * @brief Unpin the target page from the buffer pool. If page_id is not in the buffer pool or its pin count is already
    * 0, return false.
    *
@@ -135,78 +270,371 @@ class BufferPoolManager {
    * @param access_type type of access to the page, only needed for leaderboard tests.
    * @return false if the page is not in the page table or its pin count is <= 0 before this call, true otherwise
    */
-  auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool;
+  virtual auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Flush the target page to disk.
    *
    * Use the DiskManager::WritePage() method to flush a page to disk, REGARDLESS of the dirty flag.
    * Unset the dirty flag of the page after flushing.
    *
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
-   * @return false if the page could not be found in the page table, true otherwise
+   * @return false if the page could not be found in the page table or read from disk, true otherwise
    */
-  auto FlushPage(page_id_t page_id) -> bool;
+  virtual auto FlushPage(page_id_t page_id) -> bool;
 
   /**
-   * TODO(P1): Add implementation
-   *
-   * @brief Flush all the pages in the buffer pool to disk.
+   * @brief Flush all the pages in the buffer pool to disk. This is a durability point: the free-space map of the disk
+   * manager is saved along with the pages, listing the pages deleted before the flush started.
    */
-  void FlushAllPages();
+  virtual void FlushAllPages();
+
+  /**
+   * @brief Flush the buffer pool, then shrink the database file by the free pages at its end. Deleted pages are
+   * reused by later allocations anyway, this gives the space back to the file system.
+   * @return the number of pages the file shrank by
+   */
+  virtual auto Vacuum() -> size_t;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Delete a page from the buffer pool. If page_id is not in the buffer pool, do nothing and return true. If the
    * page is pinned and cannot be deleted, return false immediately.
    *
    * After deleting the page from the page table, stop tracking the frame in the replacer and add the frame
-   * back to the free list. Also, reset the page's memory and metadata. Finally, you should call DeallocatePage() to
-   * imitate freeing the page on the disk.
+   * back to the free list. Also, reset the page's memory and metadata. Finally, DeallocatePage() gives the page id back
+   * to the free-space map of the disk manager, to be reused by a later NewPage.
    *
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
-  auto DeletePage(page_id_t page_id) -> bool;
+  virtual auto DeletePage(page_id_t page_id) -> bool;
+
+  /**
+   * @brief Start reading a page into the buffer pool in the background, so that a later FetchPage of it is a hit.
+   *
+   * The page is not pinned: its frame is evictable as soon as it is handed out, and a FetchPage that arrives while the
+   * read is still in flight simply waits for it. Only pages that are allocated, and not deleted since, are read. A
+   * prefetch never waits for a frame; if all frames are pinned it does nothing.
+   *
+   * @param page_id id of the page to read ahead
+   * @param evict whether an unpinned page may be evicted to make room, otherwise only a free frame is used
+   * @return true if a read was scheduled, false if the page is already in the buffer pool or could not be read
+   */
+  virtual auto Prefetch(page_id_t page_id, bool evict = true) -> bool;
+
+  /**
+   * @brief Prefetch the pages first_page_id, first_page_id + 1, ..., first_page_id + num_pages - 1.
+   * @param first_page_id id of the first page to read ahead
+   * @param num_pages number of pages to read ahead
+   * @return the number of reads that were scheduled
+   */
+  auto PrefetchRange(page_id_t first_page_id, size_t num_pages) -> size_t;
+
+  /** @brief Return how many fetches of the given access type found their page in the buffer pool. */
+  virtual auto GetHitCount(AccessType access_type) -> uint64_t;
+
+  /** @brief Return how many fetches of the given access type had to read their page from disk. */
+  virtual auto GetMissCount(AccessType access_type) -> uint64_t;
+
+  /**
+   * @brief Return the counters of the buffer pool. They are kept without locks, so reading them while the buffer pool
+   * is busy gives values that may be a few operations apart from each other.
+   */
+  virtual auto GetStats() -> BufferPoolStats;
+
+  /**
+   * @brief Keep compressed copies of the pages the buffer pool evicts in memory, so that fetching them again does not
+   * go to disk. Dirty pages are still written back. Pages the buffer pool reads back leave the compressed cache. Call
+   * it before the buffer pool is used, it is not safe against concurrent fetches.
+   * @param capacity the number of bytes of compressed pages to keep, 0 turns the compressed cache off
+   */
+  virtual void SetCompressedCacheSize(size_t capacity);
+
+  /**
+   * @brief Start the background writer (flusher), which writes out dirty, unpinned pages ahead of eviction so that
+   * NewPage and FetchPage rarely have to wait for a write-back.
+   *
+   * Every FLUSHER_INTERVAL_MS, and whenever an eviction had to write back its victim, it sweeps the frames like a
+   * clock and writes dirty pages until target_clean_percent of the frames are unpinned and clean. Pages are only
+   * written while read latched, and, with logging enabled, once their LSN is persistent in the log. Does nothing if
+   * the flusher is already running.
+   *
+   * @param target_clean_percent share of the frames to keep clean, between 0 and 100
+   */
+  virtual void StartFlusher(size_t target_clean_percent = FLUSHER_CLEAN_PERCENT);
+
+  /** @brief Stop the background writer and wait for its writes to finish. Does nothing if it is not running. */
+  virtual void StopFlusher();
+
+  /**
+   * @brief Return the pages in the buffer pool, hottest first, in the reverse of the order the replacer would evict
+   * them.
+   */
+  virtual auto GetHotPages() -> std::vector<page_id_t>;
+
+  /**
+   * @brief Write the ids of the pages in the buffer pool to a file, hottest first, one per line. The file is replaced
+   * atomically, so a crash while saving leaves the previous hot set.
+   * @param file_name the file to write
+   * @return false if the file could not be written
+   */
+  auto SaveHotSet(const std::string &file_name) -> bool;
+
+  /**
+   * @brief Save the hot set to the given file on every FlushAllPages, so that it can be reloaded with WarmUp after a
+   * restart. An empty name turns it off.
+   */
+  void SetHotSetFile(const std::string &file_name);
+
+  /**
+   * @brief Read back the pages of a hot set saved by SaveHotSet, so that the first queries after a restart do not all
+   * miss.
+   *
+   * The hottest pages that fit in the buffer pool are prefetched in page id order, so that the disk sees long sequential
+   * runs. Warm-up only fills free frames: it never evicts a page the workload has already brought in, and it skips
+   * pages that are resident or that no longer exist. Returns early if StopWarmUp is called.
+   *
+   * @param file_name the file written by SaveHotSet, a missing file warms up nothing
+   * @param pages_per_second the maximum rate at which pages are read, 0 for no limit
+   * @return the number of reads that were scheduled
+   */
+  auto WarmUp(const std::string &file_name, size_t pages_per_second = 0) -> size_t;
+
+  /**
+   * @brief Run WarmUp on a background thread, so that queries can start right away. Does nothing if a warm-up is
+   * already running.
+   */
+  void StartWarmUp(const std::string &file_name, size_t pages_per_second = 0);
+
+  /** @brief Interrupt the background warm-up and wait for it to exit. Does nothing if it is not running. */
+  void StopWarmUp();
+
+ protected:
+  /**
+   * @brief Used by ParallelBufferPoolManager, which owns no frames itself and forwards every call to its instances.
+   * @param pool_size the total number of frames across all instances
+   * @param page_size the page size of the instances
+   * @param usable_page_size the usable page size of the instances
+   */
+  BufferPoolManager(size_t pool_size, size_t page_size, size_t usable_page_size);
+
+  /** @brief Save the hot set to the file given to SetHotSetFile, if any. */
+  void SaveHotSetFile();
 
  private:
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
-  /** The next page id to be allocated  */
-  std::atomic<page_id_t> next_page_id_ = 0;
-
-  /** Array of buffer pool pages. */
-  Page *pages_;
+  /** Size of each page in bytes, taken from the disk manager. */
+  const size_t page_size_;
+  /** Part of each page available to page layouts, taken from the disk manager. */
+  const size_t usable_page_size_;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPM) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPM instance in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
+  /** Array of buffer pool pages, the book-keeping of each frame. */
+  Page *pages_{nullptr};
+  /** The page data of all frames. */
+  std::unique_ptr<FrameArena> arena_;
   /** Pointer to the disk manager. */
-  DiskManager *disk_manager_ __attribute__((__unused__));
-  /** Pointer to the log manager. Please ignore this for P1. */
-  LogManager *log_manager_ __attribute__((__unused__));
+  DiskManager *disk_manager_{nullptr};
+  /** Pointer to the disk scheduler, which serves page reads and writes on background threads. */
+  std::unique_ptr<DiskScheduler> disk_scheduler_;
+  /** The second tier of clean pages evicted from the buffer pool, nullptr if it is turned off. */
+  std::unique_ptr<CompressedPageCache> compressed_cache_;
+  /** Pointer to the log manager. The flusher checks the persistent LSN against the pages it writes. */
+  LogManager *log_manager_ = nullptr;
   /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  std::unique_ptr<PageTable> page_table_;
   /** Replacer to find unpinned pages for replacement. */
-  std::unique_ptr<LRUKReplacer> replacer_;
+  std::unique_ptr<Replacer> replacer_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /**
+   * For every frame whose page is still being read from disk (or whose previous page is still being written back), a
+   * future that becomes ready once the frame holds the new page. Invalid for frames that are not loading. A prefetched
+   * frame may keep a future that is already ready until the next time the frame is touched.
+   */
+  std::vector<std::shared_future<bool>> frame_loads_;
+  /** Accesses of FetchPage hits not yet applied to the replacer. It also counts the hits, per access type. */
+  AccessBuffer access_buffer_;
+  /** Number of FetchPage calls that missed, per access type. */
+  std::array<std::atomic<uint64_t>, NUM_ACCESS_TYPES> misses_{};
+  /** The other counters of GetStats(). */
+  StripedCounter evictions_;
+  StripedCounter write_backs_;
+  StripedCounter flusher_writes_;
+  LatencyHistogram pin_wait_;
+  /**
+   * This latch serializes every change to page_table_, free_list_, frame_loads_, the replacer and the page id of
+   * every frame. It is not held during disk I/O. The page data is protected by the per-page latch.
+   *
+   * Fetching and unpinning a page that is ready in the page table does not take it: the page is looked up with
+   * PageTable::FindReady and pinned by bumping its atomic pin count, and the access is recorded in access_buffer_,
+   * which is drained into the replacer before the next eviction. A frame is only evicted or deleted after its pin
+   * count is swapped from 0 to FRAME_LOCKED, so a lock-free pin either lands first and keeps the frame, or sees the
+   * negative count and backs off. A frame leaves the page table before its version is bumped for reuse, which is
+   * what lets FetchPageOptimistic trust a frame it finds ready after reading the version.
+   */
   std::mutex latch_;
 
+  /** The background writer thread, joinable while it runs. */
+  std::thread flusher_;
+  /** Protects flusher_stop_, and lets the flusher sleep on flusher_cv_. */
+  std::mutex flusher_latch_;
+  std::condition_variable flusher_cv_;
+  bool flusher_stop_{false};
+  /** Number of clean, unpinned frames the flusher aims for. */
+  size_t flusher_target_{0};
+  /** The next frame the flusher looks at. Only touched by the flusher thread. */
+  size_t flusher_hand_{0};
+
+  /** Where FlushAllPages saves the hot set, empty if it does not. */
+  std::string hot_set_file_;
+  /** The background warm-up thread, joinable while it runs. */
+  std::thread warm_up_;
+  /** Protects warm_up_stop_, and lets the warm-up sleep on warm_up_cv_ while it is throttled. */
+  std::mutex warm_up_latch_;
+  std::condition_variable warm_up_cv_;
+  bool warm_up_stop_{false};
+
+  /** Pin count bias of a frame that is being evicted or deleted, or that is being handed a new page. */
+  static constexpr int FRAME_LOCKED = std::numeric_limits<int>::min() / 2;
+
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Allocate a page on disk, among the page ids of this instance. Caller should acquire the latch before calling
+   * this function.
+   * @param hint a page to place the new one close to, INVALID_PAGE_ID for none
+   * @param segment the segment to allocate the page in, INVALID_SEGMENT_ID for the one of the hint
    * @return the id of the allocated page
    */
-  auto AllocatePage() -> page_id_t;
+  auto AllocatePage(page_id_t hint, segment_id_t segment) -> page_id_t;
+
+  /** @brief Create a new page, see NewPageNear and NewPageInSegment. */
+  auto NewPageAt(page_id_t *page_id, page_id_t hint, segment_id_t segment) -> Page *;
 
   /**
    * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id) { disk_manager_->DeallocatePage(page_id); }
+
+  /** The parts of evicting a page that AcquireFrame leaves to the caller, to be done without the latch. */
+  struct Eviction {
+    /** Completes when the victim page is on disk, invalid if there was nothing to write. */
+    std::future<bool> write_back_;
+    /** The victim page, if a compressed copy of it is to be kept, with the ticket of its reservation. */
+    page_id_t cached_page_id_{INVALID_PAGE_ID};
+    uint64_t cache_ticket_{0};
+
+    auto IsPending() const -> bool { return write_back_.valid() || cached_page_id_ != INVALID_PAGE_ID; }
+  };
+
+  /**
+   * @brief Find a frame to hold a new page, from the free list first and then from the replacer. If the victim frame
+   * holds a dirty page, its write-back is scheduled, and if there is a compressed page cache, a copy of the page is
+   * reserved in it. The caller must call FinishEviction before reusing the frame's memory. The frame is returned locked
+   * (see FRAME_LOCKED), the caller unlocks it with UnlockFrame once it holds the new page. Frames whose prefetch is
+   * still reading are only chosen when no other frame is evictable. Caller should acquire the latch before calling
+   * this function.
+   * @param[out] frame_id the frame that can be reused
+   * @param[out] eviction what is left to do for the victim page
+   * @return false if all frames are pinned, true otherwise
+   */
+  auto AcquireFrame(frame_id_t *frame_id, Eviction *eviction) -> bool;
+
+  /**
+   * @brief Compress the victim page of a frame into the compressed page cache and wait for its write-back. The frame
+   * must be pinned or locked by the caller. Call this without the latch: compressing a page takes a while.
+   */
+  void FinishEviction(frame_id_t frame_id, Eviction *eviction);
+
+  /**
+   * @brief Pin a frame found by PageTable::FindReady without taking the latch.
+   * @return true if the frame was pinned and still holds the page, false if the caller has to take the slow path
+   */
+  auto TryPinReady(page_id_t page_id, frame_id_t frame_id) -> bool;
+
+  /**
+   * @brief Release a pin on a page, marking it dirty if asked to.
+   * @return false if the page was not pinned
+   */
+  auto ReleasePin(Page *page, bool is_dirty) -> bool;
+
+  /** @brief Swap the pin count of an unpinned frame to FRAME_LOCKED. @return false if the frame is pinned */
+  auto TryLockFrame(frame_id_t frame_id) -> bool;
+
+  /** @brief Remove the FRAME_LOCKED bias from a frame, leaving it with the given number of pins. */
+  void UnlockFrame(frame_id_t frame_id, int pin_count);
+
+  /** @brief Apply the accesses recorded by lock-free hits to the replacer. Caller should acquire the latch. */
+  void DrainAccesses();
+
+  /** @brief Main loop of the background writer. */
+  void RunFlusher();
+
+  /** @brief One sweep of the background writer: write dirty, unpinned pages until enough frames are clean. */
+  void FlushAhead();
+
+  /**
+   * @brief Wait until the read of a prefetched frame has landed, while holding the latch. Prefetched frames are the
+   * only unpinned frames that can still be loading; AcquireFrame passes them over while it has a choice, so this
+   * rarely waits. Caller should acquire the latch before calling this function.
+   * @return false if the read failed, in which case the frame holds garbage that must be neither cached nor written
+   */
+  auto WaitForPrefetch(frame_id_t frame_id) -> bool;
+
+  /**
+   * @brief Give up a pin on a frame whose page could not be loaded. The first caller takes the page out of the page
+   * table, so that the next fetch reads it again, and the frame goes back to the free list once nobody pins it.
+   * Caller should acquire the latch before calling this function.
+   */
+  void DiscardFailedLoad(frame_id_t frame_id);
+
+  /** @brief Return the exception a load completed with, nullptr if it succeeded. The load must be ready. */
+  static auto LoadError(const std::shared_future<bool> &load) -> std::exception_ptr;
+
+  /**
+   * @brief Schedule a read or write of the page held by the given frame on the disk scheduler.
+   * @return a future that becomes ready once the request has been executed
+   */
+  auto ScheduleIO(bool is_write, frame_id_t frame_id) -> std::future<bool>;
+
+  /**
+   * @brief Load the page held by the given frame, from the compressed page cache if it has it, from disk otherwise.
+   * @return a future that becomes ready once the page is in the frame
+   */
+  auto LoadPage(frame_id_t frame_id) -> std::future<bool>;
+
+  /** @brief Return the memory of every frame, as registered with the disk manager. */
+  auto GetFrameBuffers() -> std::vector<char *>;
+
+  /** The pages of a FetchPages call whose reads are in flight. */
+  struct FetchBatch {
+    struct Read {
+      frame_id_t frame_id_;
+      /** Completes when the page is in the frame, once the read is scheduled. */
+      std::future<bool> done_;
+      /** Tells the fetches that find the frame in the meantime how the read went. */
+      std::promise<bool> loaded_;
+      std::shared_future<bool> load_;
+    };
+    std::vector<Page *> pages_;
+    std::vector<Read> reads_;
+    /** Frames that were found in the buffer pool, but that someone else is still loading (or failed to load). */
+    std::vector<std::pair<frame_id_t, std::shared_future<bool>>> loading_;
+  };
+
+  /**
+   * @brief First half of FetchPages: pin the pages and schedule the reads of those that are not in the buffer pool,
+   * without waiting for them. ParallelBufferPoolManager starts the batch of every instance before finishing any.
+   */
+  auto StartFetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type) -> FetchBatch;
+
+  /** @brief Second half of FetchPages: wait for the reads of the batch and return its pages, or throw. */
+  auto FinishFetchPages(FetchBatch *batch) -> std::vector<Page *>;
 
-  // TODO(student): You may add additional private members and helper functions
+  /** @brief Check that page_id belongs to this instance of the parallel buffer pool. */
+  void ValidatePageId(page_id_t page_id) const;
 };
 }  // namespace bustub
@@ -12,17 +12,22 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
 #include <vector>
 
 #include "buffer/replacer.h"
 #include "common/config.h"
+#include "common/macros.h"
 
 namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * Every tracked frame has a reference bit that is set on access. The clock hand sweeps over the frames, clearing the
+ * reference bits it passes, and evicts the first evictable frame whose bit is already clear. A frame brought in by an
+ * AccessType::Scan or AccessType::Prefetch access starts with a clear reference bit, so a scan is evicted on the next
+ * sweep unless the frame is accessed again.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -32,21 +37,43 @@ class ClockReplacer : public Replacer {
    */
   explicit ClockReplacer(size_t num_pages);
 
+  DISALLOW_COPY_AND_MOVE(ClockReplacer);
+
   /**
    * Destroys the ClockReplacer.
    */
   ~ClockReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
 
-  void Pin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
+  auto GetHotFrames() -> std::vector<frame_id_t> override;
+
  private:
-  // TODO(student): implement me!
+  struct Frame {
+    bool is_tracked_{false};
+    bool is_evictable_{false};
+    bool reference_{false};
+  };
+
+  void CheckFrameId(frame_id_t frame_id) const {
+    BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  }
+
+  std::vector<Frame> frames_;
+  /** The next frame the clock hand looks at. */
+  size_t hand_{0};
+  /** Number of evictable frames. */
+  size_t curr_size_{0};
+  std::mutex latch_;
 };
 
 }  // namespace bustub
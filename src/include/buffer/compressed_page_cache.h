@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.h
+//
+// Identification: src/include/buffer/compressed_page_cache.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * CompressedPageCache is a second tier below the buffer pool: it keeps compressed copies of the pages the buffer pool
+ * evicted, so that fetching them again costs a decompression instead of a disk read.
+ *
+ * The cache is exclusive. A page leaves it when it is taken back into the buffer pool, so a page is never both
+ * resident and cached, and a cached copy is always the same as the page on disk once pending write-backs are done.
+ * When the compressed copies outgrow the capacity, the least recently stored ones are dropped. All methods are thread
+ * safe. Compression and decompression run outside the internal latch.
+ *
+ * The buffer pool compresses an evicted page after it lets go of its own latch. It reserves the page while it still
+ * holds the latch, so that a copy that lands after the page was taken back, deleted or evicted again is dropped.
+ */
+class CompressedPageCache {
+ public:
+  /**
+   * @param capacity the maximum number of bytes of compressed data to keep
+   * @param page_size the size of the pages that are stored
+   */
+  CompressedPageCache(size_t capacity, size_t page_size);
+
+  DISALLOW_COPY_AND_MOVE(CompressedPageCache);
+
+  ~CompressedPageCache() = default;
+
+  /**
+   * @brief Announce that a page left the buffer pool and that a copy of it is on its way. Drops any older copy.
+   * @return the ticket to pass to Insert; Take, Erase and a later Reserve of the page void it
+   */
+  auto Reserve(page_id_t page_id) -> uint64_t;
+
+  /**
+   * @brief Store a compressed copy of a page that was reserved, unless the reservation was voided since. Pages that do
+   * not compress to at most COMPRESSED_CACHE_MAX_PERCENT of their size are not worth the memory and are not stored.
+   * @return true if the page was stored
+   */
+  auto Insert(page_id_t page_id, const char *data, uint64_t ticket) -> bool;
+
+  /** @brief Reserve a page and store a compressed copy of it right away, replacing any older copy. */
+  auto Insert(page_id_t page_id, const char *data) -> bool { return Insert(page_id, data, Reserve(page_id)); }
+
+  /**
+   * @brief Decompress a page into data and drop it from the cache.
+   * @return true if the page was in the cache, false if it has to be read from disk
+   */
+  auto Take(page_id_t page_id, char *data) -> bool;
+
+  /** @brief Drop a page from the cache, e.g. because it was deleted. */
+  void Erase(page_id_t page_id);
+
+  /** @return the maximum number of bytes of compressed data */
+  auto GetCapacity() const -> size_t { return capacity_; }
+
+  /** @return the number of bytes of compressed data in the cache */
+  auto GetSize() -> size_t;
+
+  /** @return the number of pages in the cache */
+  auto GetNumPages() -> size_t;
+
+  /** @return the number of calls to Take that found their page */
+  auto GetHitCount() const -> uint64_t { return hits_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Entry {
+    page_id_t page_id_;
+    std::vector<char> data_;
+  };
+
+  /** Remove an entry and account for its size. Caller should acquire the latch. */
+  void EraseEntry(std::list<Entry>::iterator entry);
+
+  const size_t capacity_;
+  const size_t page_size_;
+  std::atomic<uint64_t> hits_{0};
+
+  /** Protects lru_, entries_, reservations_, next_ticket_ and size_. */
+  std::mutex latch_;
+  /** The cached pages, most recently stored first. */
+  std::list<Entry> lru_;
+  std::unordered_map<page_id_t, std::list<Entry>::iterator> entries_;
+  /** The pages whose copy is being compressed, with the ticket of the copy that may be stored. */
+  std::unordered_map<page_id_t, uint64_t> reservations_;
+  uint64_t next_ticket_{0};
+  /** Total size of the compressed data. */
+  size_t size_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** Whether the frames of a buffer pool are backed by huge pages. */
+enum class HugePageMode {
+  /** Regular pages. */
+  None = 0,
+  /** Transparent huge pages, requested with madvise(MADV_HUGEPAGE). The kernel decides whether to use them. */
+  Transparent,
+  /** Pages from the hugetlbfs pool (MAP_HUGETLB). Falls back to transparent huge pages if the pool is too small. */
+  Explicit,
+};
+
+/** How the frames of a buffer pool are spread over NUMA nodes. */
+enum class NumaPlacement {
+  /** Each frame lands on the node of the thread that touches it first, the kernel default. */
+  FirstTouch = 0,
+  /** Frames are interleaved over all nodes page by page, with mbind(MPOL_INTERLEAVE). */
+  Interleave,
+};
+
+/** How the memory of a FrameArena is allocated. */
+struct FrameArenaOptions {
+  HugePageMode huge_pages_{HugePageMode::Transparent};
+  NumaPlacement numa_placement_{NumaPlacement::FirstTouch};
+};
+
+/**
+ * FrameArena holds the page data of every frame of a buffer pool in one contiguous, page aligned mapping, so that
+ * frames can be backed by huge pages and do not scatter over the heap. The memory comes zeroed from the kernel and is
+ * only faulted in when a frame is first used, which keeps the start-up of large pools cheap.
+ *
+ * When built with AddressSanitizer, every frame is followed by a poisoned gap of one page, so that overflowing a page
+ * is still reported rather than silently corrupting the next frame.
+ */
+class FrameArena {
+ public:
+  /**
+   * @brief Map the memory of num_frames frames.
+   * @param num_frames the number of frames
+   * @param page_size the size of each frame, see IsValidPageSize()
+   * @param options how the memory is allocated
+   * @throws Exception if the memory cannot be mapped
+   */
+  FrameArena(size_t num_frames, size_t page_size, const FrameArenaOptions &options);
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  ~FrameArena();
+
+  /** @return the page size bytes of the given frame, aligned to BUSTUB_PAGE_ALIGNMENT */
+  auto GetFrame(frame_id_t frame_id) const -> char * { return base_ + static_cast<size_t>(frame_id) * stride_; }
+
+  /** @return true if the arena was mapped from the hugetlbfs pool */
+  auto IsHugeTlb() const -> bool { return huge_tlb_; }
+
+ private:
+  size_t num_frames_;
+  size_t page_size_;
+  /** Distance between the start of two frames, more than a page when there are guard gaps. */
+  size_t stride_;
+  size_t size_;
+  char *base_{nullptr};
+  bool huge_tlb_{false};
+};
+
+}  // namespace bustub
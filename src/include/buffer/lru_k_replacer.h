@@ -12,28 +12,100 @@
 
 #pragma once
 
-#include <limits>
-#include <list>
+#include <deque>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <set>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
 namespace bustub {
 
-enum class AccessType { Unknown = 0, Get, Scan };
-
 class LRUKNode {
- private:
-  /** History of last seen K timestamps of this page. Least recent timestamp stored in front. */
-  // Remove maybe_unused if you start using them. Feel free to change the member variables as you want.
+ public:
+  LRUKNode() = default;
+  /**
+   * @param k the lookback constant
+   * @param fid the frame this node keeps the history of
+   * @param history room for k timestamps, owned by the replacer
+   */
+  LRUKNode(size_t k, frame_id_t fid, size_t *history) : k_(k), fid_(fid), history_(history) {}
+
+  /** Append a timestamp to the history, overwriting the least recent one once k of them are stored. */
+  void RecordAccess(size_t timestamp) {
+    if (size_ < k_) {
+      history_[(head_ + size_) % k_] = timestamp;
+      size_++;
+    } else {
+      history_[head_] = timestamp;
+      head_ = (head_ + 1) % k_;
+    }
+  }
+
+  /** Forget every recorded access. */
+  void ClearHistory() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+  /** @return true if the frame has been accessed since it was last evicted or removed */
+  auto HasHistory() const -> bool { return size_ > 0; }
+
+  /** @return true if the frame has been accessed at least k times, i.e. its backward k-distance is finite */
+  auto HasKAccesses() const -> bool { return size_ >= k_; }
+
+  /**
+   * @return the least recent timestamp in the history. For a frame with k accesses this is the k-th previous
+   * access, so a smaller value means a larger backward k-distance.
+   */
+  auto EarliestTimestamp() const -> size_t { return history_[head_]; }
+
+  /** @return the most recent timestamp in the history */
+  auto LatestTimestamp() const -> size_t { return history_[(head_ + size_ - 1) % k_]; }
+
+  /** @return true if the frame has only ever been accessed by sequential scans */
+  auto IsScanOnly() const -> bool { return is_scan_only_; }
+  void SetScanOnly(bool is_scan_only) { is_scan_only_ = is_scan_only; }
+
+  /** @return true if the frame was read ahead of a scan that has not reached it yet */
+  auto IsPrefetched() const -> bool { return is_prefetched_; }
+  void SetPrefetched(bool is_prefetched) { is_prefetched_ = is_prefetched; }
+
+  auto IsEvictable() const -> bool { return is_evictable_; }
+  void SetEvictable(bool is_evictable) { is_evictable_ = is_evictable; }
+
+  auto GetFrameId() const -> frame_id_t { return fid_; }
+
+  /**
+   * @return the position of the frame in the eviction order, the smallest key is evicted first. Scan-only frames come
+   * first, least recently used first. Then frames with less than k accesses (+inf backward k-distance), then frames
+   * read ahead of a scan that are still waiting for it, then the others. The replacer ages prefetched frames out into
+   * the scan-only ones, see LRUKReplacer.
+   */
+  auto EvictionKey() const -> std::tuple<int, size_t, frame_id_t> {
+    if (is_prefetched_) {
+      return {2, LatestTimestamp(), fid_};
+    }
+    if (is_scan_only_) {
+      return {0, LatestTimestamp(), fid_};
+    }
+    return {HasKAccesses() ? 3 : 1, EarliestTimestamp(), fid_};
+  }
 
-  [[maybe_unused]] std::list<size_t> history_;
-  [[maybe_unused]] size_t k_;
-  [[maybe_unused]] frame_id_t fid_;
-  [[maybe_unused]] bool is_evictable_{false};
+ private:
+  size_t k_{0};
+  frame_id_t fid_{INVALID_PAGE_ID};
+  /** Ring buffer of the last seen k timestamps of this page. The least recent one is at head_. */
+  size_t *history_{nullptr};
+  size_t head_{0};
+  size_t size_{0};
+  bool is_evictable_{false};
+  bool is_scan_only_{false};
+  bool is_prefetched_{false};
 };
 
 /**
@@ -46,13 +118,22 @@ class LRUKNode {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multipe frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * Evictable frames are kept in a set ordered by eviction priority, so every operation is O(log n) in the number of
+ * frames rather than a scan over all of them.
+ *
+ * To keep a large sequential scan from flushing the working set, frames that have only been touched by
+ * AccessType::Scan accesses are evicted before any other frame, least recently used first. A scan touching a frame
+ * that is in the working set does not count as an access, so it neither promotes nor demotes the frame.
+ *
+ * A frame brought in by an AccessType::Prefetch access is scan-only as well, but it is kept until the scan reaches it
+ * (or the working set is all that is left to evict), so that a run of prefetches does not evict its own pages. The
+ * scan has as many accesses as there are frames to get there: after that, the read-ahead was wasted and the frame
+ * becomes an ordinary scan-only frame, evicted before the working set.
  */
-class LRUKReplacer {
+class LRUKReplacer : public Replacer {
  public:
   /**
-   *
-   * TODO(P1): Add implementation
-   *
    * @brief a new LRUKReplacer.
    * @param num_frames the maximum number of frames the LRUReplacer will be required to store
    */
@@ -61,15 +142,11 @@ class LRUKReplacer {
   DISALLOW_COPY_AND_MOVE(LRUKReplacer);
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Find the frame with largest backward k-distance and evict that frame. Only frames
    * that are marked as 'evictable' are candidates for eviction.
    *
@@ -83,11 +160,9 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Record the event that the given frame id is accessed at current timestamp.
    * Create a new entry for access history if frame id has not been seen before.
    *
@@ -95,14 +170,14 @@ class LRUKReplacer {
    * also use BUSTUB_ASSERT to abort the process if frame id is invalid.
    *
    * @param frame_id id of frame that received a new access.
-   * @param access_type type of access that was received. This parameter is only needed for
-   * leaderboard tests.
+   * @param access_type type of access that was received. Frames only accessed by AccessType::Scan are
+   * evicted first.
+   * @param page_id unused, LRU-K does not remember evicted pages.
    */
-  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown);
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Toggle whether a frame is evictable or non-evictable. This function also
    * controls replacer's size. Note that size is equal to number of evictable entries.
    *
@@ -117,11 +192,9 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Remove an evictable frame from replacer, along with its access history.
    * This function should also decrement replacer's size if removal is successful.
    *
@@ -136,26 +209,45 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Return replacer's size, which tracks the number of evictable frames.
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
+
+  /**
+   * Pinned frames come first, as they cannot be evicted at all, then the evictable frames from the largest eviction
+   * key to the smallest.
+   */
+  auto GetHotFrames() -> std::vector<frame_id_t> override;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  [[maybe_unused]] std::unordered_map<frame_id_t, LRUKNode> node_store_;
-  [[maybe_unused]] size_t current_timestamp_{0};
-  [[maybe_unused]] size_t curr_size_{0};
-  [[maybe_unused]] size_t replacer_size_;
-  [[maybe_unused]] size_t k_;
-  [[maybe_unused]] std::mutex latch_;
+  /** Abort the process if frame_id is not a valid frame of this replacer. */
+  void CheckFrameId(frame_id_t frame_id) const {
+    BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  }
+
+  /** Remove an evictable frame from the eviction order and forget its history. */
+  void EraseNode(LRUKNode *node);
+
+  /** Turn the frames prefetched more than replacer_size_ accesses ago into scan-only frames. */
+  void AgePrefetched();
+
+  size_t replacer_size_;
+  size_t k_;
+  /** The histories of all the frames, k timestamps per frame. */
+  std::vector<size_t> history_store_;
+  /** One node per frame, indexed by frame id. */
+  std::vector<LRUKNode> node_store_;
+  /** The evictable frames, ordered by LRUKNode::EvictionKey. */
+  std::set<std::tuple<int, size_t, frame_id_t>> evictable_;
+  /** The timestamps of the prefetch accesses and their frames, oldest first. Entries may be stale. */
+  std::deque<std::pair<size_t, frame_id_t>> prefetched_;
+  size_t current_timestamp_{0};
+  std::mutex latch_;
 };
 
 }  // namespace bustub
@@ -18,11 +18,17 @@
 
 #include "buffer/replacer.h"
 #include "common/config.h"
+#include "common/macros.h"
 
 namespace bustub {
 
 /**
  * LRUReplacer implements the Least Recently Used replacement policy.
+ *
+ * A frame brought in by an AccessType::Scan access is placed at the least recently used end, and scan accesses do not
+ * move a tracked frame, so a sequential scan only recycles its own frames. A frame read ahead of a scan
+ * (AccessType::Prefetch) is placed at the most recently used end instead, so that the next prefetch does not evict it
+ * before the scan gets there.
  */
 class LRUReplacer : public Replacer {
  public:
@@ -32,21 +38,44 @@ class LRUReplacer : public Replacer {
    */
   explicit LRUReplacer(size_t num_pages);
 
+  DISALLOW_COPY_AND_MOVE(LRUReplacer);
+
   /**
    * Destroys the LRUReplacer.
    */
   ~LRUReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
 
-  void Pin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
+  auto GetHotFrames() -> std::vector<frame_id_t> override;
+
  private:
-  // TODO(student): implement me!
+  struct Frame {
+    bool is_tracked_{false};
+    bool is_evictable_{false};
+    /** Position in lru_list_, only valid while the frame is tracked. */
+    std::list<frame_id_t>::iterator pos_;
+  };
+
+  void CheckFrameId(frame_id_t frame_id) const {
+    BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  }
+
+  std::vector<Frame> frames_;
+  /** The tracked frames, least recently used first. */
+  std::list<frame_id_t> lru_list_;
+  /** Number of evictable frames. */
+  size_t curr_size_{0};
+  std::mutex latch_;
 };
 
 }  // namespace bustub
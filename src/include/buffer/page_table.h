@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps the ids of the pages held by a buffer pool to their frames.
+ *
+ * It is an open addressing hash table with linear probing over a fixed array of atomic slots, each packing a page id,
+ * a frame id and a ready bit. Insert, SetReady and Erase must be serialized by the caller (the buffer pool latch),
+ * and so must Find. FindReady takes no lock and may run concurrently with the writers: it only reports entries whose
+ * page has been marked ready, and when it races with a writer it may miss an entry or return one that is being
+ * erased. Lock-free callers must treat its answer as a hint and validate it against the frame.
+ */
+class PageTable {
+ public:
+  /**
+   * @brief Creates a new page table.
+   * @param num_frames the maximum number of entries, i.e. the number of frames of the buffer pool
+   */
+  explicit PageTable(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(PageTable);
+
+  ~PageTable() = default;
+
+  /**
+   * @brief Look up a page, ready or not. Must be serialized with the writers.
+   * @param[out] frame_id the frame holding the page
+   * @return true if the page is in the table
+   */
+  auto Find(page_id_t page_id, frame_id_t *frame_id) const -> bool;
+
+  /**
+   * @brief Look up a page that has been marked ready, without taking any lock.
+   * @param[out] frame_id the frame holding the page
+   * @return true if the page was found ready
+   */
+  auto FindReady(page_id_t page_id, frame_id_t *frame_id) const -> bool;
+
+  /** @brief Map a page to a frame, or remap it if it is already in the table. The entry is not ready. */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /** @brief Mark the entry of a page as ready, making it visible to FindReady. */
+  void SetReady(page_id_t page_id);
+
+  /** @brief Remove the entry of a page, if any. */
+  void Erase(page_id_t page_id);
+
+  /** @return the number of entries */
+  auto Size() const -> size_t { return size_; }
+
+ private:
+  static constexpr uint64_t EMPTY = ~0ULL;
+  /** An erased entry. Probing continues past it, and Insert may reuse it. */
+  static constexpr uint64_t TOMBSTONE = EMPTY - 1;
+  static constexpr uint32_t READY_BIT = 1U << 31;
+
+  static auto Pack(page_id_t page_id, uint32_t value) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | value;
+  }
+  static auto PageOf(uint64_t slot) -> page_id_t { return static_cast<page_id_t>(slot >> 32); }
+  static auto ValueOf(uint64_t slot) -> uint32_t { return static_cast<uint32_t>(slot); }
+
+  auto HomeSlot(page_id_t page_id) const -> size_t;
+
+  /** @return the index of the slot holding page_id, or capacity_ if there is none */
+  auto FindSlot(page_id_t page_id) const -> size_t;
+
+  /** Rewrite every entry without the tombstones. Lock-free readers miss entries while this runs. */
+  void Rehash();
+
+  size_t capacity_;
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  size_t size_{0};
+  size_t tombstones_{0};
+};
+
+}  // namespace bustub
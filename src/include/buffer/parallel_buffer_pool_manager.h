@@ -0,0 +1,182 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards the buffer pool across several independent BufferPoolManager instances. Each
+ * instance has its own page table, free list, replacer and latch, and owns the page ids p with
+ * p % num_instances == instance_index. Since it is a BufferPoolManager itself, it can be handed to TableHeap,
+ * BPlusTree, DiskExtendibleHashTable, etc. without any change on their side.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * @brief Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManager instances to create
+   * @param pool_size the pool size of each BufferPoolManager instance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer of each instance
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of each instance
+   * @param arena_options how the memory of the frames of each instance is allocated
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRUK,
+                            const FrameArenaOptions &arena_options = {});
+
+  /**
+   * @brief Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @brief Return the number of BufferPoolManager instances. */
+  auto GetNumInstances() -> size_t { return instances_.size(); }
+
+  /**
+   * @brief Create a new page. Without a hint, instances are tried round-robin, starting from a different instance on
+   * every call, so that new pages spread evenly across the shards. With one, the instance owning the id after the hint
+   * is tried first, so that pages created one after the other get consecutive ids.
+   * @param[out] page_id id of created page
+   * @param hint a page to place the new one close to, INVALID_PAGE_ID for none
+   * @return nullptr if no instance could create a new page, otherwise pointer to new page
+   */
+  auto NewPageNear(page_id_t *page_id, page_id_t hint) -> Page * override;
+
+  /**
+   * @brief Create a new page in a segment, trying the instances round-robin like NewPageNear without a hint.
+   * @param[out] page_id id of created page
+   * @param segment a segment returned by CreateSegment()
+   * @return nullptr if no instance could create a new page, otherwise pointer to new page
+   */
+  auto NewPageInSegment(page_id_t *page_id, segment_id_t segment) -> Page * override;
+
+  /** @brief Create a segment in the database file the instances share. */
+  auto CreateSegment() -> segment_id_t override { return instances_.front()->CreateSegment(); }
+
+  /**
+   * @brief Fetch the requested page from the instance responsible for it.
+   * @param page_id id of page to be fetched
+   * @param access_type type of access to the page
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page * override;
+
+  /**
+   * @brief Read the requested page optimistically in the instance responsible for it.
+   * @param page_id id of the page to read
+   * @param access_type type of access to the page
+   * @return a guard on the page, or an empty guard if the page has to be fetched the regular way
+   */
+  auto FetchPageOptimistic(page_id_t page_id, AccessType access_type = AccessType::Unknown)
+      -> OptimisticPageGuard override;
+
+  /**
+   * @brief Fetch the pages from the instances responsible for them, as one batch per instance. The reads of every
+   * batch are scheduled before waiting for any of them.
+   * @param page_ids distinct ids of the pages to fetch
+   * @param access_type type of access to the pages
+   * @return the pages, in the order of page_ids, with nullptr for the pages no frame could be found for
+   */
+  auto FetchPages(const std::vector<page_id_t> &page_ids, AccessType access_type = AccessType::Unknown)
+      -> std::vector<Page *> override;
+
+  /**
+   * @brief Unpin the target page in the instance responsible for it.
+   * @param page_id id of page to be unpinned
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @param access_type type of access to the page
+   * @return false if the page is not in the page table or its pin count is <= 0 before this call, true otherwise
+   */
+  auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool override;
+
+  /**
+   * @brief Flush the target page to disk.
+   * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+   * @return false if the page could not be found in the page table, true otherwise
+   */
+  auto FlushPage(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Flush all the pages of every instance to disk.
+   */
+  void FlushAllPages() override;
+
+  /**
+   * @brief Flush every instance, then shrink the database file they share.
+   * @return the number of pages the file shrank by
+   */
+  auto Vacuum() -> size_t override;
+
+  /**
+   * @brief Delete a page from the instance responsible for it.
+   * @param page_id id of page to be deleted
+   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   */
+  auto DeletePage(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Prefetch the target page in the instance responsible for it.
+   * @param page_id id of the page to read ahead
+   * @param evict whether an unpinned page of that instance may be evicted to make room
+   * @return true if a read was scheduled, false if the page is already in the buffer pool or could not be read
+   */
+  auto Prefetch(page_id_t page_id, bool evict = true) -> bool override;
+
+  /** @brief Return how many fetches of the given access type hit, summed over every instance. */
+  auto GetHitCount(AccessType access_type) -> uint64_t override;
+
+  /** @brief Return how many fetches of the given access type missed, summed over every instance. */
+  auto GetMissCount(AccessType access_type) -> uint64_t override;
+
+  /** @brief Return the counters of every instance, summed. */
+  auto GetStats() -> BufferPoolStats override;
+
+  /** @brief Split the compressed page cache evenly among the instances. */
+  void SetCompressedCacheSize(size_t capacity) override;
+
+  /** @brief Start the background writer of every instance. */
+  void StartFlusher(size_t target_clean_percent = FLUSHER_CLEAN_PERCENT) override;
+
+  /** @brief Stop the background writer of every instance. */
+  void StopFlusher() override;
+
+  /** @brief Return the hot pages of every instance, interleaved so that the hottest pages of each come first. */
+  auto GetHotPages() -> std::vector<page_id_t> override;
+
+ private:
+  /**
+   * @brief Get the BufferPoolManager instance responsible for handling the given page id.
+   * @param page_id page id
+   * @return pointer to the BufferPoolManager responsible for handling given page id
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManager *;
+
+  /** The individual buffer pool instances. */
+  std::vector<std::unique_ptr<BufferPoolManager>> instances_;
+  /** The instance NewPage starts searching from. */
+  std::atomic<size_t> next_instance_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.h
+//
+// Identification: src/include/buffer/read_ahead.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ReadAhead follows a scan (a TableIterator walking the table pages, an IndexIterator walking the leaf chain) as it
+ * moves from page to page. Once the scan has moved to the next page id a few times in a row, the pages ahead of it are
+ * likely to be read next, so ReadAhead keeps a window of them prefetched into the buffer pool. A scan that jumps around
+ * resets the pattern and prefetches nothing.
+ */
+class ReadAhead {
+ public:
+  /**
+   * @brief Creates a new ReadAhead.
+   * @param bpm the buffer pool manager the scan fetches its pages from
+   * @param window the number of pages to keep prefetched ahead of the scan, capped at a quarter of the buffer pool
+   */
+  explicit ReadAhead(BufferPoolManager *bpm, size_t window = SCAN_READ_AHEAD_PAGES);
+
+  /**
+   * @brief Tell the read-ahead that the scan has moved on to page_id.
+   * @param page_id the page the scan is about to read
+   */
+  void OnPageChange(page_id_t page_id);
+
+ private:
+  /** Number of consecutive moves to the next page id before read-ahead starts. */
+  static constexpr size_t SEQUENTIAL_THRESHOLD = 2;
+
+  BufferPoolManager *bpm_;
+  size_t window_;
+  /** The page the scan is on. */
+  page_id_t current_page_id_{INVALID_PAGE_ID};
+  /** How many times in a row the scan moved to the next page id. */
+  size_t sequential_moves_{0};
+  /** Every page before this one, up from the start of the sequential run, has already been prefetched. */
+  page_id_t prefetched_until_{INVALID_PAGE_ID};
+};
+
+}  // namespace bustub
@@ -12,12 +12,26 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** Prefetch is the access of a page read ahead of a sequential scan, before the scan gets to it. */
+enum class AccessType { Unknown = 0, Get, Scan, Prefetch };
+
+/** Number of AccessType values, for per access type counters. */
+static constexpr size_t NUM_ACCESS_TYPES = 4;
+
+/** The replacement policies a BufferPoolManager can be configured with. */
+enum class ReplacerType { LRUK = 0, LRU, Clock, TwoQ, ARC };
+
 /**
- * Replacer is an abstract class that tracks page usage.
+ * Replacer is an abstract class that tracks page usage and picks the frame to evict when the buffer pool is full.
+ *
+ * A frame enters the replacer on its first RecordAccess, as non-evictable. The buffer pool marks it evictable once
+ * its pin count drops to zero. Evict and Remove make the replacer forget the frame, until the next RecordAccess.
  */
 class Replacer {
  public:
@@ -25,26 +39,44 @@ class Replacer {
   virtual ~Replacer() = default;
 
   /**
-   * Remove the victim frame as defined by the replacement policy.
-   * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
-   * @return true if a victim frame was found, false otherwise
+   * Pick an evictable frame according to the replacement policy and stop tracking it.
+   * @param[out] frame_id id of the frame that was evicted
+   * @return true if a frame was evicted, false if no frame is evictable
+   */
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
+
+  /**
+   * Record that a frame was accessed, starting to track it if it was not tracked yet.
+   * @param frame_id the id of the accessed frame
+   * @param access_type the type of the access, policies may let AccessType::Scan accesses weigh less
+   * @param page_id the page held by the frame. Policies that remember recently evicted pages use it to recognize a
+   * page coming back; INVALID_PAGE_ID means the page is unknown.
    */
-  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
+  virtual void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                            page_id_t page_id = INVALID_PAGE_ID) = 0;
 
   /**
-   * Pins a frame, indicating that it should not be victimized until it is unpinned.
-   * @param frame_id the id of the frame to pin
+   * Toggle whether a tracked frame may be evicted. Does nothing for a frame that is not tracked.
+   * @param frame_id the id of the frame
+   * @param set_evictable whether the frame may be evicted
    */
-  virtual void Pin(frame_id_t frame_id) = 0;
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
 
   /**
-   * Unpins a frame, indicating that it can now be victimized.
-   * @param frame_id the id of the frame to unpin
+   * Stop tracking an evictable frame, regardless of its position in the eviction order. Does nothing for a frame that
+   * is not tracked, and throws for a frame that is not evictable.
+   * @param frame_id the id of the frame to remove
    */
-  virtual void Unpin(frame_id_t frame_id) = 0;
+  virtual void Remove(frame_id_t frame_id) = 0;
 
-  /** @return the number of elements in the replacer that can be victimized */
+  /** @return the number of evictable frames */
   virtual auto Size() -> size_t = 0;
+
+  /**
+   * @return every tracked frame, evictable or not, in the reverse of the eviction order: the frame the policy would
+   * keep the longest comes first. Used to persist the hot set of the buffer pool across restarts.
+   */
+  virtual auto GetHotFrames() -> std::vector<frame_id_t> = 0;
 };
 
 }  // namespace bustub
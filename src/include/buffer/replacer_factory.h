@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_factory.h
+//
+// Identification: src/include/buffer/replacer_factory.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "buffer/replacer.h"
+
+namespace bustub {
+
+/**
+ * ReplacerFactory creates the replacer of a buffer pool for a given replacement policy.
+ */
+class ReplacerFactory {
+ public:
+  /**
+   * Creates a new replacer.
+   * @param type the replacement policy
+   * @param num_frames the number of frames the replacer tracks
+   * @param k the lookback constant, only used by the LRU-K replacer
+   * @return a replacer implementing the given policy
+   */
+  static auto CreateReplacer(ReplacerType type, size_t num_frames, size_t k) -> std::unique_ptr<Replacer>;
+
+  /**
+   * Parses the name of a replacement policy: lruk, lru, clock, 2q or arc.
+   * @return the policy, or std::nullopt if the name is unknown
+   */
+  static auto ParseReplacerType(const std::string &name) -> std::optional<ReplacerType>;
+};
+
+}  // namespace bustub
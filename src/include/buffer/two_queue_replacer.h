@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.h
+//
+// Identification: src/include/buffer/two_queue_replacer.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TwoQueueReplacer implements the full version of the 2Q replacement policy (Johnson and Shasha, VLDB 1994).
+ *
+ * A frame seen for the first time enters A1in, a FIFO queue of about a quarter of the pool. Frames evicted from A1in
+ * leave their page id in A1out, a ghost FIFO of about half the pool. A page that comes back while it is still in
+ * A1out has been referenced twice in a short while and goes straight to Am, an LRU queue holding the hot set. Pages
+ * touched only once, such as the pages of a sequential scan, never make it out of A1in.
+ *
+ * AccessType::Scan and AccessType::Prefetch accesses never promote a page to Am.
+ */
+class TwoQueueReplacer : public Replacer {
+ public:
+  /**
+   * Create a new TwoQueueReplacer.
+   * @param num_frames the number of frames the replacer tracks
+   */
+  explicit TwoQueueReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(TwoQueueReplacer);
+
+  ~TwoQueueReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto GetHotFrames() -> std::vector<frame_id_t> override;
+
+ private:
+  enum class Queue { None, A1In, Am };
+
+  struct Frame {
+    Queue queue_{Queue::None};
+    bool is_evictable_{false};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    /** Position in the queue of the frame, only valid while queue_ is not Queue::None. */
+    std::list<frame_id_t>::iterator pos_;
+  };
+
+  void CheckFrameId(frame_id_t frame_id) const {
+    BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  }
+
+  /** @return the first evictable frame of the queue, oldest first */
+  auto FindVictim(const std::list<frame_id_t> &queue) const -> std::optional<frame_id_t>;
+
+  /** Take a frame out of its queue and forget it. */
+  void EraseFrame(frame_id_t frame_id);
+
+  /** Remember a page evicted from A1in, forgetting the oldest ghost when A1out is full. */
+  void AddGhost(page_id_t page_id);
+
+  std::vector<Frame> frames_;
+  /** Frames referenced once, oldest first. */
+  std::list<frame_id_t> a1in_;
+  /** Frames referenced again after their page went through A1out, least recently used first. */
+  std::list<frame_id_t> am_;
+  /** Pages recently evicted from A1in, oldest first, and their position in the list. */
+  std::list<page_id_t> a1out_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> a1out_index_;
+  /** Target size of A1in, the queue is evicted from first once it grows larger. */
+  size_t kin_;
+  /** Capacity of A1out. */
+  size_t kout_;
+  /** Number of evictable frames. */
+  size_t curr_size_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
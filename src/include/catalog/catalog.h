@@ -136,7 +136,8 @@ class Catalog {
     // When create_table_heap == false, it means that we're running binder tests (where no txn will be provided) or
     // we are running shell without buffer pool. We don't need to create TableHeap in this case.
     if (create_table_heap) {
-      table = std::make_unique<TableHeap>(bpm_);
+      // Every table gets a segment of the database file, so that its pages are laid out contiguously.
+      table = std::make_unique<TableHeap>(bpm_, bpm_->CreateSegment());
     }
 
     // Fetch the table OID for the new table
@@ -226,14 +227,20 @@ class Catalog {
     // just the key, value, and comparator types
 
     // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                      bpm_->CreateSegment());
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap. The entries are sorted and the tree is built bottom-up, which
+    // is much faster than inserting them one by one.
     auto *table_meta = GetTable(table_name);
+    auto builder = index->MakeBuilder();
     for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
       auto [meta, tuple] = iter.GetTuple();
-      index->InsertEntry(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid(), txn);
+      KeyType index_key;
+      index_key.SetFromKey(tuple.KeyFromTuple(schema, key_schema, key_attrs), key_schema, tuple.GetRid());
+      builder.Add(index_key, tuple.GetRid());
     }
+    builder.Finish();
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
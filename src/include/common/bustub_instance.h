@@ -27,6 +27,7 @@
 #include "common/util/string_util.h"
 #include "execution/check_options.h"
 #include "libfort/lib/fort.hpp"
+#include "storage/disk/disk_manager.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -46,6 +47,7 @@ class CreateStatement;
 class IndexStatement;
 class VariableSetStatement;
 class VariableShowStatement;
+class VacuumStatement;
 class ExplainStatement;
 
 class ResultWriter {
@@ -210,6 +212,29 @@ class FortTableWriter : public ResultWriter {
   std::vector<std::string> tables_;
 };
 
+/** Settings of a BusTub instance. */
+struct BustubOptions {
+  /** How the database file is read and written, ignored by an in-memory instance. */
+  DiskIOBackend disk_io_backend_{DiskIOBackend::FStream};
+  /** The page size of a new database, see IsValidPageSize(). An existing database keeps the one it was created with. */
+  size_t page_size_{BUSTUB_PAGE_SIZE};
+  /** The number of frames of the buffer pool. GenerateTestTable needs more than BUFFER_POOL_SIZE. */
+  size_t buffer_pool_size_{128};
+  /** The size of the log buffer in bytes. */
+  size_t log_buffer_size_{LOG_BUFFER_SIZE};
+  /**
+   * Whether a database file is opened with the pages that were hot when it was last shut down already in the buffer
+   * pool. The hot set is saved next to the database file in any case, and read back in the background.
+   */
+  bool warm_up_{true};
+  /** The maximum rate at which the warm-up reads pages, 0 for no limit. */
+  size_t warm_up_pages_per_second_{0};
+  /** The bytes of memory for compressed copies of pages evicted from the buffer pool, 0 for none. */
+  size_t compressed_cache_size_{0};
+  /** The optional features of a new database file, and whether its writes go through a double-write buffer. */
+  DbFileOptions db_file_options_{true, false};
+};
+
 class BustubInstance {
  private:
   /**
@@ -218,10 +243,29 @@ class BustubInstance {
   auto MakeExecutorContext(Transaction *txn, bool is_modify) -> std::unique_ptr<ExecutorContext>;
 
  public:
-  explicit BustubInstance(const std::string &db_file_name);
+  /**
+   * Create a BusTub instance backed by the given database file.
+   * @param db_file_name the database file
+   * @param disk_io_backend how the database file is read and written
+   */
+  explicit BustubInstance(const std::string &db_file_name, DiskIOBackend disk_io_backend = DiskIOBackend::FStream);
 
+  /**
+   * Create a BusTub instance backed by the given database file.
+   * @param db_file_name the database file
+   * @param options the settings of the instance
+   */
+  BustubInstance(const std::string &db_file_name, const BustubOptions &options);
+
+  /** Create a BusTub instance whose database lives in memory. */
   BustubInstance();
 
+  /**
+   * Create a BusTub instance whose database lives in memory.
+   * @param options the settings of the instance
+   */
+  explicit BustubInstance(const BustubOptions &options);
+
   ~BustubInstance();
 
   /**
@@ -278,6 +322,7 @@ class BustubInstance {
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
+  void CmdDisplayBufferPoolStats(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
 
@@ -286,8 +331,12 @@ class BustubInstance {
   void HandleExplainStatement(Transaction *txn, const ExplainStatement &stmt, ResultWriter &writer);
   void HandleVariableShowStatement(Transaction *txn, const VariableShowStatement &stmt, ResultWriter &writer);
   void HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt, ResultWriter &writer);
+  void HandleVacuumStatement(Transaction *txn, const VacuumStatement &stmt, ResultWriter &writer);
 
   std::unordered_map<std::string, std::string> session_variables_;
+
+  /** Where the hot set of the buffer pool is saved, empty for an in-memory instance. */
+  std::string hot_set_file_;
 };
 
 }  // namespace bustub
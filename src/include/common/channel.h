@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// channel.h
+//
+// Identification: src/include/common/channel.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * Channels allow for safe sharing of data between threads. This is a multi-producer multi-consumer channel.
+ */
+template <class T>
+class Channel {
+ public:
+  Channel() = default;
+  ~Channel() = default;
+
+  /**
+   * @brief Inserts an element into a shared queue.
+   *
+   * @param element The element to be inserted.
+   */
+  void Put(T element) {
+    std::unique_lock<std::mutex> lk(m_);
+    q_.push(std::move(element));
+    lk.unlock();
+    cv_.notify_all();
+  }
+
+  /**
+   * @brief Gets an element from the shared queue. If the queue is empty, blocks until an element is available.
+   */
+  auto Get() -> T {
+    std::unique_lock<std::mutex> lk(m_);
+    cv_.wait(lk, [&]() { return !q_.empty(); });
+    T element = std::move(q_.front());
+    q_.pop();
+    return element;
+  }
+
+  /**
+   * @brief Moves every element of the shared queue into batch, in insertion order. If the queue is empty, blocks
+   * until an element is available. Draining the whole queue at once takes the channel lock once per batch instead of
+   * once per element.
+   *
+   * @param[out] batch The elements taken from the queue are appended to it.
+   */
+  void GetAll(std::vector<T> *batch) {
+    std::unique_lock<std::mutex> lk(m_);
+    cv_.wait(lk, [&]() { return !q_.empty(); });
+    while (!q_.empty()) {
+      batch->push_back(std::move(q_.front()));
+      q_.pop();
+    }
+  }
+
+ private:
+  std::mutex m_;
+  std::condition_variable cv_;
+  std::queue<T> q_;
+};
+}  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
 
 namespace bustub {
@@ -28,22 +29,46 @@ extern std::atomic<bool> enable_logging;
 extern std::chrono::duration<int64_t> log_timeout;
 
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
+static constexpr int INVALID_SEGMENT_ID = -1;                                        // invalid segment id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
-static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // default and smallest page size
+static constexpr int BUSTUB_MAX_PAGE_SIZE = 65536;                                   // largest page size in byte
+static constexpr int BUSTUB_PAGE_ALIGNMENT = 4096;                                   // frame alignment for O_DIRECT
+static constexpr int BUSTUB_CACHE_LINE_SIZE = 64;                                    // alignment against false sharing
 static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
+static constexpr int DISK_SCHEDULER_NUM_WORKERS = 4;                                 // I/O threads per disk scheduler
+static constexpr int URING_QUEUE_DEPTH = 128;                                        // max io_uring requests in flight
+static constexpr int SCAN_READ_AHEAD_PAGES = 8;                                      // read-ahead window of a scan
+static constexpr int TUPLE_FETCH_BATCH_PAGES = 16;                                   // max heap pages per tuple batch
+static constexpr int FLUSHER_CLEAN_PERCENT = 25;                                     // % of frames kept clean
+static constexpr int FLUSHER_INTERVAL_MS = 10;                                       // wake-up interval of the flusher
+static constexpr int FLUSHER_BATCH_PAGES = 16;                                       // max flusher writes in flight
+static constexpr int WARM_UP_BATCH_PAGES = 32;                                       // pages read per warm-up batch
+static constexpr int COMPRESSED_CACHE_MAX_PERCENT = 75;                              // cap on compressed size, in %
+static constexpr int PAGE_CHECKSUM_SIZE = 8;                                         // checksum bytes at end of a page
+static constexpr int DOUBLE_WRITE_BUFFER_PAGES = 64;                                 // slots of a double-write buffer
+static constexpr int EXTENT_PAGES = 8;                                               // pages a segment grows by
+static constexpr int BULK_LOAD_MEMORY_BYTES = 64 << 20;                              // sort memory of a bulk load
+static constexpr int BULK_LOAD_FILL_PERCENT = 90;                                    // % of a page a bulk load fills
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
+using segment_id_t = int32_t;  // segment id type
 using txn_id_t = int32_t;      // transaction id type
 using lsn_t = int32_t;         // log sequence number type
 using slot_offset_t = size_t;  // slot offset type
 using oid_t = uint16_t;
 
+/** @return true if a database can be created with pages of page_size bytes: a power of two from 4KB to 64KB */
+constexpr auto IsValidPageSize(size_t page_size) -> bool {
+  return page_size >= BUSTUB_PAGE_SIZE && page_size <= BUSTUB_MAX_PAGE_SIZE && (page_size & (page_size - 1)) == 0;
+}
+
 static constexpr int VARCHAR_DEFAULT_LENGTH = 128;  // default length for varchar when constructing the column
 
 }  // namespace bustub
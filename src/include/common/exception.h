@@ -49,6 +49,10 @@ enum class ExceptionType {
   NOT_IMPLEMENTED = 11,
   /** Execution exception. */
   EXECUTION = 12,
+  /** Data read from disk is corrupt. */
+  CORRUPTION = 13,
+  /** Reading from disk failed. */
+  IO = 14,
 };
 
 class Exception : public std::runtime_error {
@@ -109,6 +113,10 @@ class Exception : public std::runtime_error {
         return "Out of Memory";
       case ExceptionType::NOT_IMPLEMENTED:
         return "Not implemented";
+      case ExceptionType::CORRUPTION:
+        return "Corruption";
+      case ExceptionType::IO:
+        return "I/O";
       default:
         return "Unknown";
     }
@@ -130,4 +138,25 @@ class ExecutionException : public Exception {
   explicit ExecutionException(const std::string &msg) : Exception(ExceptionType::EXECUTION, msg, false) {}
 };
 
+/** A page read from disk failed its checksum. */
+class PageCorruptionException : public Exception {
+ public:
+  PageCorruptionException() = delete;
+  PageCorruptionException(int32_t page_id, const std::string &msg)
+      : Exception(ExceptionType::CORRUPTION, msg), page_id_(page_id) {}
+
+  /** @return the id of the corrupt page */
+  auto GetPageId() const -> int32_t { return page_id_; }
+
+ private:
+  int32_t page_id_;
+};
+
+/** A page could not be read from disk. */
+class IOException : public Exception {
+ public:
+  IOException() = delete;
+  explicit IOException(const std::string &msg) : Exception(ExceptionType::IO, msg) {}
+};
+
 }  // namespace bustub
@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// metrics.h
+//
+// Identification: src/include/common/metrics.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstddef>
+#include <cstdint>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/** Number of stripes of every metric. Threads are spread over them, so that they rarely share a cache line. */
+static constexpr size_t METRIC_STRIPES = 16;
+
+/**
+ * @return the stripe of the calling thread, in [0, METRIC_STRIPES). Threads are assigned stripes round-robin, in the
+ * order they first ask for one.
+ */
+auto ThreadStripe() -> size_t;
+
+/**
+ * A counter that any thread can bump without taking a lock or bouncing a shared cache line: every thread adds to its
+ * own stripe, and reading the counter sums the stripes. Reads are not a consistent snapshot across counters.
+ */
+class StripedCounter {
+ public:
+  StripedCounter() = default;
+
+  DISALLOW_COPY_AND_MOVE(StripedCounter);
+
+  ~StripedCounter() = default;
+
+  void Add(uint64_t n = 1) { stripes_[ThreadStripe()].value_.fetch_add(n, std::memory_order_relaxed); }
+
+  /** @return the sum of everything added so far */
+  auto Get() const -> uint64_t;
+
+ private:
+  struct alignas(64) Stripe {
+    std::atomic<uint64_t> value_{0};
+  };
+
+  std::array<Stripe, METRIC_STRIPES> stripes_;
+};
+
+/**
+ * A histogram of latencies with power of two buckets in microseconds, striped like StripedCounter. Bucket 0 counts
+ * latencies under 1us, bucket i > 0 the ones in [2^(i-1), 2^i) us, and the last bucket everything above.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr size_t NUM_BUCKETS = 24;
+
+  /** The content of a histogram at some point in time. */
+  struct Snapshot {
+    std::array<uint64_t, NUM_BUCKETS> buckets_{};
+    uint64_t count_{0};
+    uint64_t total_ns_{0};
+
+    auto operator+=(const Snapshot &other) -> Snapshot &;
+
+    /** @return the mean latency in microseconds, 0 if nothing was recorded */
+    auto MeanMicros() const -> double;
+
+    /**
+     * @return an upper bound of the given percentile in microseconds, i.e. the upper end of the bucket it falls in
+     * @param percentile between 0 and 100
+     */
+    auto PercentileMicros(double percentile) const -> uint64_t;
+  };
+
+  LatencyHistogram() = default;
+
+  DISALLOW_COPY_AND_MOVE(LatencyHistogram);
+
+  ~LatencyHistogram() = default;
+
+  void Record(std::chrono::nanoseconds latency);
+
+  auto GetSnapshot() const -> Snapshot;
+
+ private:
+  struct alignas(64) Stripe {
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets_{};
+    std::atomic<uint64_t> total_ns_{0};
+  };
+
+  std::array<Stripe, METRIC_STRIPES> stripes_;
+};
+
+/** Records the time from its construction to its destruction into a histogram. */
+class ScopedLatency {
+ public:
+  explicit ScopedLatency(LatencyHistogram *histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+  DISALLOW_COPY_AND_MOVE(ScopedLatency);
+
+  ~ScopedLatency() { histogram_->Record(std::chrono::steady_clock::now() - start_); }
+
+ private:
+  LatencyHistogram *histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace bustub
@@ -44,6 +44,12 @@ class ReaderWriterLatch {
    */
   void RUnlock() { mutex_.unlock_shared(); }
 
+  /**
+   * Try to acquire a read latch without blocking.
+   * @return true if the latch was acquired
+   */
+  auto TryRLock() -> bool { return mutex_.try_lock_shared(); }
+
  private:
   std::shared_mutex mutex_;
 };
@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.h
+//
+// Identification: src/include/common/util/compression_util.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * CompressionUtil is a small, fast LZ77 codec in the style of the LZ4 block format, meant for whole pages: it favors
+ * speed over ratio, and finds the long runs of zeros and repeated tuples that pages are made of.
+ *
+ * A block is a sequence of (literals, match) pairs. Each starts with a token byte holding the number of literals in
+ * its high nibble and the match length minus 4 in its low nibble, a nibble of 15 being continued by bytes that are
+ * added to it until one is not 255. The literals follow, then the 2-byte little-endian distance back to the match and
+ * the continuation of its length. The last pair has literals only.
+ */
+class CompressionUtil {
+ public:
+  /**
+   * @brief Compress a buffer, replacing the content of out.
+   * @return the compressed size; it can be slightly larger than size for incompressible data
+   */
+  static auto Compress(const char *src, size_t size, std::vector<char> *out) -> size_t;
+
+  /**
+   * @brief Decompress a block written by Compress.
+   * @param dst buffer of the size of the original data
+   * @param dst_size the size of the original data
+   * @return false if the block is malformed or does not decompress to exactly dst_size bytes
+   */
+  static auto Decompress(const char *src, size_t src_size, char *dst, size_t dst_size) -> bool;
+};
+
+}  // namespace bustub
@@ -0,0 +1,41 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// crc32c_util.h
+//
+// Identification: src/include/common/util/crc32c_util.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bustub {
+
+/**
+ * Crc32cUtil computes CRC-32C (Castagnoli), the checksum of iSCSI, ext4 and most storage engines. On x86-64 CPUs with
+ * SSE4.2 it uses the crc32 instruction on three interleaved streams, which runs at a few bytes per cycle; elsewhere it
+ * falls back to a table driven implementation.
+ */
+class Crc32cUtil {
+ public:
+  /**
+   * @brief Compute the CRC-32C of a buffer.
+   * @param crc the CRC of the data before this buffer, to checksum data in pieces; 0 to start
+   * @return the CRC of everything so far
+   */
+  static auto Checksum(const char *data, size_t size, uint32_t crc = 0) -> uint32_t;
+
+  /** @brief Same as Checksum, but never uses the hardware instruction. */
+  static auto ChecksumPortable(const char *data, size_t size, uint32_t crc = 0) -> uint32_t;
+
+  /** @return true if Checksum uses the hardware instruction */
+  static auto IsHardwareAccelerated() -> bool;
+};
+
+}  // namespace bustub
@@ -27,9 +27,13 @@ namespace bustub {
  */
 class LogRecovery {
  public:
-  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager)
-      : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), offset_(0) {
-    log_buffer_ = new char[LOG_BUFFER_SIZE];
+  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager,
+              size_t log_buffer_size = LOG_BUFFER_SIZE)
+      : disk_manager_(disk_manager),
+        buffer_pool_manager_(buffer_pool_manager),
+        offset_(0),
+        log_buffer_size_(log_buffer_size) {
+    log_buffer_ = new char[log_buffer_size_];
   }
 
   ~LogRecovery() {
@@ -51,6 +55,8 @@ class LogRecovery {
   std::unordered_map<lsn_t, int> lsn_mapping_;
 
   int offset_ __attribute__((__unused__));  // NOLINT
+  /** The size of log_buffer_ in bytes, the same as the log buffer of the LogManager that wrote the log. */
+  const size_t log_buffer_size_ __attribute__((__unused__));
   char *log_buffer_;
 };
 
@@ -15,34 +15,104 @@
 #include <atomic>
 #include <fstream>
 #include <future>  // NOLINT
-#include <mutex>   // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "common/config.h"
+#include "common/metrics.h"
 
 namespace bustub {
 
+/** The I/O backend used for the database file, see BustubInstance. */
+enum class DiskIOBackend {
+  /** DiskManager: a std::fstream serialized by a latch. */
+  FStream = 0,
+  /** DiskManagerPosix: positional pread/pwrite on a file descriptor. */
+  Pread,
+  /** DiskManagerPosix with O_DIRECT, bypassing the OS page cache. */
+  PreadDirect,
+  /** DiskManagerUring: batched io_uring submission with a completion thread, falls back to Pread. */
+  Uring,
+};
+
+/** Size of the header at the start of a database file. Pages follow it, so it keeps them aligned for O_DIRECT. */
+static constexpr size_t DB_FILE_HEADER_SIZE = BUSTUB_PAGE_ALIGNMENT;
+
+/** Optional features of a database file, see DiskManager. */
+struct DbFileOptions {
+  /** Whether a new database file keeps a checksum in every page. An existing file keeps what it was created with. */
+  bool checksums_{false};
+  /**
+   * Whether pages are written to a double-write buffer file before they are written in place, so that a write torn by
+   * a crash can be repaired when the database is opened again. Needs a backend that syncs, i.e. not FStream.
+   */
+  bool double_write_{false};
+};
+
+class DoubleWriteBuffer;
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * The page size is a property of the database. It is chosen when the database file is created and recorded in the
+ * file header; opening an existing file uses the page size stored there. A file without a header, written before
+ * there was one, is opened as it was written: 4KB pages from the start of the file, without checksums.
+ *
+ * So is whether pages carry a checksum. If they do, the last PAGE_CHECKSUM_SIZE bytes of every page belong to the disk
+ * manager: writes stamp the CRC-32C of the page and its id there, and reads verify it and throw
+ * PageCorruptionException on a mismatch, which catches torn and misdirected writes as well as bit rot. Page layouts
+ * must stay within GetUsablePageSize(). A page of zeros (never written, or past the end of the file) is valid.
+ *
+ * Before a database file is opened, pages left in its double-write buffer by a crash are written back in place.
+ *
+ * A page that cannot be read throws IOException, so that a failed read is never mistaken for page contents. Write and
+ * sync errors are logged instead of thrown: writes run on the disk scheduler's workers and the background writer,
+ * which have no caller to throw to, and by the time the write-back of an evicted page fails its frame already holds
+ * another page. The previous version of the page stays on disk; with checksums, a write cut short fails its checksum
+ * when the page is read back.
+ *
+ * Page ids are handed out by AllocatePage(), which reuses the pages given back with DeallocatePage() before growing the
+ * file. The free pages form the free-space map, which is saved in free pages of the file itself by
+ * SaveFreeSpaceMap(); the file header points to it. The saved map is dropped from the header the first time one of
+ * its pages is reused, so a crash can leak the pages freed since the last save but never hand out a page twice.
+ *
+ * Each table and index lives in a segment of the file, created with CreateSegment(). A segment grows by extents of
+ * EXTENT_PAGES contiguous, aligned pages, and its pages are only allocated from its own extents, so that a scan of it
+ * reads the file in long sequential runs. The extents of a segment are reserved while the process runs; like the
+ * catalog, the extent map is not persisted, and after a restart the unused pages of the extents are plain free pages.
  */
 class DiskManager {
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param page_size the page size of the database if the file is created, see IsValidPageSize()
+   * @param options the features of the database if the file is created; FStream ignores double_write_
+   * @throws Exception if the page size is invalid or the file is not a database file
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, size_t page_size = BUSTUB_PAGE_SIZE,
+                       const DbFileOptions &options = {});
 
   /** FOR TEST / LEADERBOARD ONLY, used by DiskManagerMemory */
-  DiskManager() = default;
+  explicit DiskManager(size_t page_size = BUSTUB_PAGE_SIZE);
 
-  virtual ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
+
+  /**
+   * Make all the pages written so far durable. Callers issue this explicitly at durability points (e.g. after
+   * flushing the buffer pool) instead of paying for a sync on every write.
+   */
+  virtual void Sync();
 
   /**
    * Write a page to the database file.
@@ -55,9 +125,47 @@ class DiskManager {
    * Read a page from the database file.
    * @param page_id id of the page
    * @param[out] page_data output buffer
+   * @throws PageCorruptionException if the page fails its checksum
+   * @throws IOException if the page cannot be read
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Start writing a page to the database file. page_data must stay valid until the callback is fulfilled. Requests on
+   * the same page complete in the order they were issued. The request may be held back until SubmitPageRequests() is
+   * called. The default implementation writes synchronously.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   * @param callback fulfilled with true once the page is written
+   */
+  virtual void WritePageAsync(page_id_t page_id, const char *page_data, std::promise<bool> callback);
+
+  /**
+   * Start reading a page from the database file, see WritePageAsync(). The default implementation reads synchronously.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   * @param callback fulfilled with true once page_data holds the page, or with the exception ReadPage() would throw
+   */
+  virtual void ReadPageAsync(page_id_t page_id, char *page_data, std::promise<bool> callback);
+
+  /**
+   * Hand every request started with WritePageAsync()/ReadPageAsync() and not yet submitted to the device.
+   */
+  virtual void SubmitPageRequests() {}
+
+  /**
+   * Tell the disk manager which memory areas will be used as page buffers (e.g. the frames of a buffer pool), so it
+   * can prepare them for I/O. They must stay valid until UnregisterPageBuffers() is called.
+   * @param buffers the page buffers, each GetPageSize() bytes long
+   */
+  virtual void RegisterPageBuffers(const std::vector<char *> &buffers) {}
+
+  /**
+   * Forget page buffers previously passed to RegisterPageBuffers().
+   * @param buffers the page buffers
+   */
+  virtual void UnregisterPageBuffers(const std::vector<char *> &buffers) {}
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -74,6 +182,69 @@ class DiskManager {
    */
   auto ReadLog(char *log_data, int size, int offset) -> bool;
 
+  /** @return the size of the pages of the database in bytes */
+  auto GetPageSize() const -> size_t { return page_size_; }
+
+  /** @return the number of bytes at the start of every page that page layouts may use */
+  auto GetUsablePageSize() const -> size_t { return page_size_ - (checksums_ ? PAGE_CHECKSUM_SIZE : 0); }
+
+  /** @return true if the pages of the database carry a checksum */
+  auto HasChecksums() const -> bool { return checksums_; }
+
+  /** @return the number of pages in the database file, counting a partially written last page; 0 without a file */
+  auto GetNumPages() -> size_t;
+
+  /**
+   * Allocate a page id. A free page is reused if there is one, the closest to hint, otherwise the file grows by a page.
+   * @param hint a page the new one will be accessed together with, e.g. the page it is split from. Without one, the
+   * lowest free page is reused, so that the end of the file empties out and Vacuum() can cut it off.
+   * @param stride only ids p with p % stride == residue are handed out, for buffer pool instances that each own a
+   * share of the page ids. The ids skipped to reach one become free pages for the other instances.
+   * @param residue see stride
+   * @param segment the segment to allocate the page in, which grows by an extent when it has no free page left. By
+   * default, the segment of the hint; without either, the page is taken outside of every segment.
+   * @return the id of the page
+   */
+  auto AllocatePage(page_id_t hint = INVALID_PAGE_ID, uint32_t stride = 1, uint32_t residue = 0,
+                    segment_id_t segment = INVALID_SEGMENT_ID) -> page_id_t;
+
+  /**
+   * Give a page back to the free-space map. Its content on disk is left alone until the page is reused.
+   * @param page_id id of a page returned by AllocatePage()
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  /** @return true if page_id was allocated, or was in the file when it was opened, and has not been freed since */
+  auto IsAllocated(page_id_t page_id) -> bool;
+
+  /** @return the id of a new, empty segment, see AllocatePage() */
+  auto CreateSegment() -> segment_id_t;
+
+  /** @return the segment whose extents hold page_id, INVALID_SEGMENT_ID for a page outside of every segment */
+  auto GetSegment(page_id_t page_id) -> segment_id_t;
+
+  /** @return the first page of every extent of segment, in ascending order */
+  auto GetSegmentExtents(segment_id_t segment) -> std::vector<page_id_t>;
+
+  /** @return the free pages, in ascending order */
+  auto GetFreePages() -> std::vector<page_id_t>;
+
+  /**
+   * Save the free-space map in the database file and make it durable. Only the given pages are saved, those that are
+   * still free: the caller passes the pages that were free before it flushed the buffer pool, since a page must not
+   * be saved as free while a page pointing to it may still be stale on disk.
+   * @param free_pages the pages to save, see GetFreePages()
+   */
+  void SaveFreeSpaceMap(const std::vector<page_id_t> &free_pages);
+
+  /**
+   * Cut the free pages at the end of the database file off, then save the free-space map like SaveFreeSpaceMap(). As
+   * there, only the given pages are considered free.
+   * @param free_pages the pages that were free before the buffer pool was flushed, see GetFreePages()
+   * @return the number of pages the file shrank by
+   */
+  auto Vacuum(const std::vector<page_id_t> &free_pages) -> size_t;
+
   /** @return the number of disk flushes */
   auto GetNumFlushes() const -> int;
 
@@ -83,6 +254,12 @@ class DiskManager {
   /** @return the number of disk writes */
   auto GetNumWrites() const -> int;
 
+  /** @return the latencies of the page reads served so far */
+  auto GetReadLatency() const -> LatencyHistogram::Snapshot { return read_latency_.GetSnapshot(); }
+
+  /** @return the latencies of the page writes served so far */
+  auto GetWriteLatency() const -> LatencyHistogram::Snapshot { return write_latency_.GetSnapshot(); }
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -93,7 +270,94 @@ class DiskManager {
   inline auto HasFlushLogFuture() -> bool { return flush_log_f_ != nullptr; }
 
  protected:
-  auto GetFileSize(const std::string &file_name) -> int;
+  /** @return the size of the file in bytes, -1 if it does not exist */
+  auto GetFileSize(const std::string &file_name) -> int64_t;
+  /**
+   * Derive the log file name from file_name_ and open (or create) the log file.
+   * @return false if file_name_ has no extension, in which case no log file is opened
+   */
+  auto OpenLogFile() -> bool;
+  /**
+   * Write the header of file_name_ if the file is new, otherwise read the page size and the features from it. Then
+   * write back the pages left in the double-write buffer of the file, if any.
+   * @throws Exception if the file exists but does not start with a database file header
+   */
+  void LoadFileHeader(const DbFileOptions &options);
+  /** @return the name of the double-write buffer file of file_name_ */
+  auto DoubleWriteFileName() const -> std::string;
+  /**
+   * @return the bytes to write for a page: page_data itself, or a copy with the checksum stamped into it. The copy is
+   * aligned for O_DIRECT and belongs to the calling thread, see ScratchBuffer().
+   */
+  auto PrepareWrite(page_id_t page_id, const char *page_data) const -> const char *;
+  /** Stamp the checksum of a page into its last PAGE_CHECKSUM_SIZE bytes. */
+  void StampChecksum(page_id_t page_id, char *page_data) const;
+  /**
+   * Check the checksum of a page that was just read.
+   * @throws PageCorruptionException if it does not match and the page is not all zeros
+   */
+  void VerifyChecksum(page_id_t page_id, const char *page_data) const;
+  /** @return a buffer of BUSTUB_MAX_PAGE_SIZE bytes aligned for O_DIRECT, one per thread */
+  static auto ScratchBuffer() -> char *;
+  /**
+   * Read the free-space map saved in the file, once the file header points to it. A map that fails its checks (e.g.
+   * because a crash cut a save short) is ignored, its pages stay allocated.
+   */
+  void LoadFreeSpaceMap(int fd, page_id_t first_map_page, uint32_t num_free_pages);
+  /** Write the pages of free_pages that are still free as the saved free-space map. free_pages_latch_ must be held. */
+  void WriteFreeSpaceMap(int fd, const std::vector<page_id_t> &free_pages);
+  /** Point the file header to a saved free-space map, INVALID_PAGE_ID for none, and sync it. */
+  auto WriteFreeSpaceMapHeader(int fd, page_id_t first_map_page, uint32_t num_free_pages) -> bool;
+  /** @return the segment of page_id, see GetSegment(). free_pages_latch_ must be held. */
+  auto SegmentOf(page_id_t page_id) const -> segment_id_t;
+  /** @return the free pages of segment, free_pages_ for INVALID_SEGMENT_ID. free_pages_latch_ must be held. */
+  auto FreePagesOf(segment_id_t segment) -> std::set<page_id_t> &;
+  /** @return true if page_id is free. free_pages_latch_ must be held. */
+  auto IsFree(page_id_t page_id) -> bool { return FreePagesOf(SegmentOf(page_id)).count(page_id) != 0; }
+  /** @return the page of pages with p % stride == residue closest to target, INVALID_PAGE_ID if there is none */
+  static auto FindFreePage(const std::set<page_id_t> &pages, page_id_t target, uint32_t stride, uint32_t residue)
+      -> page_id_t;
+  /**
+   * Give segment a new extent: the lowest extent of free pages outside of every segment, or a new one at the end of
+   * the file. free_pages_latch_ must be held.
+   * @return the first page of the extent
+   */
+  auto AddExtent(segment_id_t segment) -> page_id_t;
+  /** @return the offset of a page in the database file */
+  auto PageOffset(page_id_t page_id) const -> size_t {
+    return header_size_ + static_cast<size_t>(page_id) * page_size_;
+  }
+  /** Size of the pages of the database in bytes. */
+  size_t page_size_;
+  /** Whether the pages of the database carry a checksum, recorded in the file header. */
+  bool checksums_{false};
+  /** The double-write buffer, if page writes go through one. */
+  std::unique_ptr<DoubleWriteBuffer> double_write_;
+  /** Whether the manager is backed by a database file with a header, where the free-space map can be saved. */
+  bool has_file_header_{false};
+  /** Where the pages start in the database file: after the header, or at 0 in a file without one. */
+  size_t header_size_{DB_FILE_HEADER_SIZE};
+  /**
+   * The pages outside of every segment that were deallocated and not reused since, ordered so that AllocatePage() can
+   * search around a hint.
+   */
+  std::set<page_id_t> free_pages_;
+  /** One past the highest page id ever allocated, starting with the number of pages in the file. */
+  page_id_t next_page_id_{0};
+  /** Whether the file header points to a saved free-space map, which must be dropped before a free page is reused. */
+  bool free_space_map_saved_{false};
+  struct Segment {
+    /** The first page of each extent of the segment. */
+    std::set<page_id_t> extents_;
+    /** The pages of the extents that are not allocated, like free_pages_. */
+    std::set<page_id_t> free_pages_;
+  };
+  std::unordered_map<segment_id_t, Segment> segments_;
+  /** The segment each extent belongs to, by extent number (first page / EXTENT_PAGES). */
+  std::unordered_map<page_id_t, segment_id_t> extent_segments_;
+  segment_id_t next_segment_id_{0};
+  /** Protects free_pages_, next_page_id_, free_space_map_saved_ and the extent map. */
+  std::mutex free_pages_latch_;
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
@@ -101,7 +365,10 @@ class DiskManager {
   std::fstream db_io_;
   std::string file_name_;
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
+  /** How long page reads and writes take, from the request to the data being in place. */
+  LatencyHistogram read_latency_;
+  LatencyHistogram write_latency_;
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
   // With multiple buffer pool instances, need to protect file access
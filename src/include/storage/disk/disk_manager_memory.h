@@ -9,7 +9,6 @@
 // Copyright (c) 2015-2020, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
-#include <array>
 #include <cstring>
 #include <fstream>
 #include <future>  // NOLINT
@@ -35,7 +34,7 @@ namespace bustub {
  */
 class DiskManagerMemory : public DiskManager {
  public:
-  explicit DiskManagerMemory(size_t pages);
+  explicit DiskManagerMemory(size_t pages, size_t page_size = BUSTUB_PAGE_SIZE);
 
   ~DiskManagerMemory() override { delete[] memory_; }
 
@@ -63,7 +62,7 @@ class DiskManagerMemory : public DiskManager {
  */
 class DiskManagerUnlimitedMemory : public DiskManager {
  public:
-  DiskManagerUnlimitedMemory() = default;
+  explicit DiskManagerUnlimitedMemory(size_t page_size = BUSTUB_PAGE_SIZE) : DiskManager(page_size) {}
 
   /**
    * Write a page to the database file.
@@ -71,6 +70,7 @@ class DiskManagerUnlimitedMemory : public DiskManager {
    * @param page_data raw page data
    */
   void WritePage(page_id_t page_id, const char *page_data) override {
+    ScopedLatency latency(&write_latency_);
     if (latency_ > 0) {
       std::this_thread::sleep_for(std::chrono::milliseconds(latency_));
     }
@@ -81,12 +81,13 @@ class DiskManagerUnlimitedMemory : public DiskManager {
     }
     if (data_[page_id] == nullptr) {
       data_[page_id] = std::make_shared<ProtectedPage>();
+      data_[page_id]->first.resize(page_size_);
     }
     std::shared_ptr<ProtectedPage> ptr = data_[page_id];
     std::unique_lock<std::shared_mutex> l_page(ptr->second);
     l.unlock();
 
-    memcpy(ptr->first.data(), page_data, BUSTUB_PAGE_SIZE);
+    memcpy(ptr->first.data(), page_data, page_size_);
   }
 
   /**
@@ -95,6 +96,7 @@ class DiskManagerUnlimitedMemory : public DiskManager {
    * @param[out] page_data output buffer
    */
   void ReadPage(page_id_t page_id, char *page_data) override {
+    ScopedLatency latency(&read_latency_);
     if (latency_ > 0) {
       std::this_thread::sleep_for(std::chrono::milliseconds(latency_));
     }
@@ -112,14 +114,14 @@ class DiskManagerUnlimitedMemory : public DiskManager {
     std::shared_lock<std::shared_mutex> l_page(ptr->second);
     l.unlock();
 
-    memcpy(page_data, ptr->first.data(), BUSTUB_PAGE_SIZE);
+    memcpy(page_data, ptr->first.data(), page_size_);
   }
 
   void SetLatency(size_t latency_ms) { latency_ = latency_ms; }
 
  private:
   std::mutex mutex_;
-  using Page = std::array<char, BUSTUB_PAGE_SIZE>;
+  using Page = std::vector<char>;
   using ProtectedPage = std::pair<Page, std::shared_mutex>;
   std::vector<std::shared_ptr<ProtectedPage>> data_;
   size_t latency_{0};
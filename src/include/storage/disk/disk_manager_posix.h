@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.h
+//
+// Identification: src/include/storage/disk/disk_manager_posix.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerPosix reads and writes pages of the database file with positional pread/pwrite on a file descriptor.
+ * There is no shared file offset, so page I/O needs no latch and concurrent requests reach the kernel in parallel.
+ * Writes are not synced individually; call Sync() to issue an fdatasync at a durability point.
+ *
+ * With direct_io, the file is opened with O_DIRECT so pages bypass the OS page cache. O_DIRECT requires buffers
+ * aligned to BUSTUB_PAGE_ALIGNMENT; buffer pool frames are, other buffers are bounced through an aligned copy.
+ * If the file system does not support O_DIRECT, the file is opened without it.
+ *
+ * With the double-write buffer enabled, WritePageAsync() holds writes back until SubmitPageRequests(), so that a batch
+ * of writes from the DiskScheduler costs a single sync of the buffer file.
+ *
+ * The log file is still handled by DiskManager.
+ */
+class DiskManagerPosix : public DiskManager {
+ public:
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param direct_io whether to open the database file with O_DIRECT
+   * @param page_size the page size of the database if the file is created
+   * @param options the features of the database if the file is created, and whether to use a double-write buffer
+   */
+  explicit DiskManagerPosix(const std::string &db_file, bool direct_io = false, size_t page_size = BUSTUB_PAGE_SIZE,
+                            const DbFileOptions &options = {});
+
+  ~DiskManagerPosix() override;
+
+  /**
+   * Shut down the disk manager and close all the file resources.
+   */
+  void ShutDown() override;
+
+  /**
+   * Make all the pages written so far durable with fdatasync.
+   */
+  void Sync() override;
+
+  /**
+   * Write a page to the database file.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page from the database file. Reading past the end of the file zero-fills the page.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   * @throws PageCorruptionException if the page fails its checksum
+   * @throws IOException if the page cannot be read
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  void WritePageAsync(page_id_t page_id, const char *page_data, std::promise<bool> callback) override;
+
+  void ReadPageAsync(page_id_t page_id, char *page_data, std::promise<bool> callback) override;
+
+  /**
+   * Write the batch of writes held back for the double-write buffer by the calling thread, if any.
+   */
+  void SubmitPageRequests() override;
+
+  /** @return true if the database file is opened with O_DIRECT */
+  auto IsDirectIO() const -> bool { return direct_io_; }
+
+  /** @return the double-write buffer, nullptr if writes do not go through one */
+  auto GetDoubleWriteBuffer() const -> DoubleWriteBuffer * { return double_write_.get(); }
+
+ protected:
+  /** @return true if page_data can be handed to the kernel as is */
+  auto CanUseBuffer(const char *page_data) const -> bool;
+
+  /** Write the bytes of a page, as prepared by PrepareWrite(), to its place in the database file. */
+  void WriteToFile(page_id_t page_id, const char *data);
+
+  /** File descriptor of the database file, -1 once shut down. */
+  int db_fd_{-1};
+  bool direct_io_;
+
+ private:
+  /** A write held back until the next SubmitPageRequests() of the thread that started it. */
+  struct PendingWrite {
+    page_id_t page_id_;
+    const char *data_;
+    std::promise<bool> callback_;
+  };
+
+  std::unordered_map<std::thread::id, std::vector<PendingWrite>> pending_writes_;
+  std::mutex pending_latch_;
+};
+
+}  // namespace bustub
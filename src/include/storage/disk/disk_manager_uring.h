@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.h
+//
+// Identification: src/include/storage/disk/disk_manager_uring.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager_posix.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace bustub {
+
+/**
+ * DiskManagerUring submits page reads and writes through an io_uring instead of blocking in pread/pwrite.
+ *
+ * Requests started with ReadPageAsync()/WritePageAsync() are queued on the submission ring and handed to the kernel
+ * in one io_uring_enter per batch by SubmitPageRequests(), so a single thread (e.g. a DiskScheduler worker) keeps many
+ * requests in flight. A dedicated thread reaps the completion ring and fulfills the callbacks. At most queue_depth
+ * requests are in flight; further requests wait for a free slot.
+ *
+ * Page buffers passed to RegisterPageBuffers() (the frames of the buffer pools using this disk manager) are
+ * registered with the ring and accessed with READ_FIXED/WRITE_FIXED, which saves the kernel from mapping them on every
+ * request. Requests on a page that already has a request in flight are marked IOSQE_IO_DRAIN, which keeps them in
+ * issue order.
+ *
+ * If the pages carry checksums, writes are stamped into a staging buffer of their slot, since the caller's buffer may
+ * still change while the write is in flight; reads are verified by the completion thread. With the double-write buffer
+ * enabled, writes go through DiskManagerPosix, which batches them.
+ *
+ * If io_uring is not available (old kernel, seccomp, non-Linux build), every call falls back to DiskManagerPosix.
+ */
+class DiskManagerUring : public DiskManagerPosix {
+ public:
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param direct_io whether to open the database file with O_DIRECT
+   * @param queue_depth the maximum number of requests in flight
+   * @param page_size the page size of the database if the file is created
+   * @param options the features of the database if the file is created, and whether to use a double-write buffer
+   */
+  explicit DiskManagerUring(const std::string &db_file, bool direct_io = false,
+                            uint32_t queue_depth = URING_QUEUE_DEPTH, size_t page_size = BUSTUB_PAGE_SIZE,
+                            const DbFileOptions &options = {});
+
+  ~DiskManagerUring() override;
+
+  /**
+   * Shut down the disk manager and close all the file resources.
+   */
+  void ShutDown() override;
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  void WritePageAsync(page_id_t page_id, const char *page_data, std::promise<bool> callback) override;
+
+  void ReadPageAsync(page_id_t page_id, char *page_data, std::promise<bool> callback) override;
+
+  void SubmitPageRequests() override;
+
+  void RegisterPageBuffers(const std::vector<char *> &buffers) override;
+
+  void UnregisterPageBuffers(const std::vector<char *> &buffers) override;
+
+  /** @return true if requests go through io_uring, false if the disk manager fell back to pread/pwrite */
+  auto IsUringEnabled() const -> bool { return ring_fd_ >= 0; }
+
+ private:
+  /** A request that has been put on the submission ring and has not completed yet. */
+  struct InFlightRequest {
+    bool is_write_;
+    page_id_t page_id_;
+    char *data_;
+    std::promise<bool> callback_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  /** Set up the rings and start the completion thread. @return false if io_uring is not available */
+  auto SetUpRing(uint32_t queue_depth) -> bool;
+  /** Stop the completion thread and release the rings. */
+  void TearDownRing();
+  /** Put a request on the submission ring, waiting for a free slot if needed. */
+  void PrepareRequest(bool is_write, page_id_t page_id, char *data, std::promise<bool> callback);
+  /** Get the next free submission queue entry. Caller must hold latch_. */
+  auto NextSqe() -> io_uring_sqe *;
+  /** Submit everything on the submission ring. Caller must hold latch_. */
+  void SubmitPendingLocked();
+  /** Re-register registered_buffers_ with the ring. Caller must hold latch_. */
+  void UpdateRegisteredBuffersLocked();
+  /** Completion thread: reap completions until the shutdown request completes. */
+  void ReapCompletions();
+  /** Handle the completion of the request in the given slot. */
+  void CompleteRequest(uint32_t slot, int result);
+
+  /** The io_uring file descriptor, -1 if io_uring is not used. */
+  int ring_fd_{-1};
+
+  /** Mappings of the rings, see io_uring_setup(2). */
+  void *sq_ring_ptr_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_ptr_{nullptr};
+  size_t cq_ring_size_{0};
+  io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  io_uring_cqe *cqes_{nullptr};
+
+  /** Number of entries put on the submission ring but not yet submitted to the kernel. */
+  unsigned pending_submissions_{0};
+  /** In-flight requests, indexed by the user_data of their submission queue entry. */
+  std::vector<InFlightRequest> slots_;
+  std::vector<uint32_t> free_slots_;
+  /** One page per slot, where writes are stamped with their checksum. Only allocated if the pages carry checksums. */
+  char *staging_{nullptr};
+  /** Number of requests in flight per page, used to keep requests on one page in order. */
+  std::unordered_map<page_id_t, int> in_flight_pages_;
+  /** Registered page buffers, and their index in the ring's buffer table if registration succeeded. */
+  std::vector<char *> registered_buffers_;
+  std::unordered_map<const char *, uint16_t> buffer_index_;
+
+  /** Protects the submission ring, the slots and the buffer registration. */
+  std::mutex latch_;
+  std::condition_variable slot_freed_;
+  std::thread reaper_;
+};
+
+}  // namespace bustub
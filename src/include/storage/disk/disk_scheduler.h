@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.h
+//
+// Identification: src/include/storage/disk/disk_scheduler.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <future>  // NOLINT
+#include <memory>
+#include <optional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/channel.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * @brief Represents a Write or Read request for the DiskManager to execute.
+ */
+struct DiskRequest {
+  /** Flag indicating whether the request is a write or a read. */
+  bool is_write_;
+
+  /**
+   *  Pointer to the start of the memory location where a page is either:
+   *   1. being read into from disk (on a read).
+   *   2. being written out to disk (on a write).
+   */
+  char *data_;
+
+  /** ID of the page being read from / written to disk. */
+  page_id_t page_id_;
+
+  /** Callback used to signal to the request issuer when the request has been completed. */
+  std::promise<bool> callback_;
+};
+
+/**
+ * @brief The DiskScheduler schedules disk read and write operations.
+ *
+ * A request is scheduled by calling DiskScheduler::Schedule() with an appropriate DiskRequest object. The scheduler
+ * keeps a pool of background worker threads, each with its own request queue. A request goes to the queue of worker
+ * page_id % num_workers, so all requests on one page are executed in the order they were scheduled. Each worker
+ * drains its whole queue at once and issues the batch through the DiskManager's asynchronous interface, so requests
+ * on different pages are served concurrently, and a disk manager like DiskManagerUring keeps the whole batch in
+ * flight.
+ */
+class DiskScheduler {
+ public:
+  /**
+   * @brief Creates a new DiskScheduler and starts its worker threads.
+   * @param disk_manager the disk manager that executes the requests
+   * @param num_workers the number of background worker threads
+   */
+  explicit DiskScheduler(DiskManager *disk_manager, size_t num_workers = DISK_SCHEDULER_NUM_WORKERS);
+
+  /**
+   * @brief Stops the worker threads once all the requests scheduled so far have been executed.
+   */
+  ~DiskScheduler();
+
+  /**
+   * @brief Schedules a request for the DiskManager to execute.
+   *
+   * @param r The request to be scheduled.
+   */
+  void Schedule(DiskRequest r);
+
+  /**
+   * @brief Background worker thread function that processes scheduled requests.
+   *
+   * The worker processes requests while the DiskScheduler exists, i.e., this function should not return until
+   * ~DiskScheduler() is called. At that point you need to make sure that the function does return.
+   *
+   * @param worker_id the index of the request queue served by this worker
+   */
+  void StartWorkerThread(size_t worker_id);
+
+  using DiskSchedulerPromise = std::promise<bool>;
+
+  /**
+   * @brief Create a Promise object. If you want to implement your own version of promise, you can change this function
+   * so that our test cases can use your promise implementation.
+   *
+   * @return std::promise<bool>
+   */
+  auto CreatePromise() -> DiskSchedulerPromise { return {}; };
+
+ private:
+  /** Pointer to the disk manager. */
+  DiskManager *disk_manager_;
+  /** One shared queue per worker to concurrently schedule and process requests. When the DiskScheduler's destructor is
+   * called, `std::nullopt` is put into every queue to signal to the workers to stop execution. */
+  std::vector<std::unique_ptr<Channel<std::optional<DiskRequest>>>> request_queues_;
+  /** The background threads responsible for issuing scheduled requests to the disk manager. */
+  std::vector<std::thread> workers_;
+};
+}  // namespace bustub
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// double_write_buffer.h
+//
+// Identification: src/include/storage/disk/double_write_buffer.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * DoubleWriteBuffer protects page writes against tearing. A crash in the middle of a write can leave a page half old
+ * and half new on disk (the device only writes sectors atomically), which no checksum can repair. So every page is
+ * first written to a slot of a small ring file next to the database, the ring file is synced, and only then is the
+ * page written in place. After a crash, Recover() writes every intact slot back in place, oldest first: either the
+ * in-place write may be torn and the slot is intact, or the slot is torn and the in-place write never started.
+ *
+ * A slot is overwritten only once the in-place write it protects is durable, so the ring syncs the database file
+ * (with the callback given at construction) every time it wraps around.
+ *
+ * File layout: a header block with the page size and a header per slot (page id, sequence number, checksum), padded
+ * to BUSTUB_PAGE_ALIGNMENT, followed by the slots.
+ */
+class DoubleWriteBuffer {
+ public:
+  /** Writes a page in place, i.e. to the database file. */
+  using PageWriter = std::function<void(page_id_t, const char *)>;
+
+  /**
+   * Create (or truncate) a double-write buffer file. Recover() must have been called on it first.
+   * @param file_name the double-write buffer file
+   * @param page_size the size of the pages of the database
+   * @param sync_pages makes the pages written in place durable
+   * @param num_slots the number of pages the file holds
+   */
+  DoubleWriteBuffer(const std::string &file_name, size_t page_size, std::function<void()> sync_pages,
+                    size_t num_slots = DOUBLE_WRITE_BUFFER_PAGES);
+
+  DISALLOW_COPY_AND_MOVE(DoubleWriteBuffer);
+
+  /** Close the file, leaving its content for Recover(). */
+  ~DoubleWriteBuffer();
+
+  /**
+   * Write pages through the buffer. Returns once every page is written in place, not necessarily durably.
+   * @param pages the ids and content of the pages
+   * @param write_page writes a page in place
+   */
+  void Write(const std::vector<std::pair<page_id_t, const char *>> &pages, const PageWriter &write_page);
+
+  /** @return the number of times the buffer file was synced, i.e. the number of batches written */
+  auto GetNumSyncs() const -> uint64_t { return num_syncs_; }
+
+  /**
+   * Write the intact pages of a double-write buffer file back in place, in the order they were written.
+   * @param file_name the double-write buffer file, which may not exist
+   * @param page_size the size of the pages of the database; a file for another page size is ignored
+   * @param write_page writes a page in place
+   * @return the number of pages written back
+   */
+  static auto Recover(const std::string &file_name, size_t page_size, const PageWriter &write_page) -> size_t;
+
+ private:
+  /** The start of the file. */
+  struct FileHeader {
+    char magic_[8];
+    uint32_t page_size_;
+    uint32_t num_slots_;
+  };
+
+  /** Describes the page in a slot, follows the file header. */
+  struct SlotHeader {
+    page_id_t page_id_;
+    uint32_t checksum_;
+    uint64_t seq_;
+  };
+
+  /** @return the checksum of a slot holding a page */
+  static auto SlotChecksum(page_id_t page_id, uint64_t seq, const char *page_data, size_t page_size) -> uint32_t;
+  /** @return the size of the header block of a file with num_slots slots */
+  static auto HeaderBlockSize(size_t num_slots) -> size_t;
+
+  int fd_;
+  size_t page_size_;
+  size_t num_slots_;
+  std::function<void()> sync_pages_;
+  /** The header block as it is on disk, rewritten with every batch. */
+  std::vector<char> header_block_;
+  /** The pages of a batch, staged for a single write. */
+  std::vector<char> staging_;
+  size_t next_slot_{0};
+  uint64_t next_seq_{1};
+  /** Number of slots written since the database file was last synced; they must not be reused before it is. */
+  size_t unsynced_slots_{0};
+  std::atomic<uint64_t> num_syncs_{0};
+  /** Serializes writers, a batch holds it until its pages are written in place. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
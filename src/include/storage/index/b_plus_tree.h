@@ -3,7 +3,8 @@
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique, but a key may carry a tiebreaker (see NormalizedKey) so
+ *     that entries with equal columns are kept apart
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
@@ -12,7 +13,9 @@
 
 #include <algorithm>
 #include <deque>
+#include <functional>
 #include <iostream>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <queue>
 #include <shared_mutex>
@@ -56,6 +59,25 @@ class Context {
   auto IsRootPage(page_id_t page_id) -> bool { return page_id == root_page_id_; }
 };
 
+/** How much space a B+ tree takes, see BPlusTree::GetStats. */
+struct BPlusTreeStats {
+  int height_{0};
+  size_t leaf_pages_{0};
+  size_t internal_pages_{0};
+  size_t num_keys_{0};
+  // The bytes of the key prefixes kept in the headers of the internal pages, summed over them.
+  size_t internal_prefix_bytes_{0};
+  // The page size of the buffer pool the tree is in.
+  size_t page_size_{BUSTUB_PAGE_SIZE};
+
+  auto NumPages() const -> size_t { return leaf_pages_ + internal_pages_; }
+
+  /** @return the bytes of pages per key in the tree */
+  auto BytesPerKey() const -> double {
+    return num_keys_ == 0 ? 0 : static_cast<double>(NumPages() * page_size_) / static_cast<double>(num_keys_);
+  }
+};
+
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
 // Main class providing the API for the Interactive B+ Tree.
@@ -65,9 +87,16 @@ class BPlusTree {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
+  /**
+   * @brief Open the B+ tree whose root is recorded in the given header page, and make it empty.
+   * @param leaf_max_size the max number of entries in a leaf page, 0 to fill the pages of the buffer pool
+   * @param internal_max_size the max number of children of an internal page, 0 to fill the pages of the buffer pool
+   */
   explicit BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
-                     const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
-                     int internal_max_size = INTERNAL_PAGE_SIZE);
+                     const KeyComparator &comparator, int leaf_max_size = 0, int internal_max_size = 0);
+
+  // Deletes the pages that were still pinned when they left the tree.
+  ~BPlusTree();
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
@@ -78,7 +107,7 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *txn);
 
-  // Return the value associated with a given key
+  // Return the values associated with a given key, or with the keys whose columns equal it if keys have a tiebreaker
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn = nullptr) -> bool;
 
   // Return the page id of the root node
@@ -110,7 +139,19 @@ class BPlusTree {
    */
   auto DrawBPlusTree() -> std::string;
 
-  // read data from file and insert one by one
+  /**
+   * @brief Build the tree bottom-up from entries in strictly increasing key order, which is much faster than inserting
+   * them one by one. Pages are packed to fill_percent of their max size and allocated one after the other, so the
+   * leaves are laid out in key order. The tree must be empty. BPlusTreeBuilder loads entries in any order.
+   * @param next called for each entry in turn, returns false once there are no more
+   * @param fill_percent how full to pack the pages, in % of their max size. Pages are never left under their min size.
+   */
+  void BulkLoad(const std::function<bool(KeyType *, ValueType *)> &next, int fill_percent = BULK_LOAD_FILL_PERCENT);
+
+  /** @brief Walk the tree to count its pages and keys. Writers must not run concurrently. */
+  auto GetStats() -> BPlusTreeStats;
+
+  // read data from file and insert one by one, or bulk load it if the tree is empty
   void InsertFromFile(const std::string &file_name, Transaction *txn = nullptr);
 
   // read data from file and remove one by one
@@ -122,6 +163,8 @@ class BPlusTree {
 
   void PrintTree(page_id_t page_id, const BPlusTreePage *page);
 
+  void CollectStats(page_id_t page_id, int depth, BPlusTreeStats *stats);
+
   /**
    * @brief Convert A B+ tree into a Printable B+ tree
    *
@@ -130,6 +173,117 @@ class BPlusTree {
    */
   auto ToPrintableBPlusTree(page_id_t root_id) -> PrintableBPlusTree;
 
+  /**
+   * @brief Descend to the leaf that may contain key. Inner pages are read optimistically, falling back to read latch
+   * crabbing if the descent keeps conflicting with writers.
+   * @param key the key to search for, nullptr for the leftmost leaf
+   * @return the read guard of the leaf, std::nullopt if the tree is empty
+   */
+  auto FindLeafRead(const KeyType *key) -> std::optional<ReadPageGuard>;
+
+  /**
+   * @brief Descend to the leaf that may contain key without latching the header and inner pages. Each page is
+   * validated after its child is found, and the leaf is latched, for reading or for writing depending on LeafGuard.
+   * Pages that cannot be read optimistically (not in the buffer pool, or being written) are read latched, and the
+   * descent continues with read latch crabbing from there.
+   * @param key the key to search for, nullptr for the leftmost leaf (only to read it)
+   * @param[out] leaf_guard the ReadPageGuard or WritePageGuard of the leaf, std::nullopt if the tree is empty
+   * @return false if a page changed under the descent, which has to be restarted
+   */
+  template <class LeafGuard>
+  auto FindLeafOptimistic(const KeyType *key, std::optional<LeafGuard> *leaf_guard) -> bool;
+
+  /** @brief Descend from a read latched page to the leaf that may contain key with read latch crabbing. */
+  auto DescendRead(ReadPageGuard guard, const KeyType *key) -> ReadPageGuard;
+
+  /**
+   * @brief Descend from a read latched inner page to the leaf that may contain key with read latch crabbing, and write
+   * latch the leaf. The parent of the leaf stays read latched until then, so the leaf cannot be split, merged or
+   * borrowed from in between.
+   */
+  auto DescendWriteLeaf(ReadPageGuard guard, const KeyType &key) -> WritePageGuard;
+
+  /**
+   * @brief Descend to the leaf that may contain key with write latch crabbing. ctx.header_page_ must hold the header
+   * page of a non-empty tree. The ancestors that may be changed by the operation are left in ctx.write_set_ (the header
+   * page stays in ctx.header_page_ only if the root may change), the leaf is at the back.
+   * @param is_insert whether the descent is for an insert (otherwise for a remove)
+   */
+  void FindLeafWrite(const KeyType &key, bool is_insert, Context *ctx);
+
+  /**
+   * @brief Allocate a page for the tree, on disk close to near_page_id (e.g. the page it splits from). Throws if every
+   * frame of the buffer pool is pinned.
+   */
+  auto NewTreePage(page_id_t *page_id, page_id_t near_page_id) -> BasicPageGuard;
+
+  /** @brief Whether a page cannot split or underflow by one insert or remove, so its ancestors can be released. */
+  auto IsSafe(const BPlusTreePage *page, bool is_insert, bool is_root) const -> bool;
+
+  /**
+   * @brief Insert the separator key and the new right page produced by splitting the page at write_set_[level] into
+   * its parent, splitting the parent in turn if it is full.
+   */
+  void InsertIntoParent(Context *ctx, size_t level, const KeyType &key, page_id_t right_page_id);
+
+  /**
+   * @brief Fix the page at write_set_[level] after a removal left it under its min size, by borrowing from or
+   * merging with a sibling, and walk up the tree while parents underflow in turn.
+   * @param[out] deleted_pages pages that were merged away, to be deleted once all the latches are released
+   */
+  void HandleUnderflow(Context *ctx, size_t level, std::vector<page_id_t> *deleted_pages);
+
+  /**
+   * @brief Delete pages that left the tree. A page someone still has pinned (a descent that is about to find out the
+   * page changed, and restart) cannot be deleted yet; it is kept and retried by the next call, so it does not leak.
+   */
+  void DeletePages(const std::vector<page_id_t> &page_ids);
+
+  /** The pages of one level of a tree being bulk loaded that are not in their parent yet. */
+  struct BulkLevel {
+    // The page before the one being filled. It stays out of the parent until the end of the level is known, as its last
+    // entries may have to be moved into the last page of the level so that this one is not under its min size.
+    std::optional<BasicPageGuard> prev_;
+    KeyType prev_key_;
+    // The page being filled, and its first key.
+    std::optional<BasicPageGuard> cur_;
+    KeyType cur_key_;
+  };
+
+  struct BulkLoadState {
+    std::deque<BulkLevel> levels_;  // from the leaves up
+    int leaf_fill_;
+    int internal_fill_;
+    page_id_t last_page_id_;
+  };
+
+  /** @brief Append an entry to the leaf level of a bulk load, starting a new leaf if the last one is full. */
+  void BulkAppendLeaf(BulkLoadState *state, const KeyType &key, const ValueType &value);
+
+  /** @brief Append a child to an internal level of a bulk load, starting a new page if the last one is full. */
+  void BulkAppendInternal(BulkLoadState *state, size_t level, const KeyType &key, page_id_t child_page_id);
+
+  /** @brief Make guard the page being filled at a level of a bulk load, and hand the one before to the parent level. */
+  void BulkStartPage(BulkLoadState *state, size_t level, BasicPageGuard guard, const KeyType &key);
+
+  /** @brief Rebuild the heads of an internal page of a bulk load once its keys are known. */
+  void BulkRebuildHeads(BasicPageGuard *guard);
+
+  /** @brief Move entries from the previous page, or merge into it, if the last page of a level is under min size. */
+  void BulkBalance(BulkLevel *pages);
+
+  /** @brief Close every level of a bulk load from the leaves up. @return the root page id */
+  auto BulkFinish(BulkLoadState *state) -> page_id_t;
+
+  /** How many times FindLeafRead restarts an optimistic descent before it latches its way down. */
+  static constexpr int OPTIMISTIC_READ_ATTEMPTS = 4;
+
+  /**
+   * How many times Insert and Remove restart an optimistic descent, which only write latches the leaf, before they
+   * fall back to write latch crabbing from the header page.
+   */
+  static constexpr int OPTIMISTIC_WRITE_ATTEMPTS = 4;
+
   // member variable
   std::string index_name_;
   BufferPoolManager *bpm_;
@@ -138,6 +292,9 @@ class BPlusTree {
   int leaf_max_size_;
   int internal_max_size_;
   page_id_t header_page_id_;
+  /** Pages that left the tree but were pinned when DeletePages tried to delete them. */
+  std::vector<page_id_t> undeleted_pages_;
+  std::mutex undeleted_pages_latch_;
 };
 
 /**
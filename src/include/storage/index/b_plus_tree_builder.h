@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_builder.h
+//
+// Identification: src/include/storage/index/b_plus_tree_builder.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+#define BPLUSTREE_BUILDER_TYPE BPlusTreeBuilder<KeyType, ValueType, KeyComparator>
+
+/**
+ * Bulk loads an empty B+ tree from entries added in any order. The entries are sorted in memory up to a budget;
+ * beyond it, sorted runs are spilled to temporary files and merged at the end. The sorted entries are then handed to
+ * BPlusTree::BulkLoad, which builds the tree bottom-up.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeBuilder {
+ public:
+  /**
+   * @param tree the tree to load, which must stay empty until Finish
+   * @param memory_bytes how much memory the entries are sorted in
+   * @param fill_percent how full to pack the pages of the tree, in % of their max size
+   */
+  BPlusTreeBuilder(BPLUSTREE_TYPE *tree, const KeyComparator &comparator, size_t memory_bytes = BULK_LOAD_MEMORY_BYTES,
+                   int fill_percent = BULK_LOAD_FILL_PERCENT);
+
+  DISALLOW_COPY_AND_MOVE(BPlusTreeBuilder);
+
+  ~BPlusTreeBuilder() = default;
+
+  /** Add an entry to load. Of several entries with the same key, only the first one added is loaded. */
+  void Add(const KeyType &key, const ValueType &value);
+
+  /**
+   * Sort the entries added so far and build the tree from them.
+   * @return the number of entries loaded
+   */
+  auto Finish() -> size_t;
+
+  /** @return the number of sorted runs spilled to temporary files so far */
+  auto GetNumRuns() const -> size_t { return runs_.size(); }
+
+ private:
+  struct FileCloser {
+    void operator()(std::FILE *file) const { std::fclose(file); }
+  };
+
+  /** Sort the buffered entries by key, keeping entries with equal keys in the order they were added. */
+  void SortBuffer();
+
+  /** Write the sorted buffered entries to a new run file, and empty the buffer. */
+  void SpillRun();
+
+  BPLUSTREE_TYPE *tree_;
+  KeyComparator comparator_;
+  size_t max_buffered_;
+  int fill_percent_;
+  std::vector<MappingType> buffer_;
+  std::vector<std::unique_ptr<std::FILE, FileCloser>> runs_;
+};
+
+}  // namespace bustub
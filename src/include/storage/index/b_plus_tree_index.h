@@ -18,6 +18,7 @@
 
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_builder.h"
 #include "storage/index/index.h"
 
 namespace bustub {
@@ -27,7 +28,11 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
  public:
-  BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+  /**
+   * @param segment the segment of the database file the pages of the tree go to, INVALID_SEGMENT_ID for none
+   */
+  BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                 segment_id_t segment = INVALID_SEGMENT_ID);
 
   auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
 
@@ -35,6 +40,11 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /**
+   * @return a builder that bulk loads the index, which must be empty, much faster than inserting the entries one by one
+   */
+  auto MakeBuilder() -> BPlusTreeBuilder<KeyType, ValueType, KeyComparator>;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
@@ -51,9 +61,11 @@ class BPlusTreeIndex : public Index {
 /** We only support index table with one integer key for now in BusTub. Hardcode everything here. */
 
 constexpr static const auto TWO_INTEGER_SIZE = 8;
-using IntegerKeyType = GenericKey<TWO_INTEGER_SIZE>;
+/** Two integers take 10 bytes once normalized (see NormalizedKey), and the RID tiebreaker 8 more. */
+constexpr static const auto TWO_INTEGER_NORMALIZED_SIZE = 24;
+using IntegerKeyType = NormalizedKey<TWO_INTEGER_NORMALIZED_SIZE>;
 using IntegerValueType = RID;
-using IntegerComparatorType = GenericComparator<TWO_INTEGER_SIZE>;
+using IntegerComparatorType = NormalizedComparator<TWO_INTEGER_NORMALIZED_SIZE>;
 using BPlusTreeIndexForTwoIntegerColumn = BPlusTreeIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using BPlusTreeIndexIteratorForTwoIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
@@ -14,6 +14,7 @@
 
 #include <cstring>
 
+#include "storage/index/normalized_key.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -35,6 +36,15 @@ class GenericKey {
     memcpy(data_, tuple.GetData(), tuple.GetLength());
   }
 
+  /** Same as above, the key schema is only taken to be built like NormalizedKey. */
+  inline void SetFromKey(const Tuple &tuple, const Schema &key_schema) { SetFromKey(tuple); }
+
+  /**
+   * Same as above. Generic keys have no tiebreaker, so an index on them keeps a single entry for equal keys, unlike
+   * NormalizedKey.
+   */
+  inline void SetFromKey(const Tuple &tuple, const Schema &key_schema, const RID &rid) { SetFromKey(tuple); }
+
   // NOTE: for test purpose only
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
@@ -94,6 +104,25 @@ class GenericComparator {
     return 0;
   }
 
+  /** Compare the columns of two keys, which are all there is to generic keys (see NormalizedComparator). */
+  inline auto CompareColumns(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    return (*this)(lhs, rhs);
+  }
+
+  /**
+   * Write the start of the normalized encoding of key (see NormalizedKeyWriter), which orders keys like this
+   * comparator does, except that this comparator does not order NULLs.
+   * @return the number of bytes written, at most size
+   */
+  inline auto Normalize(const GenericKey<KeySize> &key, char *out, size_t size) const -> size_t {
+    NormalizedKeyWriter writer(out, size);
+    const uint32_t column_count = key_schema_->GetColumnCount();
+    for (uint32_t i = 0; i < column_count && !writer.IsFull(); i++) {
+      writer.Append(key.ToValue(key_schema_, i));
+    }
+    return writer.Size();
+  }
+
   GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
 
   // constructor
@@ -13,17 +13,34 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <utility>
+
+#include "buffer/read_ahead.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * IndexIterator walks the leaf chain of a B+ tree. It keeps the current leaf pinned and read latched, and latches the
+ * next leaf before letting go of the current one. A default constructed iterator is the end iterator.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
  public:
-  // you may define your own constructor based on your member variables
   IndexIterator();
+  /**
+   * @param bpm the buffer pool manager of the tree
+   * @param guard the read guard of the leaf the iterator starts on
+   * @param index the index of the first entry in that leaf, may be the size of the leaf
+   */
+  IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index);
+  IndexIterator(IndexIterator &&that) noexcept = default;
+  auto operator=(IndexIterator &&that) noexcept -> IndexIterator & = default;
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -32,12 +49,22 @@ class IndexIterator {
 
   auto operator++() -> IndexIterator &;
 
-  auto operator==(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator==(const IndexIterator &itr) const -> bool {
+    return page_id_ == itr.page_id_ && (page_id_ == INVALID_PAGE_ID || index_ == itr.index_);
+  }
 
-  auto operator!=(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  /** Skip to the next leaf while the current position is past the end of the current leaf. */
+  void SkipExhaustedLeaves();
+
+  BufferPoolManager *bpm_{nullptr};
+  ReadPageGuard guard_;
+  page_id_t page_id_{INVALID_PAGE_ID};
+  int index_{0};
+  // Leaves split off one after another (sequential inserts, bulk loads) tend to get consecutive page ids.
+  ReadAhead read_ahead_{nullptr};
 };
 
 }  // namespace bustub
@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// normalized_key.h
+//
+// Identification: src/include/storage/index/normalized_key.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+
+#include "common/exception.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Writes the normalized encoding of a key, column by column, into a buffer: a binary string that compares with memcmp
+ * the way the key compares with its columns' Value comparisons. Each column starts with a byte that orders NULL first,
+ * followed by:
+ * - integers (and booleans, timestamps) in big-endian order, with the sign bit flipped for signed types,
+ * - decimals as their IEEE bits, with the sign bit flipped if positive and every bit flipped if negative,
+ * - varchars as their bytes, with 0x00 escaped as 0x00 0xff, and terminated by 0x00 0x00.
+ *
+ * The encoding is truncated at the end of the buffer. A prefix of it still orders keys, loosely: if a < b then the
+ * prefix of a is not greater than the prefix of b.
+ */
+class NormalizedKeyWriter {
+ public:
+  NormalizedKeyWriter(char *out, size_t size) : out_(out), size_(size) {}
+
+  /** Append the encoding of a column. */
+  void Append(const Value &value);
+
+  /** @return the number of bytes written so far */
+  auto Size() const -> size_t { return pos_; }
+
+  /** @return whether the buffer is full, so that further columns would be cut off entirely */
+  auto IsFull() const -> bool { return pos_ == size_; }
+
+  /** @return whether part of the encoding did not fit in the buffer */
+  auto IsTruncated() const -> bool { return truncated_; }
+
+ private:
+  void Put(uint8_t byte) {
+    if (pos_ < size_) {
+      out_[pos_++] = static_cast<char>(byte);
+    } else {
+      truncated_ = true;
+    }
+  }
+
+  /** Append the low bytes bytes of value, most significant first. */
+  void PutBigEndian(uint64_t value, int bytes);
+
+  char *out_;
+  size_t size_;
+  size_t pos_{0};
+  bool truncated_{false};
+};
+
+/**
+ * A key that holds the normalized encoding of its columns (see NormalizedKeyWriter), zero padded, followed by the RID
+ * of its tuple in the last TIEBREAKER_SIZE bytes. The columns are encoded once when the key is built, so that
+ * NormalizedComparator compares keys without decoding them. An encoding takes one more byte per column than the
+ * columns take in a tuple, and varchars are escaped.
+ *
+ * The RID makes the keys of tuples with equal columns distinct, so that an index holds all of them in key order. A key
+ * built without a RID has a zero tiebreaker, and orders before every key with the same columns.
+ */
+template <size_t KeySize>
+class NormalizedKey {
+  static_assert(KeySize % sizeof(uint64_t) == 0, "normalized keys are compared a word at a time");
+
+ public:
+  /** The size of the RID at the end of a key. */
+  static constexpr size_t TIEBREAKER_SIZE = sizeof(uint64_t);
+  static_assert(KeySize > TIEBREAKER_SIZE, "normalized keys have room for their columns");
+
+  /** Encode a key tuple, without tiebreaker. Throws if its encoding does not fit in KeySize - TIEBREAKER_SIZE bytes. */
+  inline void SetFromKey(const Tuple &tuple, const Schema &key_schema) {
+    memset(data_, 0, KeySize);
+    NormalizedKeyWriter writer(data_, KeySize - TIEBREAKER_SIZE);
+    for (uint32_t i = 0; i < key_schema.GetColumnCount(); i++) {
+      writer.Append(tuple.GetValue(&key_schema, i));
+    }
+    if (writer.IsTruncated()) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "the key is too large for its normalized key type");
+    }
+  }
+
+  /** Encode a key tuple, and the RID of the tuple it was taken from as tiebreaker. */
+  inline void SetFromKey(const Tuple &tuple, const Schema &key_schema, const RID &rid) {
+    SetFromKey(tuple, key_schema);
+    // Valid page ids are not negative, so flipping the sign bit orders every RID after the zero tiebreaker.
+    const uint64_t tiebreaker =
+        (static_cast<uint64_t>(static_cast<uint32_t>(rid.GetPageId()) ^ 0x80000000U) << 32) | rid.GetSlotNum();
+    for (size_t i = 0; i < TIEBREAKER_SIZE; i++) {
+      data_[KeySize - 1 - i] = static_cast<char>(tiebreaker >> (8 * i));
+    }
+  }
+
+  // NOTE: for test purpose only
+  inline void SetFromInteger(int64_t key) {
+    memset(data_, 0, KeySize);
+    NormalizedKeyWriter writer(data_, KeySize - TIEBREAKER_SIZE);
+    writer.Append(Value(TypeId::BIGINT, key));
+  }
+
+  // NOTE: for test purpose only
+  // decode the key set by SetFromInteger
+  inline auto ToString() const -> int64_t {
+    uint64_t bits = 0;
+    for (size_t i = 1; i <= sizeof(int64_t); i++) {
+      bits = (bits << 8) | static_cast<uint8_t>(data_[i]);
+    }
+    return static_cast<int64_t>(bits ^ (uint64_t{1} << 63));
+  }
+
+  // NOTE: for test purpose only
+  friend auto operator<<(std::ostream &os, const NormalizedKey &key) -> std::ostream & {
+    os << key.ToString();
+    return os;
+  }
+
+  char data_[KeySize];
+};
+
+/**
+ * Function object that orders NormalizedKeys, used for trees. The encodings are compared as big-endian words, which
+ * is the order memcmp gives them.
+ */
+template <size_t KeySize>
+class NormalizedComparator {
+ public:
+  inline auto operator()(const NormalizedKey<KeySize> &lhs, const NormalizedKey<KeySize> &rhs) const -> int {
+    return CompareWords(lhs, rhs, KeySize);
+  }
+
+  /** Compare the columns of two keys only, so that keys that differ in their tiebreaker are equal. */
+  inline auto CompareColumns(const NormalizedKey<KeySize> &lhs, const NormalizedKey<KeySize> &rhs) const -> int {
+    return CompareWords(lhs, rhs, KeySize - NormalizedKey<KeySize>::TIEBREAKER_SIZE);
+  }
+
+  /** Copy the start of the encoding of key, see GenericComparator::Normalize. */
+  inline auto Normalize(const NormalizedKey<KeySize> &key, char *out, size_t size) const -> size_t {
+    const size_t copied = std::min(size, KeySize);
+    memcpy(out, key.data_, copied);
+    return copied;
+  }
+
+  NormalizedComparator(const NormalizedComparator &other) = default;
+
+  // constructor, the key schema is only taken to be built like GenericComparator
+  explicit NormalizedComparator(Schema *key_schema) {}
+
+ private:
+  static inline auto CompareWords(const NormalizedKey<KeySize> &lhs, const NormalizedKey<KeySize> &rhs, size_t size)
+      -> int {
+    for (size_t offset = 0; offset < size; offset += sizeof(uint64_t)) {
+      const uint64_t lhs_word = LoadWord(lhs.data_ + offset);
+      const uint64_t rhs_word = LoadWord(rhs.data_ + offset);
+      if (lhs_word != rhs_word) {
+        return lhs_word < rhs_word ? -1 : 1;
+      }
+    }
+    return 0;
+  }
+
+  static inline auto LoadWord(const char *data) -> uint64_t {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+  }
+};
+
+}  // namespace bustub
@@ -10,6 +10,8 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <queue>
 #include <string>
 
@@ -18,8 +20,8 @@
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 12
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_HEADER_SIZE 24
+#define INTERNAL_PAGE_SIZE (Capacity(BUSTUB_PAGE_SIZE))  // capacity of a 4KB page
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -28,10 +30,24 @@ namespace bustub {
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
- * Internal page format (keys are stored in increasing order):
+ * Internal page format (keys are stored in increasing order, the heads of the
+ * keys are followed by room for MaxSize heads):
  *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
+ * | HEADER | HEAD(1) | ... | HEAD(n) | ... | KEY(1)+PAGE_ID(1) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 24 bytes in total):
+ *  --------------------------------------------------------------------------
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | PrefixSize (1) | Prefix (11) |
+ *  --------------------------------------------------------------------------
+ *
+ * The head of a key is the 4 bytes of its normalized encoding (see NormalizedKeyWriter) that follow the prefix all
+ * the keys of the page share, as a big-endian integer. Heads are ordered like the keys, so a search first narrows
+ * down the keys with the compact array of heads, and only compares the few keys whose head equals the head of the
+ * searched key. The prefix is at least as long as the common prefix of the encodings of the keys when the page was
+ * last rebuilt (split, merged or bulk loaded), so that the heads tell the keys of a page apart even if their encodings
+ * start the same way. The prefix only serves the heads: the keys are stored whole, so a page holds fewer entries
+ * than it would without heads.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
@@ -47,6 +63,12 @@ class BPlusTreeInternalPage : public BPlusTreePage {
    */
   void Init(int max_size = INTERNAL_PAGE_SIZE);
 
+  /** @return the number of entries that fit in an internal page of page_size bytes */
+  static constexpr auto Capacity(size_t page_size) -> int {
+    return static_cast<int>((page_size - INTERNAL_PAGE_HEADER_SIZE - (alignof(MappingType) - 1)) /
+                            (sizeof(MappingType) + KEY_HEAD_SIZE));
+  }
+
   /**
    * @param index The index of the key to get. Index must be non-zero.
    * @return Key at index
@@ -58,7 +80,7 @@ class BPlusTreeInternalPage : public BPlusTreePage {
    * @param index The index of the key to set. Index must be non-zero.
    * @param key The new value for key
    */
-  void SetKeyAt(int index, const KeyType &key);
+  void SetKeyAt(int index, const KeyType &key, const KeyComparator &comparator);
 
   /**
    *
@@ -73,6 +95,41 @@ class BPlusTreeInternalPage : public BPlusTreePage {
    */
   auto ValueAt(int index) const -> ValueType;
 
+  /**
+   *
+   * @param index the index
+   * @param value the new value at the index
+   */
+  void SetValueAt(int index, const ValueType &value);
+
+  /**
+   * @param key the key to search for
+   * @param max_size the max size the page was initialized with. Optimistic readers may see a size that is being
+   * rewritten, so the search never goes beyond it.
+   * @return the child pointer of the subtree that may contain key
+   */
+  auto Lookup(const KeyType &key, const KeyComparator &comparator, int max_size) const -> ValueType;
+
+  /**
+   * Insert key & value at index, shifting the entries after it. The page must not be full.
+   * @param index the index of the new entry, the key is ignored if it is 0
+   */
+  void InsertAt(int index, const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  /** Recompute the prefix and the heads of the page from its keys, to make the prefix as long as possible. */
+  void RebuildHeads(const KeyComparator &comparator);
+
+  /** @return the size of the encoded prefix all the keys of the page share, never more than KEY_PREFIX_CAPACITY */
+  auto GetPrefixSize() const -> int {
+    // Optimistic readers may see a page that is being rewritten, the clamp keeps them within the header.
+    return std::min<int>(prefix_size_, KEY_PREFIX_CAPACITY);
+  }
+
+  /**
+   * Remove the entry at index, shifting the entries after it.
+   */
+  void RemoveAt(int index);
+
   /**
    * @brief For test only, return a string representing all keys in
    * this internal page, formatted as "(key1,key2,key3,...)"
@@ -100,7 +157,60 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   }
 
  private:
-  // Flexible array member for page data.
-  MappingType array_[0];
+  /** The longest encoded prefix a page keeps in its header. */
+  static constexpr int KEY_PREFIX_CAPACITY = 11;
+
+  /**
+   * Compare the prefix of this page with the start of the encoding of a key, and get the head of the key.
+   * @param[out] head the head of the key, if it starts with the prefix
+   * @return < 0 if the key is less than every key of the page, > 0 if greater, 0 if it starts with the prefix
+   */
+  auto ProbeKey(const KeyType &key, const KeyComparator &comparator, uint32_t *head) const -> int {
+    char encoded[KEY_PREFIX_CAPACITY + KEY_HEAD_SIZE] = {};
+    comparator.Normalize(key, encoded, GetPrefixSize() + KEY_HEAD_SIZE);
+    const int order = memcmp(encoded, prefix_, GetPrefixSize());
+    *head = ReadHead(encoded + GetPrefixSize());
+    return order;
+  }
+
+  /** Make the prefix of the page the common prefix of the encodings of its smallest and largest keys. */
+  void SetPrefix(const KeyType &first, const KeyType &last, const KeyComparator &comparator) {
+    char first_encoded[KEY_PREFIX_CAPACITY] = {};
+    char last_encoded[KEY_PREFIX_CAPACITY] = {};
+    comparator.Normalize(first, first_encoded, KEY_PREFIX_CAPACITY);
+    comparator.Normalize(last, last_encoded, KEY_PREFIX_CAPACITY);
+    int size = 0;
+    while (size < KEY_PREFIX_CAPACITY && first_encoded[size] == last_encoded[size]) {
+      size++;
+    }
+    memcpy(prefix_, first_encoded, size);
+    prefix_size_ = static_cast<uint8_t>(size);
+  }
+
+  void ClearPrefix() { prefix_size_ = 0; }
+
+  auto Entries(int max_size) const -> const MappingType * {
+    return reinterpret_cast<const MappingType *>(reinterpret_cast<const char *>(this) + EntriesOffset(max_size));
+  }
+
+  auto Entries() const -> const MappingType * { return Entries(GetMaxSize()); }
+
+  auto Entries() -> MappingType * {
+    return reinterpret_cast<MappingType *>(reinterpret_cast<char *>(this) + EntriesOffset(GetMaxSize()));
+  }
+
+  /** @return the offset of the entries in a page of the given max size, right after the room for the heads */
+  static auto EntriesOffset(int max_size) -> size_t {
+    const size_t heads_end = INTERNAL_PAGE_HEADER_SIZE + KEY_HEAD_SIZE * max_size;
+    return (heads_end + alignof(MappingType) - 1) / alignof(MappingType) * alignof(MappingType);
+  }
+
+  /** Set the head of the key at index, which was just stored, or rebuild them all if it does not have the prefix. */
+  void UpdateHead(int index, const KeyComparator &comparator);
+
+  uint8_t prefix_size_;
+  char prefix_[KEY_PREFIX_CAPACITY];
+  // Flexible array member for the heads, the entries follow them. The first head is unused, like the first key.
+  uint32_t heads_[0];
 };
 }  // namespace bustub
@@ -20,14 +20,16 @@ namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 16
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))  // capacity of a 4KB page
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
- * page. Only support unique key.
+ * page. Keys are unique within the tree; entries whose columns are equal are
+ * told apart by the RID tiebreaker of their keys (see NormalizedKey).
  *
- * Leaf page format (keys are stored in order):
+ * Leaf page format (keys are stored in order). Unlike internal pages, leaves
+ * keep no key heads, which would only cost them fanout:
  *  ----------------------------------------------------------------------
  * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
  *  ----------------------------------------------------------------------
@@ -54,10 +56,52 @@ class BPlusTreeLeafPage : public BPlusTreePage {
    */
   void Init(int max_size = LEAF_PAGE_SIZE);
 
+  /** @return the number of entries that fit in a leaf page of page_size bytes */
+  static constexpr auto Capacity(size_t page_size) -> int {
+    return static_cast<int>((page_size - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType));
+  }
+
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
   auto KeyAt(int index) const -> KeyType;
+  auto ValueAt(int index) const -> ValueType;
+  auto PairAt(int index) const -> const MappingType &;
+  void SetAt(int index, const KeyType &key, const ValueType &value);
+
+  /**
+   * @return the index of the first key that is not less than key, GetSize() if there is none
+   */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /**
+   * @param[out] value the value stored with key
+   * @return true if key is in this page
+   */
+  auto Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const -> bool;
+
+  /**
+   * Insert key & value in key order. The page must not be full.
+   * @return false if key is already in this page
+   */
+  auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> bool;
+
+  /**
+   * @return false if key is not in this page
+   */
+  auto Remove(const KeyType &key, const KeyComparator &comparator) -> bool;
+
+  /**
+   * Append every entry of this page to recipient, which must be the left sibling, and unlink this page from the leaf
+   * chain.
+   */
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+
+  /** Move the first entry of this page to the end of recipient, its left sibling. */
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+
+  /** Move the last entry of this page to the front of recipient, its right sibling. */
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
   /**
    * @brief for test only return a string representing all keys in
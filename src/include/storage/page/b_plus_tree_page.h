@@ -12,6 +12,7 @@
 
 #include <cassert>
 #include <climits>
+#include <cstring>
 #include <cstdlib>
 #include <string>
 
@@ -37,6 +38,9 @@ enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
  * ----------------------------------------------------------------------------
  * | PageType (4) | CurrentSize (4) | MaxSize (4) |
  * ----------------------------------------------------------------------------
+ *
+ * The helpers below search the key heads of internal pages (see BPlusTreeInternalPage). Heads only speed up the
+ * search, keys are stored whole; leaves keep no heads, as they would only cost them fanout.
  */
 class BPlusTreePage {
  public:
@@ -56,11 +60,24 @@ class BPlusTreePage {
   void SetMaxSize(int max_size);
   auto GetMinSize() const -> int;
 
+ protected:
+  /** The size of the head of a key, the part of its encoding that follows the prefix of its page. */
+  static constexpr int KEY_HEAD_SIZE = sizeof(uint32_t);
+
+  /** @return the big-endian integer in the KEY_HEAD_SIZE bytes at encoded */
+  static auto ReadHead(const char *encoded) -> uint32_t;
+
+  /** @return the index of the first of the ordered heads[begin, end) that is not less than head */
+  static auto HeadLowerBound(const uint32_t *heads, int begin, int end, uint32_t head) -> int;
+
+  /** @return the index of the first of the ordered heads[begin, end) that is greater than head */
+  static auto HeadUpperBound(const uint32_t *heads, int begin, int end, uint32_t head) -> int;
+
  private:
   // member variable, attributes that both internal and leaf page share
-  IndexPageType page_type_ __attribute__((__unused__));
-  int size_ __attribute__((__unused__));
-  int max_size_ __attribute__((__unused__));
+  IndexPageType page_type_;
+  int size_;
+  int max_size_;
 };
 
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
 
@@ -24,24 +25,28 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The book-keeping of a frame fills its own cache lines, so that pinning one frame does not slow down its neighbours.
+ * The data lives apart, in the FrameArena of the buffer pool.
  */
-class Page {
+class alignas(BUSTUB_CACHE_LINE_SIZE) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManager;
+  friend class OptimisticPageGuard;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() {
-    data_ = new char[BUSTUB_PAGE_SIZE];
-    ResetMemory();
-  }
+  /** Constructor. The buffer pool points the page at the memory of its frame. */
+  Page() = default;
 
-  /** Default destructor. */
-  ~Page() { delete[] data_; }
+  /** Default destructor. The frame memory belongs to the buffer pool. */
+  ~Page() = default;
 
   /** @return the actual data contained within this page */
   inline auto GetData() -> char * { return data_; }
 
+  /** @return the number of bytes of data, the page size of the database */
+  inline auto GetPageSize() const -> size_t { return page_size_; }
+
   /** @return the page id of this page */
   inline auto GetPageId() -> page_id_t { return page_id_; }
 
@@ -52,10 +57,16 @@ class Page {
   inline auto IsDirty() -> bool { return is_dirty_; }
 
   /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.fetch_add(1);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.fetch_add(1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -63,6 +74,15 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /** Acquire the page read latch if no writer holds it. @return true if the latch was acquired */
+  inline auto TryRLatch() -> bool { return rwlatch_.TryRLock(); }
+
+  /**
+   * @return the version of this page, for optimistic readers. It is odd while the page is write latched, and it
+   * changes whenever the page is modified under the write latch or its frame is given to another page.
+   */
+  inline auto GetVersion() -> uint64_t { return version_.load(std::memory_order_acquire); }
+
   /** @return the page LSN. */
   inline auto GetLSN() -> lsn_t { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -79,20 +99,23 @@ class Page {
 
  private:
   /** Zeroes out the data that is held within the page. */
-  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
+  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, page_size_); }
 
-  /** The actual data that is stored within a page. */
-  // Usually this should be stored as `char data_[BUSTUB_PAGE_SIZE]{};`. But to enable ASAN to detect page overflow,
-  // we store it as a ptr.
-  char *data_;
+  /** The actual data that is stored within a page: page_size_ bytes of the buffer pool's FrameArena. */
+  char *data_{nullptr};
+  /** The size of data_. */
+  size_t page_size_{BUSTUB_PAGE_SIZE};
+  // The book-keeping fields are atomic, since the buffer pool reads and updates them without its latch on hits.
   /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  std::atomic<page_id_t> page_id_{INVALID_PAGE_ID};
+  /** The pin count of this page. Biased to a large negative value while the buffer pool evicts the frame. */
+  std::atomic<int> pin_count_{0};
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_{false};
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Bumped by WLatch and WUnlatch, and by the buffer pool when it reuses the frame. */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
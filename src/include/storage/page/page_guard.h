@@ -15,8 +15,7 @@ class BasicPageGuard {
   BasicPageGuard(const BasicPageGuard &) = delete;
   auto operator=(const BasicPageGuard &) -> BasicPageGuard & = delete;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Move constructor for BasicPageGuard
    *
    * When you call BasicPageGuard(std::move(other_guard)), you
@@ -27,8 +26,7 @@ class BasicPageGuard {
    */
   BasicPageGuard(BasicPageGuard &&that) noexcept;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Drop a page guard
    *
    * Dropping a page guard should clear all contents
@@ -38,8 +36,7 @@ class BasicPageGuard {
    */
   void Drop();
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Move assignment for BasicPageGuard
    *
    * Similar to a move constructor, except that the move
@@ -50,8 +47,7 @@ class BasicPageGuard {
    */
   auto operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard &;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Destructor for BasicPageGuard
    *
    * When a page guard goes out of scope, it should behave as if
@@ -82,7 +78,7 @@ class BasicPageGuard {
   friend class ReadPageGuard;
   friend class WritePageGuard;
 
-  [[maybe_unused]] BufferPoolManager *bpm_{nullptr};
+  BufferPoolManager *bpm_{nullptr};
   Page *page_{nullptr};
   bool is_dirty_{false};
 };
@@ -94,8 +90,7 @@ class ReadPageGuard {
   ReadPageGuard(const ReadPageGuard &) = delete;
   auto operator=(const ReadPageGuard &) -> ReadPageGuard & = delete;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Move constructor for ReadPageGuard
    *
    * Very similar to BasicPageGuard. You want to create
@@ -104,8 +99,7 @@ class ReadPageGuard {
    */
   ReadPageGuard(ReadPageGuard &&that) noexcept;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Move assignment for ReadPageGuard
    *
    * Very similar to BasicPageGuard. Given another ReadPageGuard,
@@ -113,8 +107,7 @@ class ReadPageGuard {
    */
   auto operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard &;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Drop a ReadPageGuard
    *
    * ReadPageGuard's Drop should behave similarly to BasicPageGuard,
@@ -124,8 +117,7 @@ class ReadPageGuard {
    */
   void Drop();
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Destructor for ReadPageGuard
    *
    * Just like with BasicPageGuard, this should behave
@@ -142,11 +134,50 @@ class ReadPageGuard {
     return guard_.As<T>();
   }
 
+  /** @return true if the guard holds no page, e.g. because the buffer pool had no frame for it */
+  auto IsEmpty() const -> bool { return guard_.page_ == nullptr; }
+
  private:
   // You may choose to get rid of this and add your own private variables.
   BasicPageGuard guard_;
 };
 
+/**
+ * OptimisticPageGuard reads a page without pinning or latching it, so that readers do not write to any shared cache
+ * line. Writers and the buffer pool may change the page at any time: whatever is read through the guard must be
+ * checked with Validate() before it is acted upon, and thrown away if that fails. An empty guard never validates.
+ */
+class OptimisticPageGuard {
+ public:
+  OptimisticPageGuard() = default;
+  OptimisticPageGuard(Page *page, page_id_t page_id, uint64_t version)
+      : page_(page), page_id_(page_id), version_(version) {}
+
+  /** @return true if the page has not changed since the guard was taken, i.e. everything read so far is consistent */
+  auto Validate() const -> bool {
+    if (page_ == nullptr) {
+      return false;
+    }
+    // Orders the reads of the page data before the second read of the version.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return page_->version_.load(std::memory_order_relaxed) == version_;
+  }
+
+  auto PageId() const -> page_id_t { return page_id_; }
+
+  auto GetData() const -> const char * { return page_->GetData(); }
+
+  template <class T>
+  auto As() const -> const T * {
+    return reinterpret_cast<const T *>(GetData());
+  }
+
+ private:
+  Page *page_{nullptr};
+  page_id_t page_id_{INVALID_PAGE_ID};
+  uint64_t version_{0};
+};
+
 class WritePageGuard {
  public:
   WritePageGuard() = default;
@@ -154,8 +185,7 @@ class WritePageGuard {
   WritePageGuard(const WritePageGuard &) = delete;
   auto operator=(const WritePageGuard &) -> WritePageGuard & = delete;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Move constructor for WritePageGuard
    *
    * Very similar to BasicPageGuard. You want to create
@@ -164,8 +194,7 @@ class WritePageGuard {
    */
   WritePageGuard(WritePageGuard &&that) noexcept;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Move assignment for WritePageGuard
    *
    * Very similar to BasicPageGuard. Given another WritePageGuard,
@@ -173,8 +202,7 @@ class WritePageGuard {
    */
   auto operator=(WritePageGuard &&that) noexcept -> WritePageGuard &;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Drop a WritePageGuard
    *
    * WritePageGuard's Drop should behave similarly to BasicPageGuard,
@@ -184,8 +212,7 @@ class WritePageGuard {
    */
   void Drop();
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Destructor for WritePageGuard
    *
    * Just like with BasicPageGuard, this should behave
@@ -209,6 +236,9 @@ class WritePageGuard {
     return guard_.AsMut<T>();
   }
 
+  /** @return true if the guard holds no page, e.g. because the buffer pool had no frame for it */
+  auto IsEmpty() const -> bool { return guard_.page_ == nullptr; }
+
  private:
   // You may choose to get rid of this and add your own private variables.
   BasicPageGuard guard_;
@@ -65,15 +65,17 @@ class TablePage {
   /** Set the page id of the next page in the table. */
   void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
-  /** Get the next offset to insert, return nullopt if this tuple cannot fit in this page */
-  auto GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t>;
+  /** Get the next offset to insert in a page of page_size bytes, return nullopt if this tuple cannot fit in it */
+  auto GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple, size_t page_size) const
+      -> std::optional<uint16_t>;
 
   /**
    * Insert a tuple into the table.
    * @param tuple tuple to insert
+   * @param page_size the size of the page, see Page::GetPageSize()
    * @return true if the insert is successful (i.e. there is enough space)
    */
-  auto InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t>;
+  auto InsertTuple(const TupleMeta &meta, const Tuple &tuple, size_t page_size) -> std::optional<uint16_t>;
 
   /**
    * Update a tuple.
@@ -15,6 +15,7 @@
 #include <mutex>  // NOLINT
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
@@ -40,9 +41,9 @@ class TableHeap {
   /**
    * Create a table heap without a transaction. (open table)
    * @param buffer_pool_manager the buffer pool manager
-   * @param first_page_id the id of the first page
+   * @param segment the segment of the database file the pages of the table go to, INVALID_SEGMENT_ID for none
    */
-  explicit TableHeap(BufferPoolManager *bpm);
+  explicit TableHeap(BufferPoolManager *bpm, segment_id_t segment = INVALID_SEGMENT_ID);
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return std::nullopt.
@@ -67,6 +68,17 @@ class TableHeap {
    */
   auto GetTuple(RID rid) -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Read a batch of tuples from the table, e.g. the RIDs an index scan found. The heap pages are fetched in page id
+   * order, up to TUPLE_FETCH_BATCH_PAGES at a time with BufferPoolManager::FetchPagesRead, rather than one by one.
+   * When the buffer pool cannot pin all the pages of a batch, the batches shrink down to a single page.
+   * @param rids rids of the tuples to read, in any order and possibly on the same pages
+   * @return the meta and tuple of every rid, in the order of rids
+   * @throws Exception if the page of a tuple cannot be pinned on its own, because every frame is pinned or because the
+   * page was deleted
+   */
+  auto GetTuples(const std::vector<RID> &rids) -> std::vector<std::pair<TupleMeta, Tuple>>;
+
   /**
    * Read a tuple meta from the table. Note: if you want to get tuple and meta together, use `GetTuple` insead
    * to ensure atomicity.
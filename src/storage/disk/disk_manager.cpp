@@ -10,31 +10,136 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstring>
 #include <iostream>
+#include <iterator>
 #include <mutex>  // NOLINT
+#include <new>
 #include <string>
 #include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/util/crc32c_util.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/double_write_buffer.h"
 
 namespace bustub {
 
 static char *buffer_used;
 
+namespace {
+
+/** The start of every database file, the rest of the first DB_FILE_HEADER_SIZE bytes is zero. */
+struct DbFileHeader {
+  char magic_[8];
+  uint32_t version_;
+  uint32_t page_size_;
+  /** DB_FILE_* feature bits, zero in files created before there were any. */
+  uint32_t flags_;
+  /** The first page of the saved free-space map, valid with DB_FILE_FREE_SPACE_MAP. */
+  page_id_t free_space_map_;
+  /** The number of free pages listed in the saved free-space map. */
+  uint32_t num_free_pages_;
+};
+
+constexpr char DB_FILE_MAGIC[8] = {'B', 'U', 'S', 'T', 'U', 'B', 'D', 'B'};
+constexpr uint32_t DB_FILE_VERSION = 1;
+constexpr uint32_t DB_FILE_CHECKSUMS = 1;
+constexpr uint32_t DB_FILE_FREE_SPACE_MAP = 2;
+
+/**
+ * The start of a page of the saved free-space map, followed by the ids of free pages. The map is a chain of such pages,
+ * stored in free pages themselves, so it costs no space in the file.
+ */
+struct FreeSpaceMapPage {
+  char magic_[8];
+  /** CRC-32C of the rest of the page header and of the page ids. */
+  uint32_t checksum_;
+  /** The next page of the map, INVALID_PAGE_ID for the last one. */
+  page_id_t next_page_id_;
+  uint32_t num_pages_;
+};
+
+constexpr char FREE_SPACE_MAP_MAGIC[8] = {'B', 'U', 'S', 'T', 'U', 'B', 'F', 'S'};
+
+/** @return the checksum of a page of the free-space map holding num_pages page ids */
+auto FreeSpaceMapChecksum(const char *page_data, uint32_t num_pages) -> uint32_t {
+  constexpr size_t checked_offset = offsetof(FreeSpaceMapPage, next_page_id_);
+  return Crc32cUtil::Checksum(page_data + checked_offset,
+                              sizeof(FreeSpaceMapPage) - checked_offset + num_pages * sizeof(page_id_t));
+}
+
+/** A buffer for the largest page aligned for O_DIRECT. */
+struct AlignedPageBuffer {
+  AlignedPageBuffer() : data_(new (std::align_val_t{BUSTUB_PAGE_ALIGNMENT}) char[BUSTUB_MAX_PAGE_SIZE]) {}
+  ~AlignedPageBuffer() { ::operator delete[](data_, std::align_val_t{BUSTUB_PAGE_ALIGNMENT}); }
+  AlignedPageBuffer(const AlignedPageBuffer &) = delete;
+  auto operator=(const AlignedPageBuffer &) -> AlignedPageBuffer & = delete;
+  char *data_;
+};
+
+/** @return the checksum of a page, which covers its id so that a page written at the wrong offset is caught */
+auto PageChecksum(page_id_t page_id, const char *page_data, size_t page_size) -> uint32_t {
+  const uint32_t crc = Crc32cUtil::Checksum(page_data, page_size - PAGE_CHECKSUM_SIZE);
+  return Crc32cUtil::Checksum(reinterpret_cast<const char *>(&page_id), sizeof(page_id), crc);
+}
+
+}  // namespace
+
+DiskManager::DiskManager(size_t page_size) : page_size_(page_size) {
+  if (!IsValidPageSize(page_size_)) {
+    throw Exception("invalid page size " + std::to_string(page_size_));
+  }
+}
+
 /**
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, size_t page_size, const DbFileOptions &options)
+    : DiskManager(page_size) {
+  file_name_ = db_file;
+  if (!OpenLogFile()) {
+    return;
+  }
+  LoadFileHeader(options);
+  if (options.double_write_) {
+    LOG_WARN("the double-write buffer needs a disk manager that syncs, %s is written without one", db_file.c_str());
+  }
+
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
+  // directory or file does not exist
+  if (!db_io_.is_open()) {
+    db_io_.clear();
+    // create a new file
+    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
+    if (!db_io_.is_open()) {
+      throw Exception("can't open db file");
+    }
+  }
+  buffer_used = nullptr;
+}
+
+DiskManager::~DiskManager() = default;
+
+/**
+ * Private helper function to open/create the log file that goes with the database file
+ */
+auto DiskManager::OpenLogFile() -> bool {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
-    return;
+    return false;
   }
   log_name_ = file_name_.substr(0, n) + ".log";
 
@@ -48,19 +153,170 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
       throw Exception("can't open dblog file");
     }
   }
+  return true;
+}
 
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
+/**
+ * Private helper function to create the header of a new database file, or to read the page size of an existing one.
+ * An existing file without a header is a database from before there was one.
+ */
+void DiskManager::LoadFileHeader(const DbFileOptions &options) {
+  int fd = open(file_name_.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    throw Exception("can't open db file");
+  }
+  alignas(DbFileHeader) char block[DB_FILE_HEADER_SIZE];
+  auto *header = reinterpret_cast<DbFileHeader *>(block);
+  const ssize_t read_count = pread(fd, block, DB_FILE_HEADER_SIZE, 0);
+  if (read_count == 0) {
+    memset(block, 0, DB_FILE_HEADER_SIZE);
+    memcpy(header->magic_, DB_FILE_MAGIC, sizeof(DB_FILE_MAGIC));
+    header->version_ = DB_FILE_VERSION;
+    header->page_size_ = page_size_;
+    header->flags_ = options.checksums_ ? DB_FILE_CHECKSUMS : 0;
+    header->free_space_map_ = INVALID_PAGE_ID;
+    checksums_ = options.checksums_;
+    const bool written = pwrite(fd, block, DB_FILE_HEADER_SIZE, 0) == static_cast<ssize_t>(DB_FILE_HEADER_SIZE);
+    close(fd);
+    if (!written) {
+      throw Exception("can't write the header of db file " + file_name_);
     }
+    has_file_header_ = true;
+    return;
   }
-  buffer_used = nullptr;
+  struct stat stat_buf;
+  if (read_count < 0 || fstat(fd, &stat_buf) != 0) {
+    close(fd);
+    throw Exception("can't read the header of db file " + file_name_);
+  }
+  const bool has_magic = read_count == static_cast<ssize_t>(DB_FILE_HEADER_SIZE) &&
+                         memcmp(header->magic_, DB_FILE_MAGIC, sizeof(DB_FILE_MAGIC)) == 0;
+  if (!has_magic && static_cast<size_t>(stat_buf.st_size) % BUSTUB_PAGE_SIZE == 0) {
+    // A file from before there was a header: 4KB pages from offset 0, no checksums and no saved free-space map.
+    if (page_size_ != BUSTUB_PAGE_SIZE) {
+      LOG_DEBUG("%s has no header, it is opened with %d byte pages", file_name_.c_str(), BUSTUB_PAGE_SIZE);
+    }
+    page_size_ = BUSTUB_PAGE_SIZE;
+    header_size_ = 0;
+    checksums_ = false;
+  } else if (!has_magic || header->version_ != DB_FILE_VERSION || !IsValidPageSize(header->page_size_)) {
+    close(fd);
+    throw Exception(file_name_ + " is not a database file");
+  } else {
+    if (header->page_size_ != page_size_) {
+      LOG_DEBUG("%s was created with %u byte pages", file_name_.c_str(), header->page_size_);
+    }
+    page_size_ = header->page_size_;
+    checksums_ = (header->flags_ & DB_FILE_CHECKSUMS) != 0;
+  }
+
+  // Repair the pages whose write may have been torn by a crash, before anyone reads them.
+  const std::string double_write_file = DoubleWriteFileName();
+  auto restore_page = [&](page_id_t page_id, const char *page_data) {
+    const auto offset = static_cast<off_t>(PageOffset(page_id));
+    if (pwrite(fd, page_data, page_size_, offset) != static_cast<ssize_t>(page_size_)) {
+      LOG_WARN("I/O error while restoring page %d of %s", page_id, file_name_.c_str());
+    }
+  };
+  const size_t restored = DoubleWriteBuffer::Recover(double_write_file, page_size_, restore_page);
+  if (restored > 0) {
+    LOG_INFO("restored %zu pages of %s from its double-write buffer", restored, file_name_.c_str());
+    fdatasync(fd);
+  }
+  unlink(double_write_file.c_str());
+
+  has_file_header_ = has_magic;
+  if (fstat(fd, &stat_buf) == 0 && static_cast<size_t>(stat_buf.st_size) > header_size_) {
+    next_page_id_ = static_cast<page_id_t>((static_cast<size_t>(stat_buf.st_size) - header_size_ + page_size_ - 1) /
+                                           page_size_);
+  }
+  if (has_file_header_ && (header->flags_ & DB_FILE_FREE_SPACE_MAP) != 0) {
+    LoadFreeSpaceMap(fd, header->free_space_map_, header->num_free_pages_);
+  }
+  close(fd);
+}
+
+void DiskManager::LoadFreeSpaceMap(int fd, page_id_t first_map_page, uint32_t num_free_pages) {
+  const size_t ids_per_page = (page_size_ - sizeof(FreeSpaceMapPage)) / sizeof(page_id_t);
+  std::vector<char> buffer(page_size_);
+  const auto *map_page = reinterpret_cast<const FreeSpaceMapPage *>(buffer.data());
+  std::set<page_id_t> free_pages;
+  size_t num_listed = 0;
+  for (page_id_t page_id = first_map_page; page_id != INVALID_PAGE_ID; page_id = map_page->next_page_id_) {
+    // Every page of the map lists at least one page, which bounds the walk even if the chain loops.
+    const bool valid =
+        page_id >= 0 && page_id < next_page_id_ && num_listed < num_free_pages &&
+        pread(fd, buffer.data(), page_size_, static_cast<off_t>(PageOffset(page_id))) ==
+            static_cast<ssize_t>(page_size_) &&
+        memcmp(map_page->magic_, FREE_SPACE_MAP_MAGIC, sizeof(FREE_SPACE_MAP_MAGIC)) == 0 &&
+        map_page->num_pages_ > 0 && map_page->num_pages_ <= ids_per_page &&
+        map_page->checksum_ == FreeSpaceMapChecksum(buffer.data(), map_page->num_pages_);
+    if (!valid) {
+      LOG_WARN("the free-space map of %s is damaged, its free pages are not reused", file_name_.c_str());
+      return;
+    }
+    const auto *ids = reinterpret_cast<const page_id_t *>(buffer.data() + sizeof(FreeSpaceMapPage));
+    for (uint32_t i = 0; i < map_page->num_pages_; i++) {
+      // Free pages past the end of the file are not worth keeping, they are handed out next anyway.
+      if (ids[i] >= 0 && ids[i] < next_page_id_) {
+        free_pages.insert(ids[i]);
+      }
+    }
+    num_listed += map_page->num_pages_;
+  }
+  if (num_listed != num_free_pages) {
+    LOG_WARN("the free-space map of %s is incomplete, its free pages are not reused", file_name_.c_str());
+    return;
+  }
+  free_pages_ = std::move(free_pages);
+  free_space_map_saved_ = true;
+}
+
+auto DiskManager::DoubleWriteFileName() const -> std::string {
+  return file_name_.substr(0, file_name_.rfind('.')) + ".dwb";
+}
+
+auto DiskManager::ScratchBuffer() -> char * {
+  thread_local AlignedPageBuffer buffer;
+  return buffer.data_;
+}
+
+auto DiskManager::PrepareWrite(page_id_t page_id, const char *page_data) const -> const char * {
+  if (!checksums_) {
+    return page_data;
+  }
+  // Stamp a copy: the caller's buffer may be read-latched only, and it must not change between the checksum and the
+  // write anyway.
+  char *buffer = ScratchBuffer();
+  memcpy(buffer, page_data, page_size_);
+  StampChecksum(page_id, buffer);
+  return buffer;
+}
+
+void DiskManager::StampChecksum(page_id_t page_id, char *page_data) const {
+  const uint32_t checksum = PageChecksum(page_id, page_data, page_size_);
+  memcpy(page_data + page_size_ - PAGE_CHECKSUM_SIZE, &checksum, sizeof(checksum));
+  memcpy(page_data + page_size_ - PAGE_CHECKSUM_SIZE + sizeof(checksum), &page_id, sizeof(page_id));
+}
+
+void DiskManager::VerifyChecksum(page_id_t page_id, const char *page_data) const {
+  uint32_t checksum;
+  page_id_t stamped_page_id;
+  memcpy(&checksum, page_data + page_size_ - PAGE_CHECKSUM_SIZE, sizeof(checksum));
+  memcpy(&stamped_page_id, page_data + page_size_ - PAGE_CHECKSUM_SIZE + sizeof(checksum), sizeof(stamped_page_id));
+  if (stamped_page_id == page_id && checksum == PageChecksum(page_id, page_data, page_size_)) {
+    return;
+  }
+  if (page_data[0] == 0 && memcmp(page_data, page_data + 1, page_size_ - 1) == 0) {
+    // never written
+    return;
+  }
+  if (stamped_page_id != page_id) {
+    throw PageCorruptionException(page_id, "page " + std::to_string(page_id) + " of " + file_name_ +
+                                               " holds page " + std::to_string(stamped_page_id));
+  }
+  throw PageCorruptionException(page_id, "page " + std::to_string(page_id) + " of " + file_name_ +
+                                             " fails its checksum");
 }
 
 /**
@@ -74,19 +330,31 @@ void DiskManager::ShutDown() {
   log_io_.close();
 }
 
+/**
+ * Every write is already flushed to the file stream, so there is nothing left to do beyond a final flush
+ */
+void DiskManager::Sync() {
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  if (db_io_.is_open()) {
+    db_io_.flush();
+  }
+}
+
 /**
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
+  ScopedLatency latency(&write_latency_);
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
+  size_t offset = PageOffset(page_id);
   // set write cursor to offset
   num_writes_ += 1;
   db_io_.seekp(offset);
-  db_io_.write(page_data, BUSTUB_PAGE_SIZE);
+  db_io_.write(PrepareWrite(page_id, page_data), page_size_);
   // check for I/O error
   if (db_io_.bad()) {
-    LOG_DEBUG("I/O error while writing");
+    LOG_ERROR("I/O error while writing page %d of %s", page_id, file_name_.c_str());
+    db_io_.clear();
     return;
   }
   // needs to flush to keep disk file in sync
@@ -97,31 +365,48 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  ScopedLatency latency(&read_latency_);
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * BUSTUB_PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, BUSTUB_PAGE_SIZE);
-    if (db_io_.bad()) {
-      LOG_DEBUG("I/O error while reading");
-      return;
-    }
-    // if file ends before reading BUSTUB_PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < BUSTUB_PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
-    }
+  size_t offset = PageOffset(page_id);
+  // a page past the end of the file was allocated but never written, it reads as zeros like the rest of a short page
+  if (static_cast<int64_t>(offset) >= GetFileSize(file_name_)) {
+    memset(page_data, 0, page_size_);
+    return;
+  }
+  // set read cursor to offset
+  db_io_.seekp(offset);
+  db_io_.read(page_data, page_size_);
+  if (db_io_.bad()) {
+    db_io_.clear();
+    throw IOException("I/O error while reading page " + std::to_string(page_id) + " of " + file_name_);
+  }
+  // if file ends before reading a whole page
+  size_t read_count = db_io_.gcount();
+  if (read_count < page_size_) {
+    LOG_DEBUG("Read less than a page");
+    db_io_.clear();
+    memset(page_data + read_count, 0, page_size_ - read_count);
+  }
+  if (checksums_) {
+    VerifyChecksum(page_id, page_data);
   }
 }
 
+void DiskManager::WritePageAsync(page_id_t page_id, const char *page_data, std::promise<bool> callback) {
+  WritePage(page_id, page_data);
+  callback.set_value(true);
+}
+
+void DiskManager::ReadPageAsync(page_id_t page_id, char *page_data, std::promise<bool> callback) {
+  try {
+    ReadPage(page_id, page_data);
+  } catch (...) {
+    callback.set_exception(std::current_exception());
+    return;
+  }
+  callback.set_value(true);
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
@@ -202,10 +487,282 @@ auto DiskManager::GetFlushState() const -> bool { return flush_log_; }
 /**
  * Private helper function to get disk file size
  */
-auto DiskManager::GetFileSize(const std::string &file_name) -> int {
+auto DiskManager::GetNumPages() -> size_t {
+  if (file_name_.empty()) {
+    return 0;
+  }
+  const int64_t file_size = GetFileSize(file_name_);
+  if (file_size <= static_cast<int64_t>(header_size_)) {
+    return 0;
+  }
+  return (static_cast<size_t>(file_size) - header_size_ + page_size_ - 1) / page_size_;
+}
+
+auto DiskManager::AllocatePage(page_id_t hint, uint32_t stride, uint32_t residue, segment_id_t segment)
+    -> page_id_t {
+  std::scoped_lock latch(free_pages_latch_);
+  if (segment == INVALID_SEGMENT_ID && hint != INVALID_PAGE_ID) {
+    segment = SegmentOf(hint);
+  }
+  const page_id_t target = hint == INVALID_PAGE_ID ? 0 : hint;
+  page_id_t page_id = FindFreePage(FreePagesOf(segment), target, stride, residue);
+  // Any EXTENT_PAGES consecutive ids hold one of every residue up to that stride. With more buffer pool instances,
+  // the page is taken outside of the segment rather than adding extents that may have none for this instance.
+  if (page_id == INVALID_PAGE_ID && segment != INVALID_SEGMENT_ID && stride <= EXTENT_PAGES) {
+    const page_id_t extent = AddExtent(segment);
+    page_id = FindFreePage(FreePagesOf(segment), extent, stride, residue);
+  }
+  if (page_id == INVALID_PAGE_ID) {
+    segment = INVALID_SEGMENT_ID;
+    page_id = FindFreePage(free_pages_, target, stride, residue);
+  }
+
+  if (page_id == INVALID_PAGE_ID) {
+    // Extents never reach past next_page_id_, so the pages from there on are outside of every segment.
+    page_id = next_page_id_;
+    while (static_cast<uint32_t>(page_id) % stride != residue) {
+      free_pages_.insert(page_id++);
+    }
+    next_page_id_ = page_id + 1;
+    return page_id;
+  }
+
+  if (free_space_map_saved_) {
+    // The saved map is about to list a page in use: take it out of the header before the page can be written.
+    const int fd = open(file_name_.c_str(), O_RDWR);
+    if (fd < 0 || !WriteFreeSpaceMapHeader(fd, INVALID_PAGE_ID, 0)) {
+      LOG_WARN("can't drop the saved free-space map of %s", file_name_.c_str());
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+    free_space_map_saved_ = false;
+  }
+  FreePagesOf(segment).erase(page_id);
+  return page_id;
+}
+
+auto DiskManager::FindFreePage(const std::set<page_id_t> &pages, page_id_t target, uint32_t stride, uint32_t residue)
+    -> page_id_t {
+  auto usable = [stride, residue](page_id_t page_id) { return static_cast<uint32_t>(page_id) % stride == residue; };
+  // The closest free page at or after the target, unless one before it is closer.
+  const auto after = pages.lower_bound(target);
+  page_id_t page_id = INVALID_PAGE_ID;
+  for (auto it = after; it != pages.end(); ++it) {
+    if (usable(*it)) {
+      page_id = *it;
+      break;
+    }
+  }
+  for (auto it = after; it != pages.begin();) {
+    --it;
+    if (page_id != INVALID_PAGE_ID && target - *it >= page_id - target) {
+      break;
+    }
+    if (usable(*it)) {
+      page_id = *it;
+      break;
+    }
+  }
+  return page_id;
+}
+
+auto DiskManager::AddExtent(segment_id_t segment) -> page_id_t {
+  // The lowest extent whose pages are all free.
+  page_id_t first = INVALID_PAGE_ID;
+  for (const page_id_t page_id : free_pages_) {
+    if (page_id % EXTENT_PAGES == 0 && std::distance(free_pages_.lower_bound(page_id),
+                                                     free_pages_.lower_bound(page_id + EXTENT_PAGES)) == EXTENT_PAGES) {
+      first = page_id;
+      break;
+    }
+  }
+
+  auto &free_pages = segments_[segment].free_pages_;
+  if (first == INVALID_PAGE_ID) {
+    first = (next_page_id_ + EXTENT_PAGES - 1) / EXTENT_PAGES * EXTENT_PAGES;
+    for (page_id_t page_id = next_page_id_; page_id < first; page_id++) {
+      free_pages_.insert(page_id);
+    }
+    next_page_id_ = first + EXTENT_PAGES;
+  } else {
+    free_pages_.erase(free_pages_.lower_bound(first), free_pages_.lower_bound(first + EXTENT_PAGES));
+  }
+  for (page_id_t page_id = first; page_id < first + EXTENT_PAGES; page_id++) {
+    free_pages.insert(page_id);
+  }
+  segments_[segment].extents_.insert(first);
+  extent_segments_[first / EXTENT_PAGES] = segment;
+  return first;
+}
+
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  std::scoped_lock latch(free_pages_latch_);
+  if (page_id >= 0 && page_id < next_page_id_) {
+    FreePagesOf(SegmentOf(page_id)).insert(page_id);
+  }
+}
+
+auto DiskManager::IsAllocated(page_id_t page_id) -> bool {
+  std::scoped_lock latch(free_pages_latch_);
+  return page_id >= 0 && page_id < next_page_id_ && !IsFree(page_id);
+}
+
+auto DiskManager::CreateSegment() -> segment_id_t {
+  std::scoped_lock latch(free_pages_latch_);
+  const segment_id_t segment = next_segment_id_++;
+  segments_[segment];
+  return segment;
+}
+
+auto DiskManager::GetSegment(page_id_t page_id) -> segment_id_t {
+  std::scoped_lock latch(free_pages_latch_);
+  return SegmentOf(page_id);
+}
+
+auto DiskManager::GetSegmentExtents(segment_id_t segment) -> std::vector<page_id_t> {
+  std::scoped_lock latch(free_pages_latch_);
+  const auto it = segments_.find(segment);
+  if (it == segments_.end()) {
+    return {};
+  }
+  return {it->second.extents_.begin(), it->second.extents_.end()};
+}
+
+auto DiskManager::SegmentOf(page_id_t page_id) const -> segment_id_t {
+  const auto it = extent_segments_.find(page_id / EXTENT_PAGES);
+  return it == extent_segments_.end() ? INVALID_SEGMENT_ID : it->second;
+}
+
+auto DiskManager::FreePagesOf(segment_id_t segment) -> std::set<page_id_t> & {
+  return segment == INVALID_SEGMENT_ID ? free_pages_ : segments_[segment].free_pages_;
+}
+
+auto DiskManager::GetFreePages() -> std::vector<page_id_t> {
+  std::scoped_lock latch(free_pages_latch_);
+  std::vector<page_id_t> free_pages(free_pages_.begin(), free_pages_.end());
+  for (const auto &[segment, info] : segments_) {
+    free_pages.insert(free_pages.end(), info.free_pages_.begin(), info.free_pages_.end());
+  }
+  std::sort(free_pages.begin(), free_pages.end());
+  return free_pages;
+}
+
+void DiskManager::SaveFreeSpaceMap(const std::vector<page_id_t> &free_pages) {
+  std::scoped_lock latch(free_pages_latch_);
+  std::vector<page_id_t> still_free;
+  std::copy_if(free_pages.begin(), free_pages.end(), std::back_inserter(still_free),
+               [this](page_id_t page_id) { return IsFree(page_id); });
+  if (!has_file_header_ || (still_free.empty() && !free_space_map_saved_)) {
+    return;
+  }
+  const int fd = open(file_name_.c_str(), O_RDWR);
+  if (fd < 0) {
+    return;
+  }
+  WriteFreeSpaceMap(fd, still_free);
+  close(fd);
+}
+
+auto DiskManager::Vacuum(const std::vector<page_id_t> &free_pages) -> size_t {
+  std::scoped_lock latch(free_pages_latch_);
+  std::vector<page_id_t> still_free;
+  std::copy_if(free_pages.begin(), free_pages.end(), std::back_inserter(still_free),
+               [this](page_id_t page_id) { return IsFree(page_id); });
+  std::sort(still_free.begin(), still_free.end());
+  // The extents of segments stay, even when they are empty.
+  while (!still_free.empty() && still_free.back() == next_page_id_ - 1 &&
+         SegmentOf(still_free.back()) == INVALID_SEGMENT_ID) {
+    free_pages_.erase(still_free.back());
+    still_free.pop_back();
+    next_page_id_--;
+  }
+  if (!has_file_header_) {
+    return 0;
+  }
+  const int fd = open(file_name_.c_str(), O_RDWR);
+  if (fd < 0) {
+    return 0;
+  }
+  // The map is saved first, so that it never points past the end of the file.
+  WriteFreeSpaceMap(fd, still_free);
+  size_t truncated = 0;
+  struct stat stat_buf;
+  const auto size = static_cast<off_t>(PageOffset(next_page_id_));
+  if (fstat(fd, &stat_buf) == 0 && stat_buf.st_size > size) {
+    if (ftruncate(fd, size) == 0 && fdatasync(fd) == 0) {
+      truncated = (static_cast<size_t>(stat_buf.st_size - size) + page_size_ - 1) / page_size_;
+    } else {
+      LOG_WARN("can't truncate %s", file_name_.c_str());
+    }
+  }
+  close(fd);
+  return truncated;
+}
+
+void DiskManager::WriteFreeSpaceMap(int fd, const std::vector<page_id_t> &free_pages) {
+  // The map is stored in the first of the pages it lists.
+  const size_t ids_per_page = (page_size_ - sizeof(FreeSpaceMapPage)) / sizeof(page_id_t);
+  const size_t num_map_pages = (free_pages.size() + ids_per_page - 1) / ids_per_page;
+  std::vector<char> buffer(num_map_pages * page_size_);
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  for (size_t i = 0; i < num_map_pages; i++) {
+    char *data = buffer.data() + i * page_size_;
+    auto *map_page = reinterpret_cast<FreeSpaceMapPage *>(data);
+    const size_t first_id = i * ids_per_page;
+    const auto num_ids = static_cast<uint32_t>(std::min(ids_per_page, free_pages.size() - first_id));
+    memcpy(map_page->magic_, FREE_SPACE_MAP_MAGIC, sizeof(FREE_SPACE_MAP_MAGIC));
+    map_page->next_page_id_ = i + 1 < num_map_pages ? free_pages[i + 1] : INVALID_PAGE_ID;
+    map_page->num_pages_ = num_ids;
+    memcpy(data + sizeof(FreeSpaceMapPage), free_pages.data() + first_id, num_ids * sizeof(page_id_t));
+    map_page->checksum_ = FreeSpaceMapChecksum(data, num_ids);
+    pages.emplace_back(free_pages[i], data);
+  }
+  bool written = true;
+  auto write_page = [&](page_id_t page_id, const char *data) {
+    written = written && pwrite(fd, data, page_size_, static_cast<off_t>(PageOffset(page_id))) ==
+                             static_cast<ssize_t>(page_size_);
+  };
+  // Map pages are torn like any other page, so they go through the double-write buffer too.
+  if (double_write_ != nullptr) {
+    double_write_->Write(pages, write_page);
+  } else {
+    for (const auto &[page_id, data] : pages) {
+      write_page(page_id, data);
+    }
+  }
+  // The map must be durable before the header points to it.
+  written = written && fdatasync(fd) == 0 &&
+            WriteFreeSpaceMapHeader(fd, free_pages.empty() ? INVALID_PAGE_ID : free_pages.front(),
+                                    static_cast<uint32_t>(free_pages.size()));
+  if (!written) {
+    // A map the header still points to stays valid: none of its pages was reused, or it would have been dropped.
+    LOG_WARN("can't save the free-space map of %s", file_name_.c_str());
+    return;
+  }
+  free_space_map_saved_ = !free_pages.empty();
+}
+
+auto DiskManager::WriteFreeSpaceMapHeader(int fd, page_id_t first_map_page, uint32_t num_free_pages) -> bool {
+  alignas(DbFileHeader) char block[DB_FILE_HEADER_SIZE];
+  auto *header = reinterpret_cast<DbFileHeader *>(block);
+  if (pread(fd, block, DB_FILE_HEADER_SIZE, 0) != static_cast<ssize_t>(DB_FILE_HEADER_SIZE)) {
+    return false;
+  }
+  if (first_map_page == INVALID_PAGE_ID) {
+    header->flags_ &= ~DB_FILE_FREE_SPACE_MAP;
+  } else {
+    header->flags_ |= DB_FILE_FREE_SPACE_MAP;
+  }
+  header->free_space_map_ = first_map_page;
+  header->num_free_pages_ = num_free_pages;
+  return pwrite(fd, block, DB_FILE_HEADER_SIZE, 0) == static_cast<ssize_t>(DB_FILE_HEADER_SIZE) && fdatasync(fd) == 0;
+}
+
+auto DiskManager::GetFileSize(const std::string &file_name) -> int64_t {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
 }
 
 }  // namespace bustub
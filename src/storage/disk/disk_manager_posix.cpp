@@ -0,0 +1,224 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.cpp
+//
+// Identification: src/storage/disk/disk_manager_posix.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_posix.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "storage/disk/double_write_buffer.h"
+
+namespace bustub {
+
+/**
+ * Constructor: open/create the database file & log file
+ */
+DiskManagerPosix::DiskManagerPosix(const std::string &db_file, bool direct_io, size_t page_size,
+                                   const DbFileOptions &options)
+    : DiskManager(page_size), direct_io_(direct_io) {
+  file_name_ = db_file;
+  if (!OpenLogFile()) {
+    return;
+  }
+  LoadFileHeader(options);
+
+  int flags = O_RDWR | O_CREAT;
+#ifdef O_DIRECT
+  if (direct_io_) {
+    db_fd_ = open(db_file.c_str(), flags | O_DIRECT, 0644);
+    if (db_fd_ < 0 && errno == EINVAL) {
+      LOG_WARN("O_DIRECT is not supported for %s, falling back to buffered I/O", db_file.c_str());
+      direct_io_ = false;
+    }
+  }
+#else
+  direct_io_ = false;
+#endif
+  if (db_fd_ < 0) {
+    db_fd_ = open(db_file.c_str(), flags, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  if (options.double_write_) {
+    double_write_ = std::make_unique<DoubleWriteBuffer>(DoubleWriteFileName(), page_size_, [this] { Sync(); });
+  }
+}
+
+DiskManagerPosix::~DiskManagerPosix() {
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
+}
+
+/**
+ * Close the database file descriptor and the log file stream
+ */
+void DiskManagerPosix::ShutDown() {
+  if (double_write_ != nullptr && db_fd_ >= 0) {
+    // Every page written through the buffer is in place, once it is durable the buffer has nothing left to protect.
+    Sync();
+    double_write_.reset();
+    unlink(DoubleWriteFileName().c_str());
+  }
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
+  DiskManager::ShutDown();
+}
+
+void DiskManagerPosix::Sync() {
+  if (fdatasync(db_fd_) != 0) {
+    LOG_ERROR("I/O error while syncing %s: %s", file_name_.c_str(), strerror(errno));
+  }
+}
+
+auto DiskManagerPosix::CanUseBuffer(const char *page_data) const -> bool {
+  return !direct_io_ || reinterpret_cast<uintptr_t>(page_data) % BUSTUB_PAGE_ALIGNMENT == 0;
+}
+
+/**
+ * Write the contents of the specified page into disk file
+ */
+void DiskManagerPosix::WritePage(page_id_t page_id, const char *page_data) {
+  ScopedLatency latency(&write_latency_);
+  const char *buffer = PrepareWrite(page_id, page_data);
+  num_writes_ += 1;
+  if (double_write_ != nullptr) {
+    double_write_->Write({{page_id, buffer}}, [this](page_id_t id, const char *data) { WriteToFile(id, data); });
+  } else {
+    WriteToFile(page_id, buffer);
+  }
+}
+
+void DiskManagerPosix::WriteToFile(page_id_t page_id, const char *data) {
+  const auto offset = static_cast<off_t>(PageOffset(page_id));
+  const char *buffer = data;
+  if (!CanUseBuffer(data)) {
+    char *bounce = ScratchBuffer();
+    memcpy(bounce, data, page_size_);
+    buffer = bounce;
+  }
+
+  size_t written = 0;
+  while (written < page_size_) {
+    ssize_t rc = pwrite(db_fd_, buffer + written, page_size_ - written, offset + written);
+    if (rc < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_ERROR("I/O error while writing page %d of %s: %s", page_id, file_name_.c_str(), strerror(errno));
+      return;
+    }
+    written += rc;
+  }
+}
+
+/**
+ * Read the contents of the specified page into the given memory area
+ */
+void DiskManagerPosix::ReadPage(page_id_t page_id, char *page_data) {
+  ScopedLatency latency(&read_latency_);
+  const auto offset = static_cast<off_t>(PageOffset(page_id));
+  char *buffer = CanUseBuffer(page_data) ? page_data : ScratchBuffer();
+
+  size_t read_count = 0;
+  while (read_count < page_size_) {
+    ssize_t rc = pread(db_fd_, buffer + read_count, page_size_ - read_count, offset + read_count);
+    if (rc < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw IOException("I/O error while reading page " + std::to_string(page_id) + " of " + file_name_ + ": " +
+                        strerror(errno));
+    }
+    if (rc == 0) {
+      // the file ends before the page does
+      break;
+    }
+    read_count += rc;
+  }
+  if (read_count < page_size_) {
+    memset(buffer + read_count, 0, page_size_ - read_count);
+  }
+  if (buffer != page_data) {
+    memcpy(page_data, buffer, page_size_);
+  }
+  if (checksums_) {
+    VerifyChecksum(page_id, page_data);
+  }
+}
+
+void DiskManagerPosix::WritePageAsync(page_id_t page_id, const char *page_data, std::promise<bool> callback) {
+  if (double_write_ == nullptr) {
+    DiskManager::WritePageAsync(page_id, page_data, std::move(callback));
+    return;
+  }
+  std::scoped_lock lock(pending_latch_);
+  pending_writes_[std::this_thread::get_id()].push_back(PendingWrite{page_id, page_data, std::move(callback)});
+}
+
+void DiskManagerPosix::ReadPageAsync(page_id_t page_id, char *page_data, std::promise<bool> callback) {
+  // A write held back by this thread may be for the same page.
+  SubmitPageRequests();
+  DiskManager::ReadPageAsync(page_id, page_data, std::move(callback));
+}
+
+void DiskManagerPosix::SubmitPageRequests() {
+  if (double_write_ == nullptr) {
+    return;
+  }
+  std::vector<PendingWrite> writes;
+  {
+    std::scoped_lock lock(pending_latch_);
+    auto it = pending_writes_.find(std::this_thread::get_id());
+    if (it == pending_writes_.end()) {
+      return;
+    }
+    writes = std::move(it->second);
+    pending_writes_.erase(it);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  // Each page of the batch needs its own stamped copy, the scratch buffer holds only one.
+  std::vector<char> stamped(checksums_ ? writes.size() * page_size_ : 0);
+  std::vector<std::pair<page_id_t, const char *>> pages;
+  pages.reserve(writes.size());
+  for (size_t i = 0; i < writes.size(); i++) {
+    const char *data = writes[i].data_;
+    if (checksums_) {
+      char *copy = stamped.data() + i * page_size_;
+      memcpy(copy, data, page_size_);
+      StampChecksum(writes[i].page_id_, copy);
+      data = copy;
+    }
+    pages.emplace_back(writes[i].page_id_, data);
+  }
+  num_writes_ += writes.size();
+  double_write_->Write(pages, [this](page_id_t id, const char *data) { WriteToFile(id, data); });
+
+  for (auto &write : writes) {
+    write_latency_.Record(std::chrono::steady_clock::now() - start);
+    write.callback_.set_value(true);
+  }
+}
+
+}  // namespace bustub
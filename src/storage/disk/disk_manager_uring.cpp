@@ -0,0 +1,455 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.cpp
+//
+// Identification: src/storage/disk/disk_manager_uring.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_uring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define BUSTUB_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace bustub {
+
+#ifdef BUSTUB_HAS_IO_URING
+
+namespace {
+
+/** user_data of the no-op that tells the completion thread to exit. */
+constexpr uint64_t SHUTDOWN_USER_DATA = UINT64_MAX;
+
+auto IoUringSetup(uint32_t entries, io_uring_params *params) -> int {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+auto IoUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) -> int {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+auto IoUringRegister(int ring_fd, unsigned opcode, void *arg, unsigned nr_args) -> int {
+  return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+template <class T>
+auto RingField(void *ring, uint32_t offset) -> T * {
+  return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+}
+
+}  // namespace
+
+DiskManagerUring::DiskManagerUring(const std::string &db_file, bool direct_io, uint32_t queue_depth,
+                                   size_t page_size, const DbFileOptions &options)
+    : DiskManagerPosix(db_file, direct_io, page_size, options) {
+  if (db_fd_ >= 0 && !SetUpRing(queue_depth)) {
+    LOG_WARN("io_uring is not available, falling back to pread/pwrite");
+  }
+}
+
+auto DiskManagerUring::SetUpRing(uint32_t queue_depth) -> bool {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int ring_fd = IoUringSetup(queue_depth, &params);
+  if (ring_fd < 0) {
+    return false;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+
+  sq_ring_ptr_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                      IORING_OFF_SQ_RING);
+  if (sq_ring_ptr_ == MAP_FAILED) {
+    sq_ring_ptr_ = nullptr;
+    close(ring_fd);
+    return false;
+  }
+  if (single_mmap) {
+    cq_ring_ptr_ = sq_ring_ptr_;
+  } else {
+    cq_ring_ptr_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                        IORING_OFF_CQ_RING);
+    if (cq_ring_ptr_ == MAP_FAILED) {
+      cq_ring_ptr_ = nullptr;
+      munmap(sq_ring_ptr_, sq_ring_size_);
+      sq_ring_ptr_ = nullptr;
+      close(ring_fd);
+      return false;
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    if (cq_ring_ptr_ != sq_ring_ptr_) {
+      munmap(cq_ring_ptr_, cq_ring_size_);
+    }
+    munmap(sq_ring_ptr_, sq_ring_size_);
+    sq_ring_ptr_ = cq_ring_ptr_ = nullptr;
+    close(ring_fd);
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+  sq_tail_ = RingField<unsigned>(sq_ring_ptr_, params.sq_off.tail);
+  sq_mask_ = RingField<unsigned>(sq_ring_ptr_, params.sq_off.ring_mask);
+  sq_array_ = RingField<unsigned>(sq_ring_ptr_, params.sq_off.array);
+  cq_head_ = RingField<unsigned>(cq_ring_ptr_, params.cq_off.head);
+  cq_tail_ = RingField<unsigned>(cq_ring_ptr_, params.cq_off.tail);
+  cq_mask_ = RingField<unsigned>(cq_ring_ptr_, params.cq_off.ring_mask);
+  cqes_ = RingField<io_uring_cqe>(cq_ring_ptr_, params.cq_off.cqes);
+
+  // Every in-flight request holds a slot until its completion is reaped, so neither ring can overflow.
+  slots_.resize(params.sq_entries);
+  free_slots_.reserve(params.sq_entries);
+  for (uint32_t i = params.sq_entries; i > 0; i--) {
+    free_slots_.push_back(i - 1);
+  }
+  if (checksums_) {
+    staging_ = new (std::align_val_t{BUSTUB_PAGE_ALIGNMENT}) char[params.sq_entries * page_size_];
+  }
+
+  ring_fd_ = ring_fd;
+  reaper_ = std::thread([this] { ReapCompletions(); });
+  return true;
+}
+
+DiskManagerUring::~DiskManagerUring() { TearDownRing(); }
+
+void DiskManagerUring::ShutDown() {
+  TearDownRing();
+  DiskManagerPosix::ShutDown();
+}
+
+void DiskManagerUring::TearDownRing() {
+  if (ring_fd_ < 0) {
+    return;
+  }
+  {
+    std::scoped_lock lock(latch_);
+    SubmitPendingLocked();
+    io_uring_sqe *sqe = NextSqe();
+    sqe->opcode = IORING_OP_NOP;
+    sqe->user_data = SHUTDOWN_USER_DATA;
+    // Complete only after everything submitted before it.
+    sqe->flags = IOSQE_IO_DRAIN;
+    pending_submissions_++;
+    SubmitPendingLocked();
+  }
+  reaper_.join();
+
+  munmap(sqes_, sqes_size_);
+  if (cq_ring_ptr_ != sq_ring_ptr_) {
+    munmap(cq_ring_ptr_, cq_ring_size_);
+  }
+  munmap(sq_ring_ptr_, sq_ring_size_);
+  sqes_ = nullptr;
+  sq_ring_ptr_ = cq_ring_ptr_ = nullptr;
+  close(ring_fd_);
+  ring_fd_ = -1;
+  buffer_index_.clear();
+  if (staging_ != nullptr) {
+    ::operator delete[](staging_, std::align_val_t{BUSTUB_PAGE_ALIGNMENT});
+    staging_ = nullptr;
+  }
+}
+
+auto DiskManagerUring::NextSqe() -> io_uring_sqe * {
+  // We are the only producer. The kernel consumes entries on io_uring_enter, and every unsubmitted entry holds a slot
+  // (or is the shutdown no-op), so the entry at the tail is free.
+  const unsigned tail = *sq_tail_;
+  const unsigned index = tail & *sq_mask_;
+  io_uring_sqe *sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  return sqe;
+}
+
+void DiskManagerUring::SubmitPendingLocked() {
+  while (pending_submissions_ > 0) {
+    int submitted = IoUringEnter(ring_fd_, pending_submissions_, 0, 0);
+    if (submitted < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        continue;
+      }
+      LOG_DEBUG("io_uring_enter failed: %s", strerror(errno));
+      return;
+    }
+    pending_submissions_ -= submitted;
+  }
+}
+
+void DiskManagerUring::PrepareRequest(bool is_write, page_id_t page_id, char *data, std::promise<bool> callback) {
+  std::unique_lock lock(latch_);
+  if (free_slots_.empty()) {
+    // Our own unsubmitted requests may be the ones holding the slots.
+    SubmitPendingLocked();
+    slot_freed_.wait(lock, [&] { return !free_slots_.empty(); });
+  }
+  const uint32_t slot = free_slots_.back();
+  free_slots_.pop_back();
+  if (is_write && checksums_) {
+    char *staging = staging_ + static_cast<size_t>(slot) * page_size_;
+    memcpy(staging, data, page_size_);
+    StampChecksum(page_id, staging);
+    data = staging;
+  }
+  slots_[slot] = InFlightRequest{is_write, page_id, data, std::move(callback), std::chrono::steady_clock::now()};
+
+  io_uring_sqe *sqe = NextSqe();
+  auto it = buffer_index_.find(data);
+  if (it != buffer_index_.end()) {
+    sqe->opcode = is_write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+    sqe->buf_index = it->second;
+  } else {
+    sqe->opcode = is_write ? IORING_OP_WRITE : IORING_OP_READ;
+  }
+  sqe->fd = db_fd_;
+  sqe->addr = reinterpret_cast<uint64_t>(data);
+  sqe->len = page_size_;
+  sqe->off = PageOffset(page_id);
+  sqe->user_data = slot;
+  if (in_flight_pages_[page_id]++ > 0) {
+    // Do not start before the earlier requests on this page (and everything else before it) have completed.
+    sqe->flags |= IOSQE_IO_DRAIN;
+  }
+  pending_submissions_++;
+}
+
+void DiskManagerUring::WritePageAsync(page_id_t page_id, const char *page_data, std::promise<bool> callback) {
+  if (double_write_ != nullptr) {
+    DiskManagerPosix::WritePageAsync(page_id, page_data, std::move(callback));
+    return;
+  }
+  // A checksummed write is staged, which takes care of the alignment.
+  if (ring_fd_ < 0 || (!checksums_ && !CanUseBuffer(page_data))) {
+    DiskManagerPosix::WritePage(page_id, page_data);
+    callback.set_value(true);
+    return;
+  }
+  num_writes_ += 1;
+  PrepareRequest(true, page_id, const_cast<char *>(page_data), std::move(callback));  // NOLINT
+}
+
+void DiskManagerUring::ReadPageAsync(page_id_t page_id, char *page_data, std::promise<bool> callback) {
+  // A write held back for the double-write buffer by this thread may be for the same page.
+  DiskManagerPosix::SubmitPageRequests();
+  if (ring_fd_ < 0 || !CanUseBuffer(page_data)) {
+    try {
+      DiskManagerPosix::ReadPage(page_id, page_data);
+    } catch (...) {
+      callback.set_exception(std::current_exception());
+      return;
+    }
+    callback.set_value(true);
+    return;
+  }
+  PrepareRequest(false, page_id, page_data, std::move(callback));
+}
+
+void DiskManagerUring::SubmitPageRequests() {
+  DiskManagerPosix::SubmitPageRequests();
+  if (ring_fd_ < 0) {
+    return;
+  }
+  std::scoped_lock lock(latch_);
+  SubmitPendingLocked();
+}
+
+void DiskManagerUring::WritePage(page_id_t page_id, const char *page_data) {
+  std::promise<bool> promise;
+  auto future = promise.get_future();
+  WritePageAsync(page_id, page_data, std::move(promise));
+  SubmitPageRequests();
+  future.get();
+}
+
+void DiskManagerUring::ReadPage(page_id_t page_id, char *page_data) {
+  std::promise<bool> promise;
+  auto future = promise.get_future();
+  ReadPageAsync(page_id, page_data, std::move(promise));
+  SubmitPageRequests();
+  future.get();
+}
+
+void DiskManagerUring::ReapCompletions() {
+  while (true) {
+    unsigned head = *cq_head_;
+    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+      if (IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+        LOG_DEBUG("io_uring_enter failed: %s", strerror(errno));
+      }
+      continue;
+    }
+
+    bool stop = false;
+    for (; head != tail; head++) {
+      const io_uring_cqe &cqe = cqes_[head & *cq_mask_];
+      if (cqe.user_data == SHUTDOWN_USER_DATA) {
+        stop = true;
+        continue;
+      }
+      CompleteRequest(static_cast<uint32_t>(cqe.user_data), cqe.res);
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    if (stop) {
+      return;
+    }
+  }
+}
+
+void DiskManagerUring::CompleteRequest(uint32_t slot, int result) {
+  InFlightRequest request;
+  {
+    std::scoped_lock lock(latch_);
+    request = std::move(slots_[slot]);
+  }
+
+  std::exception_ptr error;
+  try {
+    if (result != static_cast<int>(page_size_) && (request.is_write_ || result < 0)) {
+      // The retry records its own latency, and verifies the checksum of a read.
+      LOG_DEBUG("io_uring request on page %d returned %d, retrying with pread/pwrite", request.page_id_, result);
+      if (request.is_write_) {
+        DiskManagerPosix::WriteToFile(request.page_id_, request.data_);
+      } else {
+        DiskManagerPosix::ReadPage(request.page_id_, request.data_);
+      }
+    } else {
+      if (result != static_cast<int>(page_size_)) {
+        // the file ends before the page does
+        memset(request.data_ + result, 0, page_size_ - result);
+      }
+      (request.is_write_ ? write_latency_ : read_latency_).Record(std::chrono::steady_clock::now() - request.start_);
+      if (!request.is_write_ && checksums_) {
+        VerifyChecksum(request.page_id_, request.data_);
+      }
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  {
+    std::scoped_lock lock(latch_);
+    free_slots_.push_back(slot);
+    auto it = in_flight_pages_.find(request.page_id_);
+    if (--it->second == 0) {
+      in_flight_pages_.erase(it);
+    }
+  }
+  slot_freed_.notify_one();
+  if (error != nullptr) {
+    request.callback_.set_exception(error);
+  } else {
+    request.callback_.set_value(true);
+  }
+}
+
+void DiskManagerUring::RegisterPageBuffers(const std::vector<char *> &buffers) {
+  if (ring_fd_ < 0) {
+    return;
+  }
+  std::scoped_lock lock(latch_);
+  registered_buffers_.insert(registered_buffers_.end(), buffers.begin(), buffers.end());
+  UpdateRegisteredBuffersLocked();
+}
+
+void DiskManagerUring::UnregisterPageBuffers(const std::vector<char *> &buffers) {
+  if (ring_fd_ < 0) {
+    return;
+  }
+  std::scoped_lock lock(latch_);
+  for (char *buffer : buffers) {
+    auto it = std::find(registered_buffers_.begin(), registered_buffers_.end(), buffer);
+    if (it != registered_buffers_.end()) {
+      registered_buffers_.erase(it);
+    }
+  }
+  UpdateRegisteredBuffersLocked();
+}
+
+void DiskManagerUring::UpdateRegisteredBuffersLocked() {
+  if (!buffer_index_.empty()) {
+    IoUringRegister(ring_fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+    buffer_index_.clear();
+  }
+  if (registered_buffers_.empty() || registered_buffers_.size() > UINT16_MAX) {
+    return;
+  }
+
+  std::vector<iovec> iovecs;
+  iovecs.reserve(registered_buffers_.size());
+  for (char *buffer : registered_buffers_) {
+    iovecs.push_back({buffer, page_size_});
+  }
+  if (IoUringRegister(ring_fd_, IORING_REGISTER_BUFFERS, iovecs.data(), iovecs.size()) < 0) {
+    // e.g. too many buffers or RLIMIT_MEMLOCK, requests simply go through unregistered buffers
+    LOG_DEBUG("cannot register page buffers with io_uring: %s", strerror(errno));
+    return;
+  }
+  for (size_t i = 0; i < registered_buffers_.size(); i++) {
+    buffer_index_[registered_buffers_[i]] = static_cast<uint16_t>(i);
+  }
+}
+
+#else
+
+DiskManagerUring::DiskManagerUring(const std::string &db_file, bool direct_io, uint32_t queue_depth,
+                                   size_t page_size, const DbFileOptions &options)
+    : DiskManagerPosix(db_file, direct_io, page_size, options) {
+  LOG_WARN("io_uring is not available, falling back to pread/pwrite");
+}
+
+DiskManagerUring::~DiskManagerUring() = default;
+
+void DiskManagerUring::ShutDown() { DiskManagerPosix::ShutDown(); }
+
+void DiskManagerUring::WritePage(page_id_t page_id, const char *page_data) {
+  DiskManagerPosix::WritePage(page_id, page_data);
+}
+
+void DiskManagerUring::ReadPage(page_id_t page_id, char *page_data) { DiskManagerPosix::ReadPage(page_id, page_data); }
+
+void DiskManagerUring::WritePageAsync(page_id_t page_id, const char *page_data, std::promise<bool> callback) {
+  DiskManagerPosix::WritePageAsync(page_id, page_data, std::move(callback));
+}
+
+void DiskManagerUring::ReadPageAsync(page_id_t page_id, char *page_data, std::promise<bool> callback) {
+  DiskManagerPosix::ReadPageAsync(page_id, page_data, std::move(callback));
+}
+
+void DiskManagerUring::SubmitPageRequests() { DiskManagerPosix::SubmitPageRequests(); }
+
+void DiskManagerUring::RegisterPageBuffers(const std::vector<char *> &buffers) {}
+
+void DiskManagerUring::UnregisterPageBuffers(const std::vector<char *> &buffers) {}
+
+#endif
+
+}  // namespace bustub
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.cpp
+//
+// Identification: src/storage/disk/disk_scheduler.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_scheduler.h"
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+DiskScheduler::DiskScheduler(DiskManager *disk_manager, size_t num_workers) : disk_manager_(disk_manager) {
+  BUSTUB_ASSERT(num_workers > 0, "the disk scheduler needs at least one worker");
+  request_queues_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    request_queues_.emplace_back(std::make_unique<Channel<std::optional<DiskRequest>>>());
+  }
+  // Spawn the background threads
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back([&, i] { StartWorkerThread(i); });
+  }
+}
+
+DiskScheduler::~DiskScheduler() {
+  // Put a `std::nullopt` in every queue to signal to exit the loop
+  for (auto &queue : request_queues_) {
+    queue->Put(std::nullopt);
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void DiskScheduler::Schedule(DiskRequest r) {
+  BUSTUB_ASSERT(r.page_id_ >= 0, "cannot schedule a request on an invalid page");
+  auto &queue = request_queues_[static_cast<size_t>(r.page_id_) % request_queues_.size()];
+  queue->Put(std::make_optional(std::move(r)));
+}
+
+void DiskScheduler::StartWorkerThread(size_t worker_id) {
+  auto &queue = request_queues_[worker_id];
+  std::vector<std::optional<DiskRequest>> batch;
+  while (true) {
+    batch.clear();
+    queue->GetAll(&batch);
+    // The whole batch is handed to the disk manager before waiting for any of it, so a disk manager that supports
+    // asynchronous I/O keeps all of it in flight. The disk manager keeps requests on the same page in order.
+    bool stop = false;
+    size_t num_requests = 0;
+    for (auto &request : batch) {
+      if (!request.has_value()) {
+        // Nothing is scheduled after the stop signal.
+        stop = true;
+        break;
+      }
+      num_requests++;
+      if (request->is_write_) {
+        disk_manager_->WritePageAsync(request->page_id_, request->data_, std::move(request->callback_));
+      } else {
+        disk_manager_->ReadPageAsync(request->page_id_, request->data_, std::move(request->callback_));
+      }
+    }
+    if (num_requests > 0) {
+      disk_manager_->SubmitPageRequests();
+    }
+    if (stop) {
+      return;
+    }
+  }
+}
+
+}  // namespace bustub
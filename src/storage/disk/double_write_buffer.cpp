@@ -0,0 +1,171 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// double_write_buffer.cpp
+//
+// Identification: src/storage/disk/double_write_buffer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/double_write_buffer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <tuple>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/util/crc32c_util.h"
+
+namespace bustub {
+
+namespace {
+
+constexpr char DWB_FILE_MAGIC[8] = {'B', 'U', 'S', 'T', 'U', 'B', 'D', 'W'};
+
+auto WriteFully(int fd, const char *data, size_t size, off_t offset) -> bool {
+  size_t written = 0;
+  while (written < size) {
+    ssize_t rc = pwrite(fd, data + written, size - written, offset + written);
+    if (rc < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    written += rc;
+  }
+  return true;
+}
+
+auto ReadFully(int fd, char *data, size_t size, off_t offset) -> bool {
+  size_t read_count = 0;
+  while (read_count < size) {
+    ssize_t rc = pread(fd, data + read_count, size - read_count, offset + read_count);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      return false;
+    }
+    read_count += rc;
+  }
+  return true;
+}
+
+}  // namespace
+
+DoubleWriteBuffer::DoubleWriteBuffer(const std::string &file_name, size_t page_size, std::function<void()> sync_pages,
+                                     size_t num_slots)
+    : page_size_(page_size), num_slots_(num_slots), sync_pages_(std::move(sync_pages)) {
+  BUSTUB_ASSERT(num_slots_ > 0, "a double-write buffer needs slots");
+  fd_ = open(file_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0) {
+    throw Exception("can't open double-write buffer file " + file_name);
+  }
+  header_block_.resize(HeaderBlockSize(num_slots_));
+  FileHeader header;
+  memcpy(header.magic_, DWB_FILE_MAGIC, sizeof(DWB_FILE_MAGIC));
+  header.page_size_ = page_size_;
+  header.num_slots_ = num_slots_;
+  memcpy(header_block_.data(), &header, sizeof(header));
+}
+
+DoubleWriteBuffer::~DoubleWriteBuffer() { close(fd_); }
+
+auto DoubleWriteBuffer::HeaderBlockSize(size_t num_slots) -> size_t {
+  const size_t size = sizeof(FileHeader) + num_slots * sizeof(SlotHeader);
+  return (size + BUSTUB_PAGE_ALIGNMENT - 1) / BUSTUB_PAGE_ALIGNMENT * BUSTUB_PAGE_ALIGNMENT;
+}
+
+auto DoubleWriteBuffer::SlotChecksum(page_id_t page_id, uint64_t seq, const char *page_data, size_t page_size)
+    -> uint32_t {
+  uint32_t crc = Crc32cUtil::Checksum(reinterpret_cast<const char *>(&page_id), sizeof(page_id));
+  crc = Crc32cUtil::Checksum(reinterpret_cast<const char *>(&seq), sizeof(seq), crc);
+  return Crc32cUtil::Checksum(page_data, page_size, crc);
+}
+
+void DoubleWriteBuffer::Write(const std::vector<std::pair<page_id_t, const char *>> &pages,
+                              const PageWriter &write_page) {
+  std::scoped_lock lock(latch_);
+  auto *slot_headers = reinterpret_cast<SlotHeader *>(header_block_.data() + sizeof(FileHeader));
+  for (size_t done = 0; done < pages.size();) {
+    if (unsynced_slots_ == num_slots_) {
+      // Every slot protects a write that may not be durable yet.
+      sync_pages_();
+      unsynced_slots_ = 0;
+    }
+    // A batch fills consecutive slots, so that it is written with a single call.
+    const size_t count = std::min({pages.size() - done, num_slots_ - unsynced_slots_, num_slots_ - next_slot_});
+    staging_.resize(count * page_size_);
+    for (size_t i = 0; i < count; i++) {
+      const auto &[page_id, page_data] = pages[done + i];
+      memcpy(staging_.data() + i * page_size_, page_data, page_size_);
+      const uint64_t seq = next_seq_++;
+      slot_headers[next_slot_ + i] = SlotHeader{page_id, SlotChecksum(page_id, seq, page_data, page_size_), seq};
+    }
+    const auto slot_offset = static_cast<off_t>(header_block_.size() + next_slot_ * page_size_);
+    if (!WriteFully(fd_, staging_.data(), staging_.size(), slot_offset) ||
+        !WriteFully(fd_, header_block_.data(), header_block_.size(), 0) || fdatasync(fd_) != 0) {
+      LOG_ERROR("I/O error while writing the double-write buffer");
+    }
+    num_syncs_++;
+
+    for (size_t i = 0; i < count; i++) {
+      write_page(pages[done + i].first, pages[done + i].second);
+    }
+    next_slot_ = (next_slot_ + count) % num_slots_;
+    unsynced_slots_ += count;
+    done += count;
+  }
+}
+
+auto DoubleWriteBuffer::Recover(const std::string &file_name, size_t page_size, const PageWriter &write_page)
+    -> size_t {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return 0;
+  }
+  FileHeader header;
+  if (!ReadFully(fd, reinterpret_cast<char *>(&header), sizeof(header), 0) ||
+      memcmp(header.magic_, DWB_FILE_MAGIC, sizeof(DWB_FILE_MAGIC)) != 0 || header.page_size_ != page_size ||
+      header.num_slots_ == 0) {
+    close(fd);
+    return 0;
+  }
+  std::vector<char> header_block(HeaderBlockSize(header.num_slots_));
+  if (!ReadFully(fd, header_block.data(), header_block.size(), 0)) {
+    close(fd);
+    return 0;
+  }
+  const auto *slot_headers = reinterpret_cast<const SlotHeader *>(header_block.data() + sizeof(FileHeader));
+
+  // Load the intact slots, a slot that was being written when the crash happened fails its checksum.
+  std::vector<std::tuple<uint64_t, page_id_t, std::vector<char>>> intact;
+  std::vector<char> page(page_size);
+  for (size_t slot = 0; slot < header.num_slots_; slot++) {
+    const SlotHeader &slot_header = slot_headers[slot];
+    if (slot_header.seq_ == 0 ||
+        !ReadFully(fd, page.data(), page_size, static_cast<off_t>(header_block.size() + slot * page_size)) ||
+        SlotChecksum(slot_header.page_id_, slot_header.seq_, page.data(), page_size) != slot_header.checksum_) {
+      continue;
+    }
+    intact.emplace_back(slot_header.seq_, slot_header.page_id_, page);
+  }
+  close(fd);
+
+  std::sort(intact.begin(), intact.end(),
+            [](const auto &a, const auto &b) { return std::get<0>(a) < std::get<0>(b); });
+  for (const auto &[seq, page_id, data] : intact) {
+    write_page(page_id, data.data());
+  }
+  return intact.size();
+}
+
+}  // namespace bustub
@@ -1,10 +1,13 @@
+#include <algorithm>
 #include <sstream>
 #include <string>
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/macros.h"
 #include "common/rid.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_builder.h"
 
 namespace bustub {
 
@@ -14,33 +17,212 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPool
     : index_name_(std::move(name)),
       bpm_(buffer_pool_manager),
       comparator_(std::move(comparator)),
-      leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size),
+      leaf_max_size_(leaf_max_size > 0 ? leaf_max_size : LeafPage::Capacity(bpm_->GetUsablePageSize())),
+      internal_max_size_(internal_max_size > 0 ? internal_max_size
+                                               : InternalPage::Capacity(bpm_->GetUsablePageSize())),
       header_page_id_(header_page_id) {
+  BUSTUB_ENSURE(leaf_max_size_ <= LeafPage::Capacity(bpm_->GetUsablePageSize()),
+                "leaf_max_size does not fit in a page");
+  BUSTUB_ENSURE(internal_max_size_ <= InternalPage::Capacity(bpm_->GetUsablePageSize()),
+                "internal_max_size does not fit in a page");
   WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
-  auto root_page = guard.AsMut<BPlusTreeHeaderPage>();
+  auto root_page = guard.template AsMut<BPlusTreeHeaderPage>();
   root_page->root_page_id_ = INVALID_PAGE_ID;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() {
+  // Descents that had the pages pinned are over by now.
+  if (!undeleted_pages_.empty()) {
+    DeletePages({});
+  }
+}
+
 /*
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
+auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.template As<BPlusTreeHeaderPage>()->root_page_id_ == INVALID_PAGE_ID;
+}
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
+ * Return the values of every key whose columns equal those of input key,
+ * which are next to each other from the first key not less than it, and
+ * may span several leaves
  * This method is used for point query
  * @return : true means key exists
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
-  // Declaration of context instance.
-  Context ctx;
-  (void)ctx;
-  return false;
+  bool found = false;
+  for (auto iter = Begin(key); !iter.IsEnd() && comparator_.CompareColumns((*iter).first, key) == 0; ++iter) {
+    result->push_back((*iter).second);
+    found = true;
+  }
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafRead(const KeyType *key) -> std::optional<ReadPageGuard> {
+  std::optional<ReadPageGuard> leaf_guard;
+  for (int attempt = 0; attempt < OPTIMISTIC_READ_ATTEMPTS; attempt++) {
+    if (FindLeafOptimistic(key, &leaf_guard)) {
+      return leaf_guard;
+    }
+  }
+
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = guard.template As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return std::nullopt;
+  }
+  // The root is latched before the header is released.
+  ReadPageGuard root_guard = bpm_->FetchPageRead(page_id);
+  guard.Drop();
+  return DescendRead(std::move(root_guard), key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <class LeafGuard>
+auto BPLUSTREE_TYPE::FindLeafOptimistic(const KeyType *key, std::optional<LeafGuard> *leaf_guard) -> bool {
+  // The leaf may change while it is latched, but as long as its parent has not, it is still the one for key.
+  // A leaf whose parent did change is released before the descent restarts. It may even have been merged away and
+  // deleted, the buffer pool then has nothing to latch.
+  auto latch_leaf = [&](page_id_t page_id, const OptimisticPageGuard &parent_guard) {
+    LeafGuard latched;
+    if constexpr (std::is_same_v<LeafGuard, WritePageGuard>) {
+      latched = bpm_->FetchPageWrite(page_id);
+    } else {
+      latched = bpm_->FetchPageRead(page_id);
+    }
+    if (latched.IsEmpty() || !parent_guard.Validate()) {
+      return false;
+    }
+    *leaf_guard = std::move(latched);
+    return true;
+  };
+
+  OptimisticPageGuard guard = bpm_->FetchPageOptimistic(header_page_id_);
+  if (!guard.Validate()) {
+    return false;
+  }
+  page_id_t page_id = guard.template As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (!guard.Validate()) {
+    return false;
+  }
+  if (page_id == INVALID_PAGE_ID) {
+    *leaf_guard = std::nullopt;
+    return true;
+  }
+
+  while (true) {
+    // page_id was read from the parent, so the child is only the right one if the parent is still unchanged once the
+    // child's version has been read.
+    OptimisticPageGuard child_guard = bpm_->FetchPageOptimistic(page_id);
+    if (!guard.Validate()) {
+      return false;
+    }
+    if (!child_guard.Validate()) {
+      ReadPageGuard latched = bpm_->FetchPageRead(page_id);
+      if (latched.IsEmpty() || !guard.Validate()) {
+        return false;
+      }
+      if constexpr (std::is_same_v<LeafGuard, WritePageGuard>) {
+        if (latched.template As<BPlusTreePage>()->IsLeafPage()) {
+          latched.Drop();
+          return latch_leaf(page_id, guard);
+        }
+        *leaf_guard = DescendWriteLeaf(std::move(latched), *key);
+      } else {
+        *leaf_guard = DescendRead(std::move(latched), key);
+      }
+      return true;
+    }
+
+    auto page = child_guard.template As<BPlusTreePage>();
+    const bool is_leaf = page->IsLeafPage();
+    if (!child_guard.Validate()) {
+      return false;
+    }
+    if (is_leaf) {
+      return latch_leaf(page_id, guard);
+    }
+    guard = child_guard;
+    auto internal = reinterpret_cast<const InternalPage *>(page);
+    page_id = key == nullptr ? internal->ValueAt(0) : internal->Lookup(*key, comparator_, internal_max_size_);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::DescendRead(ReadPageGuard guard, const KeyType *key) -> ReadPageGuard {
+  while (true) {
+    auto page = guard.template As<BPlusTreePage>();
+    if (page->IsLeafPage()) {
+      return guard;
+    }
+    auto internal = reinterpret_cast<const InternalPage *>(page);
+    const page_id_t page_id =
+        key == nullptr ? internal->ValueAt(0) : internal->Lookup(*key, comparator_, internal_max_size_);
+    // The child is latched before the parent is released.
+    ReadPageGuard child_guard = bpm_->FetchPageRead(page_id);
+    guard = std::move(child_guard);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::DescendWriteLeaf(ReadPageGuard guard, const KeyType &key) -> WritePageGuard {
+  while (true) {
+    const page_id_t page_id = guard.template As<InternalPage>()->Lookup(key, comparator_, internal_max_size_);
+    ReadPageGuard child_guard = bpm_->FetchPageRead(page_id);
+    if (child_guard.template As<BPlusTreePage>()->IsLeafPage()) {
+      child_guard.Drop();
+      return bpm_->FetchPageWrite(page_id);
+    }
+    guard = std::move(child_guard);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FindLeafWrite(const KeyType &key, bool is_insert, Context *ctx) {
+  page_id_t page_id = ctx->root_page_id_;
+  while (true) {
+    ctx->write_set_.push_back(bpm_->FetchPageWrite(page_id));
+    auto page = ctx->write_set_.back().template As<BPlusTreePage>();
+    if (IsSafe(page, is_insert, ctx->IsRootPage(page_id))) {
+      // Whatever happens below, this page absorbs it, so nothing above it can change.
+      ctx->header_page_ = std::nullopt;
+      while (ctx->write_set_.size() > 1) {
+        ctx->write_set_.pop_front();
+      }
+    }
+    if (page->IsLeafPage()) {
+      return;
+    }
+    page_id = reinterpret_cast<const InternalPage *>(page)->Lookup(key, comparator_, internal_max_size_);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsSafe(const BPlusTreePage *page, bool is_insert, bool is_root) const -> bool {
+  if (is_insert) {
+    return page->GetSize() < page->GetMaxSize();
+  }
+  if (is_root) {
+    // A root leaf is dropped when it becomes empty, a root internal page when it is left with a single child.
+    return page->GetSize() > (page->IsLeafPage() ? 1 : 2);
+  }
+  return page->GetSize() > page->GetMinSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NewTreePage(page_id_t *page_id, page_id_t near_page_id) -> BasicPageGuard {
+  Page *page = bpm_->NewPageNear(page_id, near_page_id);
+  BUSTUB_ENSURE(page != nullptr, "cannot allocate page");
+  return {bpm_, page};
 }
 
 /*****************************************************************************
@@ -55,10 +237,134 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
-  // Declaration of context instance.
+  // Most inserts fit in their leaf, which is then the only page they latch for writing. Only an insert into an empty
+  // tree or a full leaf takes the header page and crabs down with write latches.
+  for (int attempt = 0; attempt < OPTIMISTIC_WRITE_ATTEMPTS; attempt++) {
+    std::optional<WritePageGuard> leaf_guard;
+    if (!FindLeafOptimistic(&key, &leaf_guard)) {
+      continue;
+    }
+    if (!leaf_guard.has_value()) {
+      break;
+    }
+    auto leaf = leaf_guard->template As<LeafPage>();
+    ValueType old_value;
+    if (leaf->Lookup(key, &old_value, comparator_)) {
+      return false;
+    }
+    if (leaf->GetSize() < leaf->GetMaxSize()) {
+      leaf_guard->template AsMut<LeafPage>()->Insert(key, value, comparator_);
+      return true;
+    }
+    break;
+  }
+
   Context ctx;
-  (void)ctx;
-  return false;
+  ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
+  auto header_page = ctx.header_page_->template AsMut<BPlusTreeHeaderPage>();
+  if (header_page->root_page_id_ == INVALID_PAGE_ID) {
+    page_id_t root_page_id;
+    auto root_guard = NewTreePage(&root_page_id, header_page_id_);
+    auto root_page = root_guard.template AsMut<LeafPage>();
+    root_page->Init(leaf_max_size_);
+    root_page->Insert(key, value, comparator_);
+    header_page->root_page_id_ = root_page_id;
+    return true;
+  }
+  ctx.root_page_id_ = header_page->root_page_id_;
+  FindLeafWrite(key, true, &ctx);
+
+  auto &leaf_guard = ctx.write_set_.back();
+  ValueType old_value;
+  if (leaf_guard.template As<LeafPage>()->Lookup(key, &old_value, comparator_)) {
+    return false;
+  }
+  auto leaf = leaf_guard.template AsMut<LeafPage>();
+  if (leaf->GetSize() < leaf->GetMaxSize()) {
+    leaf->Insert(key, value, comparator_);
+    return true;
+  }
+
+  // The leaf is full: split the max_size + 1 entries between it and a new right sibling.
+  std::vector<MappingType> entries;
+  entries.reserve(leaf->GetSize() + 1);
+  for (int i = 0; i < leaf->GetSize(); i++) {
+    entries.push_back(leaf->PairAt(i));
+  }
+  entries.insert(entries.begin() + leaf->KeyIndex(key, comparator_), {key, value});
+
+  page_id_t new_page_id;
+  auto new_guard = NewTreePage(&new_page_id, leaf_guard.PageId());
+  auto new_leaf = new_guard.template AsMut<LeafPage>();
+  new_leaf->Init(leaf_max_size_);
+
+  const int left_size = static_cast<int>(entries.size()) / 2;
+  for (int i = 0; i < left_size; i++) {
+    leaf->SetAt(i, entries[i].first, entries[i].second);
+  }
+  leaf->SetSize(left_size);
+  for (int i = left_size; i < static_cast<int>(entries.size()); i++) {
+    new_leaf->SetAt(i - left_size, entries[i].first, entries[i].second);
+  }
+  new_leaf->SetSize(static_cast<int>(entries.size()) - left_size);
+  new_leaf->SetNextPageId(leaf->GetNextPageId());
+  leaf->SetNextPageId(new_page_id);
+
+  InsertIntoParent(&ctx, ctx.write_set_.size() - 1, new_leaf->KeyAt(0), new_page_id);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParent(Context *ctx, size_t level, const KeyType &key, page_id_t right_page_id) {
+  const page_id_t left_page_id = ctx->write_set_[level].PageId();
+  if (level == 0) {
+    // The topmost latched page only splits if it is unsafe, which means it is the root.
+    BUSTUB_ASSERT(ctx->IsRootPage(left_page_id) && ctx->header_page_.has_value(), "split of a page without parent");
+    page_id_t root_page_id;
+    auto root_guard = NewTreePage(&root_page_id, left_page_id);
+    auto root_page = root_guard.template AsMut<InternalPage>();
+    root_page->Init(internal_max_size_);
+    root_page->InsertAt(0, key, left_page_id, comparator_);
+    root_page->InsertAt(1, key, right_page_id, comparator_);
+    ctx->header_page_->template AsMut<BPlusTreeHeaderPage>()->root_page_id_ = root_page_id;
+    ctx->root_page_id_ = root_page_id;
+    return;
+  }
+
+  auto parent = ctx->write_set_[level - 1].template AsMut<InternalPage>();
+  const int index = parent->ValueIndex(left_page_id) + 1;
+  if (parent->GetSize() < parent->GetMaxSize()) {
+    parent->InsertAt(index, key, right_page_id, comparator_);
+    return;
+  }
+
+  // The parent is full as well. The first key of the new right page is pushed up to the grandparent.
+  std::vector<std::pair<KeyType, page_id_t>> entries;
+  entries.reserve(parent->GetSize() + 1);
+  for (int i = 0; i < parent->GetSize(); i++) {
+    entries.emplace_back(parent->KeyAt(i), parent->ValueAt(i));
+  }
+  entries.insert(entries.begin() + index, {key, right_page_id});
+
+  page_id_t new_page_id;
+  auto new_guard = NewTreePage(&new_page_id, ctx->write_set_[level - 1].PageId());
+  auto new_internal = new_guard.template AsMut<InternalPage>();
+  new_internal->Init(internal_max_size_);
+
+  // Both pages start without a prefix, so that refilling them does not recompute their heads over and over.
+  const int left_size = static_cast<int>(entries.size()) / 2;
+  parent->SetSize(0);
+  parent->RebuildHeads(comparator_);
+  for (int i = 0; i < left_size; i++) {
+    parent->InsertAt(i, entries[i].first, entries[i].second, comparator_);
+  }
+  for (int i = left_size; i < static_cast<int>(entries.size()); i++) {
+    new_internal->InsertAt(i - left_size, entries[i].first, entries[i].second, comparator_);
+  }
+  parent->RebuildHeads(comparator_);
+  new_internal->RebuildHeads(comparator_);
+
+  InsertIntoParent(ctx, level - 1, entries[left_size].first, new_page_id);
 }
 
 /*****************************************************************************
@@ -73,9 +379,326 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
-  // Declaration of context instance.
-  Context ctx;
-  (void)ctx;
+  // Like Insert: a leaf that keeps more than its min size, and at least one entry, is removed from on its own.
+  for (int attempt = 0; attempt < OPTIMISTIC_WRITE_ATTEMPTS; attempt++) {
+    std::optional<WritePageGuard> leaf_guard;
+    if (!FindLeafOptimistic(&key, &leaf_guard)) {
+      continue;
+    }
+    if (!leaf_guard.has_value()) {
+      return;
+    }
+    auto leaf = leaf_guard->template As<LeafPage>();
+    ValueType old_value;
+    if (!leaf->Lookup(key, &old_value, comparator_)) {
+      return;
+    }
+    if (leaf->GetSize() > std::max(leaf->GetMinSize(), 1)) {
+      leaf_guard->template AsMut<LeafPage>()->Remove(key, comparator_);
+      return;
+    }
+    break;
+  }
+
+  std::vector<page_id_t> deleted_pages;
+  {
+    Context ctx;
+    ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
+    ctx.root_page_id_ = ctx.header_page_->template As<BPlusTreeHeaderPage>()->root_page_id_;
+    if (ctx.root_page_id_ == INVALID_PAGE_ID) {
+      return;
+    }
+    FindLeafWrite(key, false, &ctx);
+
+    auto &leaf_guard = ctx.write_set_.back();
+    ValueType old_value;
+    if (!leaf_guard.template As<LeafPage>()->Lookup(key, &old_value, comparator_)) {
+      return;
+    }
+    leaf_guard.template AsMut<LeafPage>()->Remove(key, comparator_);
+    HandleUnderflow(&ctx, ctx.write_set_.size() - 1, &deleted_pages);
+  }
+  // A page can only be deleted once nobody has it pinned, including ourselves.
+  if (!deleted_pages.empty()) {
+    DeletePages(deleted_pages);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeletePages(const std::vector<page_id_t> &page_ids) {
+  std::scoped_lock lock(undeleted_pages_latch_);
+  undeleted_pages_.insert(undeleted_pages_.end(), page_ids.begin(), page_ids.end());
+  undeleted_pages_.erase(std::remove_if(undeleted_pages_.begin(), undeleted_pages_.end(),
+                                        [this](page_id_t page_id) { return bpm_->DeletePage(page_id); }),
+                         undeleted_pages_.end());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::HandleUnderflow(Context *ctx, size_t level, std::vector<page_id_t> *deleted_pages) {
+  auto &guard = ctx->write_set_[level];
+  const page_id_t page_id = guard.PageId();
+  auto page = guard.template As<BPlusTreePage>();
+
+  if (ctx->IsRootPage(page_id)) {
+    if (page->IsLeafPage() && page->GetSize() == 0) {
+      ctx->header_page_->template AsMut<BPlusTreeHeaderPage>()->root_page_id_ = INVALID_PAGE_ID;
+      deleted_pages->push_back(page_id);
+    } else if (!page->IsLeafPage() && page->GetSize() == 1) {
+      // The only child becomes the new root.
+      ctx->header_page_->template AsMut<BPlusTreeHeaderPage>()->root_page_id_ =
+          reinterpret_cast<const InternalPage *>(page)->ValueAt(0);
+      deleted_pages->push_back(page_id);
+    }
+    return;
+  }
+  if (page->GetSize() >= page->GetMinSize()) {
+    return;
+  }
+
+  // The page may be released below, only keep what we need to know about it.
+  const bool is_leaf = page->IsLeafPage();
+  const int max_size = page->GetMaxSize();
+
+  // An unsafe page keeps its parent latched.
+  auto parent = ctx->write_set_[level - 1].template AsMut<InternalPage>();
+  const int index = parent->ValueIndex(page_id);
+  int left_index;
+  WritePageGuard left_guard;
+  WritePageGuard right_guard;
+  if (index > 0) {
+    // Siblings are latched left to right like the index iterator does. The parent stays latched, so nobody else can
+    // restructure the page while it is released.
+    left_index = index - 1;
+    guard.Drop();
+    left_guard = bpm_->FetchPageWrite(parent->ValueAt(left_index));
+    right_guard = bpm_->FetchPageWrite(page_id);
+  } else {
+    left_index = index;
+    left_guard = std::move(guard);
+    right_guard = bpm_->FetchPageWrite(parent->ValueAt(index + 1));
+  }
+  const int right_index = left_index + 1;
+  const bool merge = left_guard.template As<BPlusTreePage>()->GetSize() +
+                         right_guard.template As<BPlusTreePage>()->GetSize() <=
+                     max_size;
+
+  if (is_leaf) {
+    auto left = left_guard.template AsMut<LeafPage>();
+    auto right = right_guard.template AsMut<LeafPage>();
+    if (merge) {
+      right->MoveAllTo(left);
+    } else if (left_index < index) {
+      left->MoveLastToFrontOf(right);
+      parent->SetKeyAt(right_index, right->KeyAt(0), comparator_);
+    } else {
+      right->MoveFirstToEndOf(left);
+      parent->SetKeyAt(right_index, right->KeyAt(0), comparator_);
+    }
+  } else {
+    auto left = left_guard.template AsMut<InternalPage>();
+    auto right = right_guard.template AsMut<InternalPage>();
+    if (merge) {
+      // The separator comes down from the parent as the key of the first child of the right page.
+      right->SetKeyAt(0, parent->KeyAt(right_index), comparator_);
+      for (int i = 0; i < right->GetSize(); i++) {
+        left->InsertAt(left->GetSize(), right->KeyAt(i), right->ValueAt(i), comparator_);
+      }
+      right->SetSize(0);
+    } else if (left_index < index) {
+      const int last = left->GetSize() - 1;
+      right->SetKeyAt(0, parent->KeyAt(right_index), comparator_);
+      right->InsertAt(0, left->KeyAt(last), left->ValueAt(last), comparator_);
+      parent->SetKeyAt(right_index, left->KeyAt(last), comparator_);
+      left->RemoveAt(last);
+    } else {
+      left->InsertAt(left->GetSize(), parent->KeyAt(right_index), right->ValueAt(0), comparator_);
+      parent->SetKeyAt(right_index, right->KeyAt(1), comparator_);
+      right->RemoveAt(0);
+    }
+  }
+
+  if (!merge) {
+    return;
+  }
+  // The right page is merged into the left one and goes away.
+  deleted_pages->push_back(right_guard.PageId());
+  parent->RemoveAt(right_index);
+  left_guard.Drop();
+  right_guard.Drop();
+  HandleUnderflow(ctx, level - 1, deleted_pages);
+}
+
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
+/*
+ * Fill the leaves left to right, and hand every leaf to its parent level once
+ * the next one is started, which in turn fills its pages left to right. Each
+ * level only keeps its last two pages pinned.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoad(const std::function<bool(KeyType *, ValueType *)> &next, int fill_percent) {
+  WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+  auto header_page = header_guard.template AsMut<BPlusTreeHeaderPage>();
+  BUSTUB_ENSURE(header_page->root_page_id_ == INVALID_PAGE_ID, "bulk load into a non-empty tree");
+
+  BulkLoadState state;
+  state.leaf_fill_ = std::clamp(leaf_max_size_ * fill_percent / 100, std::max(leaf_max_size_ / 2, 1), leaf_max_size_);
+  state.internal_fill_ =
+      std::clamp(internal_max_size_ * fill_percent / 100, (internal_max_size_ + 1) / 2, internal_max_size_);
+  state.last_page_id_ = header_page_id_;
+
+  KeyType key;
+  ValueType value;
+  std::optional<KeyType> last_key;
+  while (next(&key, &value)) {
+    BUSTUB_ENSURE(!last_key.has_value() || comparator_(*last_key, key) < 0,
+                  "bulk loaded keys must be strictly increasing");
+    BulkAppendLeaf(&state, key, value);
+    last_key = key;
+  }
+  header_page->root_page_id_ = BulkFinish(&state);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkAppendLeaf(BulkLoadState *state, const KeyType &key, const ValueType &value) {
+  if (state->levels_.empty()) {
+    state->levels_.emplace_back();
+  }
+  auto &leaves = state->levels_.front();
+  if (!leaves.cur_.has_value() || leaves.cur_->template As<LeafPage>()->GetSize() == state->leaf_fill_) {
+    page_id_t page_id;
+    auto guard = NewTreePage(&page_id, state->last_page_id_);
+    state->last_page_id_ = page_id;
+    guard.template AsMut<LeafPage>()->Init(leaf_max_size_);
+    if (leaves.cur_.has_value()) {
+      leaves.cur_->template AsMut<LeafPage>()->SetNextPageId(page_id);
+    }
+    BulkStartPage(state, 0, std::move(guard), key);
+  }
+  auto leaf = leaves.cur_->template AsMut<LeafPage>();
+  leaf->SetAt(leaf->GetSize(), key, value);
+  leaf->IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkAppendInternal(BulkLoadState *state, size_t level, const KeyType &key,
+                                        page_id_t child_page_id) {
+  // Levels live in a deque, so that adding the parent level does not move this one.
+  if (state->levels_.size() == level) {
+    state->levels_.emplace_back();
+  }
+  auto &pages = state->levels_[level];
+  if (!pages.cur_.has_value() || pages.cur_->template As<InternalPage>()->GetSize() == state->internal_fill_) {
+    page_id_t page_id;
+    auto guard = NewTreePage(&page_id, state->last_page_id_);
+    state->last_page_id_ = page_id;
+    guard.template AsMut<InternalPage>()->Init(internal_max_size_);
+    BulkStartPage(state, level, std::move(guard), key);
+  }
+  auto page = pages.cur_->template AsMut<InternalPage>();
+  page->InsertAt(page->GetSize(), key, child_page_id, comparator_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkStartPage(BulkLoadState *state, size_t level, BasicPageGuard guard, const KeyType &key) {
+  auto &pages = state->levels_[level];
+  if (pages.prev_.has_value()) {
+    const page_id_t page_id = pages.prev_->PageId();
+    pages.prev_ = std::nullopt;
+    BulkAppendInternal(state, level + 1, pages.prev_key_, page_id);
+  }
+  pages.prev_ = std::move(pages.cur_);
+  pages.prev_key_ = pages.cur_key_;
+  if (pages.prev_.has_value()) {
+    BulkRebuildHeads(&*pages.prev_);
+  }
+  pages.cur_ = std::move(guard);
+  pages.cur_key_ = key;
+}
+
+/*
+ * Internal pages are filled without a prefix, leaves have no heads
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkRebuildHeads(BasicPageGuard *guard) {
+  if (!guard->template As<BPlusTreePage>()->IsLeafPage()) {
+    guard->template AsMut<InternalPage>()->RebuildHeads(comparator_);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkBalance(BulkLevel *pages) {
+  auto merge_into_prev = [this, pages] {
+    const page_id_t page_id = pages->cur_->PageId();
+    pages->cur_ = std::move(pages->prev_);
+    pages->cur_key_ = pages->prev_key_;
+    pages->prev_ = std::nullopt;
+    DeletePages({page_id});
+  };
+
+  if (pages->cur_->template As<BPlusTreePage>()->IsLeafPage()) {
+    auto prev = pages->prev_->template AsMut<LeafPage>();
+    auto cur = pages->cur_->template AsMut<LeafPage>();
+    if (cur->GetSize() >= cur->GetMinSize()) {
+      return;
+    }
+    if (prev->GetSize() + cur->GetSize() <= prev->GetMaxSize()) {
+      cur->MoveAllTo(prev);
+      merge_into_prev();
+      return;
+    }
+    // Split the entries of both pages evenly, which leaves each of them at least half full.
+    while (cur->GetSize() < prev->GetSize()) {
+      prev->MoveLastToFrontOf(cur);
+    }
+    pages->cur_key_ = cur->KeyAt(0);
+    return;
+  }
+
+  auto prev = pages->prev_->template AsMut<InternalPage>();
+  auto cur = pages->cur_->template AsMut<InternalPage>();
+  if (cur->GetSize() >= cur->GetMinSize()) {
+    return;
+  }
+  if (prev->GetSize() + cur->GetSize() <= prev->GetMaxSize()) {
+    for (int i = 0; i < cur->GetSize(); i++) {
+      prev->InsertAt(prev->GetSize(), i == 0 ? pages->cur_key_ : cur->KeyAt(i), cur->ValueAt(i), comparator_);
+    }
+    merge_into_prev();
+    return;
+  }
+  while (cur->GetSize() < prev->GetSize()) {
+    const int last = prev->GetSize() - 1;
+    cur->InsertAt(0, prev->KeyAt(last), prev->ValueAt(last), comparator_);
+    cur->SetKeyAt(1, pages->cur_key_, comparator_);
+    pages->cur_key_ = prev->KeyAt(last);
+    prev->RemoveAt(last);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkFinish(BulkLoadState *state) -> page_id_t {
+  for (size_t level = 0; level < state->levels_.size(); level++) {
+    auto &pages = state->levels_[level];
+    if (pages.prev_.has_value()) {
+      BulkBalance(&pages);
+    }
+    BulkRebuildHeads(&*pages.cur_);
+    // The only page of the top level is the root.
+    if (!pages.prev_.has_value() && level + 1 == state->levels_.size()) {
+      return pages.cur_->PageId();
+    }
+    if (pages.prev_.has_value()) {
+      const page_id_t page_id = pages.prev_->PageId();
+      pages.prev_ = std::nullopt;
+      BulkAppendInternal(state, level + 1, pages.prev_key_, page_id);
+    }
+    const page_id_t page_id = pages.cur_->PageId();
+    pages.cur_ = std::nullopt;
+    BulkAppendInternal(state, level + 1, pages.cur_key_, page_id);
+  }
+  return INVALID_PAGE_ID;
 }
 
 /*****************************************************************************
@@ -87,7 +710,13 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
+  auto leaf_guard = FindLeafRead(nullptr);
+  if (!leaf_guard.has_value()) {
+    return End();
+  }
+  return INDEXITERATOR_TYPE(bpm_, std::move(*leaf_guard), 0);
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -95,7 +724,14 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE()
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  auto leaf_guard = FindLeafRead(&key);
+  if (!leaf_guard.has_value()) {
+    return End();
+  }
+  const int index = leaf_guard->template As<LeafPage>()->KeyIndex(key, comparator_);
+  return INDEXITERATOR_TYPE(bpm_, std::move(*leaf_guard), index);
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -109,7 +745,10 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE();
  * @return Page id of the root of this tree
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.template As<BPlusTreeHeaderPage>()->root_page_id_;
+}
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
@@ -117,12 +756,23 @@ auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
 
 /*
  * This method is used for test only
- * Read data from file and insert one by one
+ * Read data from file and insert one by one, or bulk load it if the tree is
+ * empty
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *txn) {
   int64_t key;
   std::ifstream input(file_name);
+  if (IsEmpty()) {
+    BPlusTreeBuilder<KeyType, ValueType, KeyComparator> builder(this, comparator_);
+    while (input >> key) {
+      KeyType index_key;
+      index_key.SetFromInteger(key);
+      builder.Add(index_key, RID(key));
+    }
+    builder.Finish();
+    return;
+  }
   while (input) {
     input >> key;
 
@@ -148,6 +798,40 @@ void BPLUSTREE_TYPE::RemoveFromFile(const std::string &file_name, Transaction *t
   }
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetStats() -> BPlusTreeStats {
+  BPlusTreeStats stats;
+  stats.page_size_ = bpm_->GetPageSize();
+  auto root_page_id = GetRootPageId();
+  if (root_page_id != INVALID_PAGE_ID) {
+    CollectStats(root_page_id, 1, &stats);
+  }
+  return stats;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CollectStats(page_id_t page_id, int depth, BPlusTreeStats *stats) {
+  ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+  stats->height_ = std::max(stats->height_, depth);
+  if (guard.template As<BPlusTreePage>()->IsLeafPage()) {
+    auto leaf = guard.template As<LeafPage>();
+    stats->leaf_pages_++;
+    stats->num_keys_ += leaf->GetSize();
+    return;
+  }
+  auto internal = guard.template As<InternalPage>();
+  stats->internal_pages_++;
+  stats->internal_prefix_bytes_ += internal->GetPrefixSize();
+  std::vector<page_id_t> children;
+  for (int i = 0; i < internal->GetSize(); i++) {
+    children.push_back(internal->ValueAt(i));
+  }
+  guard.Drop();
+  for (page_id_t child_page_id : children) {
+    CollectStats(child_page_id, depth + 1, stats);
+  }
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Print(BufferPoolManager *bpm) {
   auto root_page_id = GetRootPageId();
@@ -344,4 +1028,12 @@ template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTree<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+
+template class BPlusTree<NormalizedKey<24>, RID, NormalizedComparator<24>>;
+
+template class BPlusTree<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+
+template class BPlusTree<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
 }  // namespace bustub
@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_builder.cpp
+//
+// Identification: src/storage/index/b_plus_tree_builder.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/b_plus_tree_builder.h"
+
+#include <algorithm>
+#include <queue>
+#include <type_traits>
+
+#include "common/exception.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_BUILDER_TYPE::BPlusTreeBuilder(BPLUSTREE_TYPE *tree, const KeyComparator &comparator, size_t memory_bytes,
+                                         int fill_percent)
+    : tree_(tree),
+      comparator_(comparator),
+      max_buffered_(std::max<size_t>(memory_bytes / (sizeof(KeyType) + sizeof(ValueType)), 1)),
+      fill_percent_(fill_percent) {
+  static_assert(std::is_trivially_copyable_v<KeyType> && std::is_trivially_copyable_v<ValueType>,
+                "entries are spilled to run files byte by byte");
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_BUILDER_TYPE::Add(const KeyType &key, const ValueType &value) {
+  if (buffer_.size() == max_buffered_) {
+    SpillRun();
+  }
+  buffer_.emplace_back(key, value);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_BUILDER_TYPE::SortBuffer() {
+  std::stable_sort(buffer_.begin(), buffer_.end(),
+                   [this](const MappingType &a, const MappingType &b) { return comparator_(a.first, b.first) < 0; });
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_BUILDER_TYPE::SpillRun() {
+  SortBuffer();
+  std::unique_ptr<std::FILE, FileCloser> file(std::tmpfile());
+  if (file == nullptr) {
+    throw Exception("can't create a run file for the bulk load");
+  }
+  for (const auto &entry : buffer_) {
+    if (std::fwrite(&entry.first, sizeof(KeyType), 1, file.get()) != 1 ||
+        std::fwrite(&entry.second, sizeof(ValueType), 1, file.get()) != 1) {
+      throw Exception("can't write a run file for the bulk load");
+    }
+  }
+  std::rewind(file.get());
+  runs_.push_back(std::move(file));
+  buffer_.clear();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_BUILDER_TYPE::Finish() -> size_t {
+  SortBuffer();
+
+  // Merge the runs and the buffer, which holds the entries added last. Sources are numbered in the order their entries
+  // were added, and ties go to the lowest one, so the first entry added with a key comes out first.
+  const size_t num_sources = runs_.size() + 1;
+  size_t buffer_pos = 0;
+  auto read = [this, &buffer_pos](size_t source, MappingType *entry) -> bool {
+    if (source < runs_.size()) {
+      return std::fread(&entry->first, sizeof(KeyType), 1, runs_[source].get()) == 1 &&
+             std::fread(&entry->second, sizeof(ValueType), 1, runs_[source].get()) == 1;
+    }
+    if (buffer_pos == buffer_.size()) {
+      return false;
+    }
+    *entry = buffer_[buffer_pos++];
+    return true;
+  };
+  std::vector<MappingType> heads(num_sources);
+  auto later = [this, &heads](size_t a, size_t b) {
+    const int cmp = comparator_(heads[a].first, heads[b].first);
+    return cmp != 0 ? cmp > 0 : a > b;
+  };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(later)> merge(later);
+  for (size_t source = 0; source < num_sources; source++) {
+    if (read(source, &heads[source])) {
+      merge.push(source);
+    }
+  }
+
+  size_t loaded = 0;
+  KeyType last_key;
+  tree_->BulkLoad(
+      [&](KeyType *key, ValueType *value) {
+        while (!merge.empty()) {
+          const size_t source = merge.top();
+          merge.pop();
+          const MappingType entry = heads[source];
+          if (read(source, &heads[source])) {
+            merge.push(source);
+          }
+          if (loaded > 0 && comparator_(entry.first, last_key) == 0) {
+            continue;
+          }
+          *key = entry.first;
+          *value = entry.second;
+          last_key = entry.first;
+          loaded++;
+          return true;
+        }
+        return false;
+      },
+      fill_percent_);
+
+  buffer_.clear();
+  runs_.clear();
+  return loaded;
+}
+
+template class BPlusTreeBuilder<GenericKey<4>, RID, GenericComparator<4>>;
+
+template class BPlusTreeBuilder<GenericKey<8>, RID, GenericComparator<8>>;
+
+template class BPlusTreeBuilder<GenericKey<16>, RID, GenericComparator<16>>;
+
+template class BPlusTreeBuilder<GenericKey<32>, RID, GenericComparator<32>>;
+
+template class BPlusTreeBuilder<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class BPlusTreeBuilder<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+
+template class BPlusTreeBuilder<NormalizedKey<24>, RID, NormalizedComparator<24>>;
+
+template class BPlusTreeBuilder<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+
+template class BPlusTreeBuilder<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
+}  // namespace bustub
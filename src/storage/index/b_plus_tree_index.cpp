@@ -16,19 +16,21 @@ namespace bustub {
  * Constructor
  */
 INDEX_TEMPLATE_ARGUMENTS
-BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
+BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                                     segment_id_t segment)
     : Index(std::move(metadata)), comparator_(GetMetadata()->GetKeySchema()) {
+  // The tree creates its pages near the header page, so they go to the same segment.
   page_id_t header_page_id;
-  buffer_pool_manager->NewPage(&header_page_id);
+  buffer_pool_manager->NewPageInSegment(&header_page_id, segment);
   container_ = std::make_shared<BPlusTree<KeyType, ValueType, KeyComparator>>(GetMetadata()->GetName(), header_page_id,
                                                                               buffer_pool_manager, comparator_);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
-  // construct insert index key
+  // construct insert index key, the rid tells it apart from the keys of other tuples with the same columns
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, *GetKeySchema(), rid);
 
   return container_->Insert(index_key, rid, transaction);
 }
@@ -37,7 +39,7 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, *GetKeySchema(), rid);
 
   container_->Remove(index_key, transaction);
 }
@@ -46,11 +48,16 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
   // construct scan index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, *GetKeySchema());
 
   container_->GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::MakeBuilder() -> BPlusTreeBuilder<KeyType, ValueType, KeyComparator> {
+  return BPlusTreeBuilder<KeyType, ValueType, KeyComparator>(container_.get(), comparator_);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetBeginIterator() -> INDEXITERATOR_TYPE { return container_->Begin(); }
 
@@ -65,5 +72,9 @@ template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeIndex<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class BPlusTreeIndex<NormalizedKey<24>, RID, NormalizedComparator<24>>;
+template class BPlusTreeIndex<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class BPlusTreeIndex<NormalizedKey<64>, RID, NormalizedComparator<64>>;
 
 }  // namespace bustub
@@ -3,28 +3,60 @@
  */
 #include <cassert>
 
+#include "common/macros.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index)
+    : bpm_(bpm), guard_(std::move(guard)), page_id_(guard_.PageId()), index_(index), read_ahead_(bpm) {
+  read_ahead_.OnPageChange(page_id_);
+  SkipExhaustedLeaves();
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::IsEnd() -> bool { return page_id_ == INVALID_PAGE_ID; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
+  BUSTUB_ASSERT(!IsEnd(), "cannot dereference the end iterator");
+  return guard_.template As<LeafPage>()->PairAt(index_);
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  BUSTUB_ASSERT(!IsEnd(), "cannot advance the end iterator");
+  index_++;
+  SkipExhaustedLeaves();
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & { throw std::runtime_error("unimplemented"); }
+void INDEXITERATOR_TYPE::SkipExhaustedLeaves() {
+  while (page_id_ != INVALID_PAGE_ID) {
+    auto leaf = guard_.template As<LeafPage>();
+    if (index_ < leaf->GetSize()) {
+      return;
+    }
+    page_id_ = leaf->GetNextPageId();
+    index_ = 0;
+    if (page_id_ == INVALID_PAGE_ID) {
+      guard_.Drop();
+      return;
+    }
+    // Latch the next leaf before releasing this one, so that it cannot be merged away in between.
+    read_ahead_.OnPageChange(page_id_);
+    auto next_guard = bpm_->FetchPageRead(page_id_);
+    guard_ = std::move(next_guard);
+  }
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
@@ -36,4 +68,12 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+
+template class IndexIterator<NormalizedKey<24>, RID, NormalizedComparator<24>>;
+
+template class IndexIterator<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+
+template class IndexIterator<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
 }  // namespace bustub
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// normalized_key.cpp
+//
+// Identification: src/storage/index/normalized_key.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/normalized_key.h"
+
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+void NormalizedKeyWriter::PutBigEndian(uint64_t value, int bytes) {
+  for (int i = bytes - 1; i >= 0; i--) {
+    Put(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+void NormalizedKeyWriter::Append(const Value &value) {
+  if (value.IsNull()) {
+    Put(0);
+    return;
+  }
+  Put(1);
+  switch (value.GetTypeId()) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      PutBigEndian(static_cast<uint8_t>(value.GetAs<int8_t>()) ^ 0x80U, 1);
+      break;
+    case TypeId::SMALLINT:
+      PutBigEndian(static_cast<uint16_t>(value.GetAs<int16_t>()) ^ 0x8000U, 2);
+      break;
+    case TypeId::INTEGER:
+      PutBigEndian(static_cast<uint32_t>(value.GetAs<int32_t>()) ^ 0x80000000U, 4);
+      break;
+    case TypeId::BIGINT:
+      PutBigEndian(static_cast<uint64_t>(value.GetAs<int64_t>()) ^ (uint64_t{1} << 63), 8);
+      break;
+    case TypeId::TIMESTAMP:
+      PutBigEndian(value.GetAs<uint64_t>(), 8);
+      break;
+    case TypeId::DECIMAL: {
+      // -0.0 equals 0.0, so both get the encoding of 0.0.
+      const double decimal = value.GetAs<double>() == 0 ? 0.0 : value.GetAs<double>();
+      uint64_t bits;
+      memcpy(&bits, &decimal, sizeof(bits));
+      PutBigEndian((bits >> 63) != 0 ? ~bits : bits ^ (uint64_t{1} << 63), 8);
+      break;
+    }
+    case TypeId::VARCHAR: {
+      // The length of a varchar value counts its terminating '\0'.
+      const char *data = value.GetData();
+      const uint32_t length = value.GetLength() - 1;
+      for (uint32_t i = 0; i < length && !IsFull(); i++) {
+        Put(static_cast<uint8_t>(data[i]));
+        if (data[i] == '\0') {
+          Put(0xff);
+        }
+      }
+      Put(0);
+      Put(0);
+      break;
+    }
+    default:
+      throw NotImplementedException("cannot normalize a key of this type");
+  }
+}
+
+}  // namespace bustub
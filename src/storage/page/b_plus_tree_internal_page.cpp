@@ -9,10 +9,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
 #include "common/exception.h"
+#include "common/macros.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 
 namespace bustub {
@@ -24,32 +26,136 @@ namespace bustub {
  * Including set page type, set current size, and set max page size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetSize(0);
+  SetMaxSize(max_size);
+  ClearPrefix();
+}
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  KeyType key{};
-  return key;
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType { return Entries()[index].first; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key, const KeyComparator &comparator) {
+  Entries()[index].first = key;
+  if (index > 0) {
+    UpdateHead(index, comparator);
+  }
+}
+
+/*
+ * The keys are ordered, so the common prefix of the first and the last one is
+ * shared by all of them
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::RebuildHeads(const KeyComparator &comparator) {
+  if (GetSize() <= 1) {
+    ClearPrefix();
+    return;
+  }
+  SetPrefix(KeyAt(1), KeyAt(GetSize() - 1), comparator);
+  for (int i = 1; i < GetSize(); i++) {
+    [[maybe_unused]] const int order = ProbeKey(KeyAt(i), comparator, &heads_[i]);
+    BUSTUB_ASSERT(order == 0, "every key has the prefix");
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::UpdateHead(int index, const KeyComparator &comparator) {
+  if (ProbeKey(KeyAt(index), comparator, &heads_[index]) != 0) {
+    RebuildHeads(comparator);
+  }
+}
+
+/*
+ * Helper method to find the array index of the child pointer value, -1 if it is not in this page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  const MappingType *entries = Entries();
+  for (int i = 0; i < GetSize(); i++) {
+    if (entries[i].second == value) {
+      return i;
+    }
+  }
+  return -1;
+}
 
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return 0; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return Entries()[index].second; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { Entries()[index].second = value; }
+
+/*
+ * Find the last child whose key is not greater than key, the first key is treated as negative infinity. Only the keys
+ * whose head equals the head of key are compared.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator, int max_size) const
+    -> ValueType {
+  const MappingType *entries = Entries(max_size);
+  const int size = std::clamp(GetSize(), 1, max_size);
+  uint32_t head;
+  const int order = ProbeKey(key, comparator, &head);
+  if (order < 0) {
+    return entries[0].second;
+  }
+  if (order > 0) {
+    return entries[size - 1].second;
+  }
+  int left = HeadLowerBound(heads_, 1, size, head);
+  int right = HeadUpperBound(heads_, left, size, head);
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (comparator(entries[mid].first, key) <= 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return entries[left - 1].second;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value,
+                                              const KeyComparator &comparator) {
+  MappingType *entries = Entries();
+  std::move_backward(entries + index, entries + GetSize(), entries + GetSize() + 1);
+  std::move_backward(heads_ + index, heads_ + GetSize(), heads_ + GetSize() + 1);
+  entries[index] = {key, value};
+  IncreaseSize(1);
+  if (index > 0) {
+    UpdateHead(index, comparator);
+  } else if (GetSize() > 1) {
+    // The key that was first had no head, and now it has one.
+    UpdateHead(1, comparator);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAt(int index) {
+  MappingType *entries = Entries();
+  std::move(entries + index + 1, entries + GetSize(), entries + index);
+  std::move(heads_ + index + 1, heads_ + GetSize(), heads_ + index);
+  IncreaseSize(-1);
+}
 
-// valuetype for internalNode should be page id_t
 template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
 template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
 template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+template class BPlusTreeInternalPage<NormalizedKey<16>, page_id_t, NormalizedComparator<16>>;
+template class BPlusTreeInternalPage<NormalizedKey<24>, page_id_t, NormalizedComparator<24>>;
+template class BPlusTreeInternalPage<NormalizedKey<32>, page_id_t, NormalizedComparator<32>>;
+template class BPlusTreeInternalPage<NormalizedKey<64>, page_id_t, NormalizedComparator<64>>;
 }  // namespace bustub
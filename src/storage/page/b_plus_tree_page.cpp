@@ -11,33 +11,92 @@
 
 #include "storage/page/b_plus_tree_page.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace bustub {
 
 /*
  * Helper methods to get/set page type
  * Page type enum class is defined in b_plus_tree_page.h
  */
-auto BPlusTreePage::IsLeafPage() const -> bool { return false; }
-void BPlusTreePage::SetPageType(IndexPageType page_type) {}
+auto BPlusTreePage::IsLeafPage() const -> bool { return page_type_ == IndexPageType::LEAF_PAGE; }
+void BPlusTreePage::SetPageType(IndexPageType page_type) { page_type_ = page_type; }
 
 /*
  * Helper methods to get/set size (number of key/value pairs stored in that
  * page)
  */
-auto BPlusTreePage::GetSize() const -> int { return 0; }
-void BPlusTreePage::SetSize(int size) {}
-void BPlusTreePage::IncreaseSize(int amount) {}
+auto BPlusTreePage::GetSize() const -> int { return size_; }
+void BPlusTreePage::SetSize(int size) { size_ = size; }
+void BPlusTreePage::IncreaseSize(int amount) { size_ += amount; }
 
 /*
  * Helper methods to get/set max size (capacity) of the page
  */
-auto BPlusTreePage::GetMaxSize() const -> int { return 0; }
-void BPlusTreePage::SetMaxSize(int size) {}
+auto BPlusTreePage::GetMaxSize() const -> int { return max_size_; }
+void BPlusTreePage::SetMaxSize(int size) { max_size_ = size; }
 
 /*
  * Helper method to get min page size
  * Generally, min page size == max page size / 2
+ * For internal page, size counts the children, so round up to keep at least two children per non-root page
  */
-auto BPlusTreePage::GetMinSize() const -> int { return 0; }
+auto BPlusTreePage::GetMinSize() const -> int { return IsLeafPage() ? max_size_ / 2 : (max_size_ + 1) / 2; }
+
+auto BPlusTreePage::ReadHead(const char *encoded) -> uint32_t {
+  const auto *bytes = reinterpret_cast<const uint8_t *>(encoded);
+  return (uint32_t{bytes[0]} << 24) | (uint32_t{bytes[1]} << 16) | (uint32_t{bytes[2]} << 8) | uint32_t{bytes[3]};
+}
+
+namespace {
+
+/** Heads a search scans instead of bisecting, 4 cache lines' worth. */
+constexpr int HEAD_SCAN_SIZE = 64;
+
+/** @return how many of heads[0, n) are less than head (or not greater than head, if or_equal) */
+auto CountHeadsBelow(const uint32_t *heads, int n, uint32_t head, bool or_equal) -> int {
+  int count = 0;
+  int i = 0;
+#ifdef __SSE2__
+  // SSE2 only compares signed integers: flipping the sign bits of both sides orders unsigned ones the same way.
+  const __m128i sign = _mm_set1_epi32(INT32_MIN);
+  const __m128i target = _mm_xor_si128(_mm_set1_epi32(static_cast<int32_t>(head)), sign);
+  for (; i + 4 <= n; i += 4) {
+    const __m128i values = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(heads + i)), sign);
+    const __m128i below = or_equal ? _mm_andnot_si128(_mm_cmpgt_epi32(values, target), _mm_set1_epi32(-1))
+                                   : _mm_cmplt_epi32(values, target);
+    count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(below)));
+  }
+#endif
+  for (; i < n; i++) {
+    count += static_cast<int>(or_equal ? heads[i] <= head : heads[i] < head);
+  }
+  return count;
+}
+
+/** Bisect the ordered heads down to a few cache lines, then count the heads below head there. */
+auto HeadBound(const uint32_t *heads, int begin, int end, uint32_t head, bool upper) -> int {
+  while (end - begin > HEAD_SCAN_SIZE) {
+    const int mid = begin + (end - begin) / 2;
+    if (upper ? heads[mid] <= head : heads[mid] < head) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin + CountHeadsBelow(heads + begin, end - begin, head, upper);
+}
+
+}  // namespace
+
+auto BPlusTreePage::HeadLowerBound(const uint32_t *heads, int begin, int end, uint32_t head) -> int {
+  return HeadBound(heads, begin, end, head, false);
+}
+
+auto BPlusTreePage::HeadUpperBound(const uint32_t *heads, int begin, int end, uint32_t head) -> int {
+  return HeadBound(heads, begin, end, head, true);
+}
 
 }  // namespace bustub
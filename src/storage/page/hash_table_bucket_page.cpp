@@ -108,6 +108,10 @@ template class HashTableBucketPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class HashTableBucketPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class HashTableBucketPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class HashTableBucketPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class HashTableBucketPage<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class HashTableBucketPage<NormalizedKey<24>, RID, NormalizedComparator<24>>;
+template class HashTableBucketPage<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class HashTableBucketPage<NormalizedKey<64>, RID, NormalizedComparator<64>>;
 
 // template class HashTableBucketPage<hash_t, TmpTuple, HashComparator>;
 
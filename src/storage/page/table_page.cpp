@@ -12,7 +12,9 @@
 
 #include "storage/page/table_page.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <optional>
 #include <tuple>
@@ -28,13 +30,15 @@ void TablePage::Init() {
   num_deleted_tuples_ = 0;
 }
 
-auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t> {
+auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple, size_t page_size) const
+    -> std::optional<uint16_t> {
   size_t slot_end_offset;
   if (num_tuples_ > 0) {
     auto &[offset, size, meta] = tuple_info_[num_tuples_ - 1];
     slot_end_offset = offset;
   } else {
-    slot_end_offset = BUSTUB_PAGE_SIZE;
+    // Offsets are 16 bits, which leaves the last byte of a 64KB page unused.
+    slot_end_offset = std::min<size_t>(page_size, UINT16_MAX);
   }
   auto tuple_offset = slot_end_offset - tuple.GetLength();
   auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * (num_tuples_ + 1);
@@ -44,8 +48,8 @@ auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) co
   return tuple_offset;
 }
 
-auto TablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t> {
-  auto tuple_offset = GetNextTupleOffset(meta, tuple);
+auto TablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple, size_t page_size) -> std::optional<uint16_t> {
+  auto tuple_offset = GetNextTupleOffset(meta, tuple, page_size);
   if (tuple_offset == std::nullopt) {
     return std::nullopt;
   }
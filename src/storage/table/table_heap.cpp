@@ -10,9 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 #include <mutex>  // NOLINT
+#include <numeric>
 #include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -26,9 +29,9 @@
 
 namespace bustub {
 
-TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
-  // Initialize the first table page.
-  auto guard = bpm->NewPageGuarded(&first_page_id_);
+TableHeap::TableHeap(BufferPoolManager *bpm, segment_id_t segment) : bpm_(bpm) {
+  // Initialize the first table page. The next ones are created near the last one, so they go to the same segment.
+  auto guard = BasicPageGuard{bpm, bpm->NewPageInSegment(&first_page_id_, segment)};
   last_page_id_ = first_page_id_;
   auto first_page = guard.AsMut<TablePage>();
   BUSTUB_ASSERT(first_page != nullptr,
@@ -42,7 +45,7 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
   auto page_guard = bpm_->FetchPageWrite(last_page_id_);
   while (true) {
     auto page = page_guard.AsMut<TablePage>();
-    if (page->GetNextTupleOffset(meta, tuple) != std::nullopt) {
+    if (page->GetNextTupleOffset(meta, tuple, bpm_->GetUsablePageSize()) != std::nullopt) {
       break;
     }
 
@@ -50,7 +53,7 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
     BUSTUB_ENSURE(page->GetNumTuples() != 0, "tuple is too large, cannot insert");
 
     page_id_t next_page_id = INVALID_PAGE_ID;
-    auto npg = bpm_->NewPage(&next_page_id);
+    auto npg = bpm_->NewPageNear(&next_page_id, last_page_id_);
     BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
 
     page->SetNextPageId(next_page_id);
@@ -70,7 +73,7 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
   auto last_page_id = last_page_id_;
 
   auto page = page_guard.AsMut<TablePage>();
-  auto slot_id = *page->InsertTuple(meta, tuple);
+  auto slot_id = *page->InsertTuple(meta, tuple, bpm_->GetUsablePageSize());
 
   // only allow one insertion at a time, otherwise it will deadlock.
   guard.unlock();
@@ -99,6 +102,54 @@ auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
   return std::make_pair(meta, std::move(tuple));
 }
 
+auto TableHeap::GetTuples(const std::vector<RID> &rids) -> std::vector<std::pair<TupleMeta, Tuple>> {
+  std::vector<size_t> order(rids.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return rids[a].GetPageId() < rids[b].GetPageId(); });
+
+  std::vector<std::pair<TupleMeta, Tuple>> tuples(rids.size());
+  size_t batch_pages = TUPLE_FETCH_BATCH_PAGES;
+  auto next = order.begin();
+  while (next != order.end()) {
+    // The next batch of distinct pages, and the rids that live on them.
+    std::vector<page_id_t> page_ids;
+    auto end = next;
+    for (; end != order.end(); ++end) {
+      const page_id_t page_id = rids[*end].GetPageId();
+      if (page_ids.empty() || page_ids.back() != page_id) {
+        if (page_ids.size() == batch_pages) {
+          break;
+        }
+        page_ids.push_back(page_id);
+      }
+    }
+    auto guards = bpm_->FetchPagesRead(page_ids);
+    size_t page = 0;
+    for (; next != end; ++next) {
+      const RID &rid = rids[*next];
+      while (page_ids[page] != rid.GetPageId()) {
+        page++;
+      }
+      if (guards[page].IsEmpty()) {
+        break;
+      }
+      auto [meta, tuple] = guards[page].As<TablePage>()->GetTuple(rid);
+      tuple.rid_ = rid;
+      tuples[*next] = std::make_pair(meta, std::move(tuple));
+    }
+    if (next != end) {
+      // No frame for this page: the pool is smaller than the batch, or other threads pin most of it. Let go of the
+      // batch and read the rest in smaller ones.
+      if (batch_pages == 1) {
+        throw Exception("can't pin the page of tuple " + rids[*next].ToString());
+      }
+      batch_pages /= 2;
+    }
+  }
+  return tuples;
+}
+
 auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
   auto page = page_guard.As<TablePage>();
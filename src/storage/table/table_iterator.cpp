@@ -21,24 +21,32 @@
 namespace bustub {
 
 TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid)
-    : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid) {
+    : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid), read_ahead_(table_heap->bpm_) {
   // If the rid doesn't correspond to a tuple (i.e., the table has just been initialized), then
   // we set rid_ to invalid.
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId(), AccessType::Scan);
   auto page = page_guard.As<TablePage>();
   if (rid_.GetSlotNum() >= page->GetNumTuples()) {
     rid_ = RID{INVALID_PAGE_ID, 0};
   }
+  read_ahead_.OnPageChange(rid_.GetPageId());
 }
 
-auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_); }
+auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> {
+  // Same as TableHeap::GetTuple, but tagged as a scan so that the page does not push the working set out.
+  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId(), AccessType::Scan);
+  auto page = page_guard.As<TablePage>();
+  auto [meta, tuple] = page->GetTuple(rid_);
+  tuple.rid_ = rid_;
+  return std::make_pair(meta, std::move(tuple));
+}
 
 auto TableIterator::GetRID() -> RID { return rid_; }
 
 auto TableIterator::IsEnd() -> bool { return rid_.GetPageId() == INVALID_PAGE_ID; }
 
 auto TableIterator::operator++() -> TableIterator & {
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId(), AccessType::Scan);
   auto page = page_guard.As<TablePage>();
   auto next_tuple_id = rid_.GetSlotNum() + 1;
 
@@ -60,6 +68,7 @@ auto TableIterator::operator++() -> TableIterator & {
     auto next_page_id = page->GetNextPageId();
     // if next page is invalid, RID is set to invalid page; otherwise, it's the first tuple in that page.
     rid_ = RID{next_page_id, 0};
+    read_ahead_.OnPageChange(next_page_id);
   }
 
   page_guard.Drop();
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer_test.cpp
+//
+// Identification: test/buffer/arc_replacer_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <vector>
+
+#include "buffer/arc_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ARCReplacerTest, SampleTest) {
+  ARCReplacer replacer(4);
+
+  // Scenario: pages seen once go to T1, page 102 is seen twice and goes to T2.
+  for (frame_id_t i = 0; i < 4; ++i) {
+    replacer.RecordAccess(i, AccessType::Get, 100 + i);
+    replacer.SetEvictable(i, true);
+  }
+  replacer.RecordAccess(2, AccessType::Get, 102);
+  EXPECT_EQ(4, replacer.Size());
+  EXPECT_EQ(0, replacer.GetTarget());
+
+  // Scenario: T1 = {0, 1, 3} is larger than its target, evict from it. Pages 100 and 101 go to B1.
+  frame_id_t value;
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+
+  // Scenario: page 100 comes back while in B1, so T1 grows and the page goes to T2.
+  replacer.RecordAccess(0, AccessType::Get, 100);
+  replacer.SetEvictable(0, true);
+  EXPECT_EQ(1, replacer.GetTarget());
+
+  // Scenario: T1 = {3} is not larger than its target, evict the least recently used frame of T2 = {2, 0}. Page 102
+  // goes to B2.
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(2, value);
+
+  // Scenario: page 102 comes back while in B2, so T1 shrinks again.
+  replacer.RecordAccess(1, AccessType::Get, 102);
+  replacer.SetEvictable(1, true);
+  EXPECT_EQ(0, replacer.GetTarget());
+
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+  EXPECT_FALSE(replacer.Evict(&value));
+  EXPECT_EQ(0, replacer.Size());
+}
+
+TEST(ARCReplacerTest, ScanTest) {
+  ARCReplacer replacer(4);
+
+  for (frame_id_t i = 0; i < 4; ++i) {
+    replacer.RecordAccess(i, AccessType::Get, 100 + i);
+    replacer.SetEvictable(i, true);
+  }
+  frame_id_t value;
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+
+  // Scenario: scans neither promote a frame to T2 nor move the target when they hit a ghost.
+  replacer.RecordAccess(1, AccessType::Scan, 101);
+  replacer.RecordAccess(0, AccessType::Scan, 100);
+  replacer.SetEvictable(0, true);
+  EXPECT_EQ(0, replacer.GetTarget());
+
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+}
+
+}  // namespace bustub
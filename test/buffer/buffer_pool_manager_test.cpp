@@ -12,17 +12,28 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <random>
+#include <set>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "common/exception.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_posix.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
 // Check whether pages containing terminal characters can be recovered
-TEST(BufferPoolManagerTest, DISABLED_BinaryDataTest) {
+TEST(BufferPoolManagerTest, BinaryDataTest) {
   const std::string db_name = "test.db";
   const size_t buffer_pool_size = 10;
   const size_t k = 5;
@@ -88,7 +99,7 @@ TEST(BufferPoolManagerTest, DISABLED_BinaryDataTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(BufferPoolManagerTest, DISABLED_SampleTest) {
+TEST(BufferPoolManagerTest, SampleTest) {
   const std::string db_name = "test.db";
   const size_t buffer_pool_size = 10;
   const size_t k = 5;
@@ -144,4 +155,579 @@ TEST(BufferPoolManagerTest, DISABLED_SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PrefetchTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const size_t k = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, k);
+
+  // Write twice as many pages as there are frames, so that the first half gets evicted.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: Resident pages and pages that were never allocated are not read.
+  EXPECT_EQ(false, bpm->Prefetch(buffer_pool_size * 2 - 1));
+  EXPECT_EQ(false, bpm->Prefetch(buffer_pool_size * 2));
+
+  // Scenario: Prefetching the evicted pages reads them back without pinning them, and fetching them afterwards
+  // returns their content.
+  EXPECT_EQ(buffer_pool_size / 2, bpm->PrefetchRange(0, buffer_pool_size / 2));
+  EXPECT_EQ(0U, bpm->PrefetchRange(0, buffer_pool_size / 2));
+  char expected[BUSTUB_PAGE_SIZE];
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size / 2); ++i) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", i);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    EXPECT_EQ(1, page->GetPinCount());
+  }
+
+  // Scenario: Prefetched pages are evictable, so fetching other pages still works. Once every frame is pinned,
+  // prefetching does nothing.
+  for (page_id_t i = buffer_pool_size / 2; i < static_cast<page_id_t>(buffer_pool_size); ++i) {
+    EXPECT_EQ(true, bpm->Prefetch(i));
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", i);
+    EXPECT_EQ(0, strcmp(page->GetData(), expected));
+  }
+  EXPECT_EQ(false, bpm->Prefetch(buffer_pool_size));
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// Eviction must not wait for a prefetch read under the latch while another frame could be evicted instead.
+TEST(BufferPoolManagerTest, PrefetchVictimTest) {
+  const size_t latency_ms = 500;
+  for (auto replacer_type :
+       {ReplacerType::LRUK, ReplacerType::LRU, ReplacerType::Clock, ReplacerType::TwoQ, ReplacerType::ARC}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(2, disk_manager.get(), 2, nullptr, replacer_type);
+    page_id_t page_id;
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+    }
+    bpm->FlushAllPages();
+    disk_manager->SetLatency(latency_ms);
+
+    // Scenario: page 0 is being prefetched into one frame, the other frame holds a clean page. A new page takes the
+    // clean frame without waiting for the read.
+    ASSERT_EQ(true, bpm->Prefetch(0));
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(latency_ms / 2));
+
+    // Scenario: with the prefetch as the only evictable frame, eviction waits for it rather than failing.
+    page_id_t other_page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&other_page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    EXPECT_EQ(true, bpm->UnpinPage(other_page_id, false));
+    disk_manager->SetLatency(0);
+  }
+}
+
+TEST(BufferPoolManagerTest, PageReuseTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  remove(db_name.c_str());
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  bpm->FlushAllPages();
+
+  // Scenario: deleted pages, resident or not, are not prefetched, and their ids are handed out again, the lowest one
+  // first, or the one closest to the hint.
+  EXPECT_EQ(true, bpm->DeletePage(3));
+  EXPECT_EQ(true, bpm->DeletePage(15));
+  EXPECT_EQ(true, bpm->DeletePage(16));
+  EXPECT_EQ(false, bpm->Prefetch(3));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(3, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  ASSERT_NE(nullptr, bpm->NewPageNear(&page_id_temp, 17));
+  EXPECT_EQ(16, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+
+  // Scenario: vacuuming gives the free pages at the end of the file back, and the file grows again from there.
+  EXPECT_EQ(true, bpm->DeletePage(18));
+  EXPECT_EQ(true, bpm->DeletePage(19));
+  EXPECT_EQ(2, bpm->Vacuum());
+  EXPECT_EQ(18, disk_manager->GetNumPages());
+  EXPECT_EQ(true, bpm->DeletePage(17));
+  EXPECT_EQ(true, bpm->DeletePage(16));
+  EXPECT_EQ(3, bpm->Vacuum());
+  EXPECT_EQ(15, disk_manager->GetNumPages());
+  ASSERT_NE(nullptr, bpm->NewPageNear(&page_id_temp, 18));
+  EXPECT_EQ(15, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+
+  delete bpm;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  delete disk_manager;
+}
+
+// Every replacement policy must keep the buffer pool working: evicted pages are written back and read again.
+TEST(BufferPoolManagerTest, ReplacerTypeTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const size_t k = 5;
+
+  for (auto replacer_type :
+       {ReplacerType::LRUK, ReplacerType::LRU, ReplacerType::Clock, ReplacerType::TwoQ, ReplacerType::ARC}) {
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, k, nullptr, replacer_type);
+
+    page_id_t page_id_temp;
+    for (size_t i = 0; i < buffer_pool_size * 3; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+
+    // Scenario: with every frame pinned, no page can be brought in.
+    char expected[BUSTUB_PAGE_SIZE];
+    for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); ++i) {
+      auto *page = bpm->FetchPage(i, AccessType::Get);
+      ASSERT_NE(nullptr, page);
+      snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", i);
+      EXPECT_EQ(0, strcmp(page->GetData(), expected));
+    }
+    EXPECT_EQ(nullptr, bpm->FetchPage(buffer_pool_size));
+
+    for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); ++i) {
+      EXPECT_EQ(true, bpm->UnpinPage(i, false));
+    }
+    for (int round = 0; round < 2; ++round) {
+      for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size * 3); ++i) {
+        auto *page = bpm->FetchPage(i, i % 2 == 0 ? AccessType::Get : AccessType::Scan);
+        ASSERT_NE(nullptr, page);
+        snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", i);
+        EXPECT_EQ(0, strcmp(page->GetData(), expected));
+        EXPECT_EQ(true, bpm->UnpinPage(i, false));
+      }
+    }
+    EXPECT_EQ(true, bpm->DeletePage(0));
+
+    disk_manager->ShutDown();
+    remove("test.db");
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+TEST(BufferPoolManagerTest, ConcurrentHitTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  const int num_pages = 64;
+  const int num_threads = 4;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: readers hit a few hot pages without the latch while another thread keeps evicting the other frames.
+  // Every fetch must return a frame holding the page asked for.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      char expected[BUSTUB_PAGE_SIZE];
+      for (int i = 0; i < 20000; ++i) {
+        const page_id_t page_id = (t + i) % 4;
+        auto *page = bpm->FetchPage(page_id, AccessType::Get);
+        if (page == nullptr) {
+          continue;
+        }
+        EXPECT_EQ(page_id, page->GetPageId());
+        snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+        EXPECT_EQ(0, strcmp(page->GetData(), expected));
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  threads.emplace_back([&] {
+    char expected[BUSTUB_PAGE_SIZE];
+    for (int i = 0; !done; i = (i + 1) % (num_pages - 4)) {
+      const page_id_t page_id = 4 + i;
+      auto *page = bpm->FetchPage(page_id, AccessType::Scan);
+      if (page == nullptr) {
+        continue;
+      }
+      snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_id);
+      EXPECT_EQ(0, strcmp(page->GetData(), expected));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+  });
+  for (int t = 0; t < num_threads; ++t) {
+    threads[t].join();
+  }
+  done = true;
+  threads.back().join();
+
+  // Every pin was released, so every page can be deleted.
+  EXPECT_GT(bpm->GetHitCount(AccessType::Get), 0);
+  for (page_id_t i = 0; i < num_pages; ++i) {
+    EXPECT_EQ(true, bpm->DeletePage(i));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerTest, FlusherTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+
+  page_id_t page_id_temp;
+  std::vector<Page *> pages;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    pages.push_back(page);
+  }
+  // Page 0 stays pinned, the others are dirty and unpinned.
+  for (page_id_t i = 1; i < static_cast<page_id_t>(buffer_pool_size); ++i) {
+    EXPECT_EQ(true, bpm->UnpinPage(i, true));
+  }
+
+  // Scenario: the flusher writes out every unpinned dirty page, and leaves pinned ones alone.
+  bpm->StartFlusher(100);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  auto all_clean = [&] {
+    for (size_t i = 1; i < buffer_pool_size; ++i) {
+      if (pages[i]->IsDirty()) {
+        return false;
+      }
+    }
+    return true;
+  };
+  while (!all_clean() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(all_clean());
+  // Pages are marked clean before their write completes; stopping the flusher waits for the writes in flight.
+  bpm->StopFlusher();
+  const int writes = disk_manager->GetNumWrites();
+  EXPECT_EQ(static_cast<int>(buffer_pool_size) - 1, writes);
+
+  char data[BUSTUB_PAGE_SIZE];
+  char expected[BUSTUB_PAGE_SIZE];
+  for (page_id_t i = 1; i < static_cast<page_id_t>(buffer_pool_size); ++i) {
+    disk_manager->ReadPage(i, data);
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", i);
+    EXPECT_EQ(0, strcmp(data, expected));
+  }
+
+  // Scenario: evicting the clean pages writes nothing more.
+  for (size_t i = 1; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(writes, disk_manager->GetNumWrites());
+
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerTest, StatsTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+
+  // Scenario: writing twice as many pages as there are frames evicts and writes back the first half.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size, stats.evictions_);
+  EXPECT_EQ(buffer_pool_size, stats.write_backs_);
+  EXPECT_EQ(0U, stats.flusher_writes_);
+  EXPECT_EQ(buffer_pool_size, stats.pin_wait_.count_);
+  EXPECT_EQ(0, stats.GetHitRatio());
+
+  // Scenario: one miss and three hits, of different access types.
+  for (auto access_type : {AccessType::Get, AccessType::Get, AccessType::Scan}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(buffer_pool_size * 2 - 1, access_type));
+    EXPECT_EQ(true, bpm->UnpinPage(buffer_pool_size * 2 - 1, false));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(0, AccessType::Get));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  stats = bpm->GetStats();
+  EXPECT_EQ(2U, stats.hits_[static_cast<size_t>(AccessType::Get)]);
+  EXPECT_EQ(1U, stats.hits_[static_cast<size_t>(AccessType::Scan)]);
+  EXPECT_EQ(1U, stats.misses_[static_cast<size_t>(AccessType::Get)]);
+  EXPECT_EQ(0.75, stats.GetHitRatio());
+  EXPECT_EQ(buffer_pool_size + 1, stats.evictions_);
+  EXPECT_EQ(buffer_pool_size + 1, stats.write_backs_);
+
+  // Scenario: the disk manager measured every read and write.
+  EXPECT_EQ(1U, disk_manager->GetReadLatency().count_);
+  EXPECT_EQ(static_cast<uint64_t>(disk_manager->GetNumWrites()), disk_manager->GetWriteLatency().count_);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerTest, FetchPagesTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  const int reads = static_cast<int>(disk_manager->GetReadLatency().count_);
+
+  // Scenario: a batch of resident and evicted pages is returned in the order asked for, read latched. Only the
+  // evicted pages are read, and each of them once.
+  char expected[BUSTUB_PAGE_SIZE];
+  {
+    const std::vector<page_id_t> page_ids{15, 3, 1, 18, 7};
+    auto guards = bpm->FetchPagesRead(page_ids, AccessType::Get);
+    ASSERT_EQ(page_ids.size(), guards.size());
+    for (size_t i = 0; i < page_ids.size(); ++i) {
+      ASSERT_FALSE(guards[i].IsEmpty());
+      EXPECT_EQ(page_ids[i], guards[i].PageId());
+      snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_ids[i]);
+      EXPECT_EQ(0, strcmp(guards[i].GetData(), expected));
+    }
+    EXPECT_EQ(reads + 3, static_cast<int>(disk_manager->GetReadLatency().count_));
+    EXPECT_EQ(2U, bpm->GetHitCount(AccessType::Get));
+    EXPECT_EQ(3U, bpm->GetMissCount(AccessType::Get));
+  }
+
+  // Scenario: every page of a batch is pinned once, resident or not.
+  auto pages = bpm->FetchPages({4, 15});
+  ASSERT_EQ(2U, pages.size());
+  EXPECT_EQ(1, pages[0]->GetPinCount());
+  EXPECT_EQ(1, pages[1]->GetPinCount());
+
+  // Scenario: once every frame is pinned, the pages that do not fit are left out.
+  std::vector<page_id_t> page_ids;
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size * 2); ++i) {
+    if (i != 4 && i != 15) {
+      page_ids.push_back(i);
+    }
+  }
+  auto more_pages = bpm->FetchPages(page_ids);
+  EXPECT_EQ(buffer_pool_size - 2, std::count_if(more_pages.begin(), more_pages.end(), [](auto *p) { return p; }));
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    if (more_pages[i] != nullptr) {
+      EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+    }
+  }
+  EXPECT_EQ(true, bpm->UnpinPage(4, false));
+  EXPECT_EQ(true, bpm->UnpinPage(15, false));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerTest, HotSetTest) {
+  const std::string db_name = "test.db";
+  const std::string hot_set_file = "test.hot";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  // Pages 3, 5 and 7 are accessed twice, which makes them the hottest pages.
+  for (int round = 0; round < 2; round++) {
+    for (page_id_t i : {3, 5, 7}) {
+      ASSERT_NE(nullptr, bpm->FetchPage(i));
+      EXPECT_EQ(true, bpm->UnpinPage(i, false));
+    }
+  }
+
+  // Scenario: FlushAllPages saves the hot set, hottest pages first.
+  bpm->SetHotSetFile(hot_set_file);
+  bpm->FlushAllPages();
+  std::vector<page_id_t> hot_pages;
+  {
+    std::ifstream in(hot_set_file);
+    page_id_t page_id;
+    while (in >> page_id) {
+      hot_pages.push_back(page_id);
+    }
+  }
+  ASSERT_EQ(buffer_pool_size, hot_pages.size());
+  EXPECT_EQ((std::set<page_id_t>{3, 5, 7}), std::set<page_id_t>(hot_pages.begin(), hot_pages.begin() + 3));
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  // Scenario: after a restart with a smaller buffer pool, warming up reads back the hottest pages that fit, and
+  // fetching them afterwards is a hit.
+  const size_t small_pool_size = 4;
+  disk_manager = new DiskManager(db_name);
+  bpm = new BufferPoolManager(small_pool_size, disk_manager, 2);
+  EXPECT_EQ(0U, bpm->WarmUp("missing.hot"));
+  EXPECT_EQ(small_pool_size, bpm->WarmUp(hot_set_file));
+  char expected[BUSTUB_PAGE_SIZE];
+  for (size_t i = 0; i < small_pool_size; ++i) {
+    auto guard = bpm->FetchPageRead(hot_pages[i]);
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", hot_pages[i]);
+    EXPECT_EQ(0, strcmp(guard.GetData(), expected));
+  }
+  EXPECT_EQ(small_pool_size, bpm->GetHitCount(AccessType::Unknown));
+  EXPECT_EQ(0U, bpm->GetMissCount(AccessType::Unknown));
+
+  // Scenario: warm-up never evicts, and the reopened database allocates pages after the existing ones.
+  EXPECT_EQ(0U, bpm->WarmUp(hot_set_file));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(static_cast<page_id_t>(buffer_pool_size * 2), page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+
+  // Scenario: a background warm-up can be stopped at any time, throttled or not.
+  delete bpm;
+  bpm = new BufferPoolManager(small_pool_size, disk_manager, 2);
+  bpm->StartWarmUp(hot_set_file, 1);
+  bpm->StopWarmUp();
+  bpm->StartWarmUp(hot_set_file);
+  delete bpm;
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove(hot_set_file.c_str());
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerTest, CorruptPageTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+  remove(db_name.c_str());
+
+  DbFileOptions options;
+  options.checksums_ = true;
+  auto *disk_manager = new DiskManagerPosix(db_name, false, BUSTUB_PAGE_SIZE, options);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+  EXPECT_EQ(BUSTUB_PAGE_SIZE - PAGE_CHECKSUM_SIZE, bpm->GetUsablePageSize());
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  bpm->FlushAllPages();
+  // Pages 0 to 3 were evicted. Corrupt page 1 on disk.
+  {
+    std::fstream file(db_name, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(DB_FILE_HEADER_SIZE + BUSTUB_PAGE_SIZE + 2);
+    file.write("?", 1);
+  }
+  auto pin_whole_pool = [&] {
+    std::vector<page_id_t> page_ids;
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      page_ids.push_back(static_cast<page_id_t>(buffer_pool_size + i));
+    }
+    auto pages = bpm->FetchPages(page_ids);
+    const bool all_pinned = std::all_of(pages.begin(), pages.end(), [](auto *page) { return page != nullptr; });
+    for (size_t i = 0; i < page_ids.size(); ++i) {
+      if (pages[i] != nullptr) {
+        bpm->UnpinPage(page_ids[i], false);
+      }
+    }
+    return all_pinned;
+  };
+
+  // Scenario: fetching a corrupt page throws, every time, and leaves no frame behind.
+  for (int round = 0; round < 2; round++) {
+    EXPECT_THROW(bpm->FetchPage(1), PageCorruptionException);
+    EXPECT_THROW(bpm->FetchPageRead(1), PageCorruptionException);
+    EXPECT_TRUE(pin_whole_pool());
+  }
+
+  // Scenario: so does a prefetched corrupt page, and it is not written back.
+  const int writes = disk_manager->GetNumWrites();
+  EXPECT_TRUE(bpm->Prefetch(1));
+  bpm->FlushAllPages();
+  EXPECT_THROW(bpm->FetchPage(1), PageCorruptionException);
+  EXPECT_EQ(writes + static_cast<int>(buffer_pool_size) - 1, disk_manager->GetNumWrites());
+  EXPECT_TRUE(pin_whole_pool());
+
+  // Scenario: a batch with a corrupt page throws and releases the pins on the others.
+  EXPECT_THROW(bpm->FetchPages({0, 1, 2}), PageCorruptionException);
+  EXPECT_FALSE(bpm->UnpinPage(0, false));
+  EXPECT_TRUE(pin_whole_pool());
+
+  // Scenario: once the page is rewritten, it can be fetched again.
+  char data[BUSTUB_PAGE_SIZE] = "page 1";
+  disk_manager->WritePage(1, data);
+  {
+    auto guard = bpm->FetchPageRead(1);
+    EXPECT_EQ(0, strcmp(guard.GetData(), "page 1"));
+  }
+
+  delete bpm;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -0,0 +1,196 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache_test.cpp
+//
+// Identification: test/buffer/compressed_page_cache_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/compressed_page_cache.h"
+#include "common/util/compression_util.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+TEST(CompressedPageCacheTest, CompressionTest) {
+  std::mt19937 rng(15445);
+  std::vector<std::vector<char>> inputs;
+  inputs.emplace_back(BUSTUB_PAGE_SIZE, 0);
+  inputs.emplace_back();
+  inputs.emplace_back(3, 'x');
+  // A page of random bytes does not compress.
+  inputs.emplace_back(BUSTUB_PAGE_SIZE);
+  for (auto &byte : inputs.back()) {
+    byte = static_cast<char>(rng());
+  }
+  // A page of tuples at the end and zeros in the middle, like a table page.
+  const size_t tuple_size = 40;
+  inputs.emplace_back(BUSTUB_PAGE_SIZE, 0);
+  for (size_t offset = BUSTUB_PAGE_SIZE - tuple_size; offset > BUSTUB_PAGE_SIZE / 2; offset -= tuple_size) {
+    snprintf(&inputs.back()[offset], tuple_size, "tuple %zu, some text that repeats", offset);
+  }
+
+  // Scenario: every input comes back as it was, and pages with redundancy shrink.
+  std::vector<char> compressed;
+  std::vector<char> output;
+  for (const auto &input : inputs) {
+    const size_t size = CompressionUtil::Compress(input.data(), input.size(), &compressed);
+    ASSERT_EQ(size, compressed.size());
+    output.assign(input.size(), 1);
+    ASSERT_TRUE(CompressionUtil::Decompress(compressed.data(), size, output.data(), output.size()));
+    EXPECT_EQ(input, output);
+  }
+  EXPECT_LT(CompressionUtil::Compress(inputs[0].data(), BUSTUB_PAGE_SIZE, &compressed), 32);
+  EXPECT_LT(CompressionUtil::Compress(inputs[4].data(), BUSTUB_PAGE_SIZE, &compressed), BUSTUB_PAGE_SIZE / 4);
+
+  // Scenario: a truncated block, or one that decompresses to the wrong size, is rejected.
+  CompressionUtil::Compress(inputs[4].data(), BUSTUB_PAGE_SIZE, &compressed);
+  output.resize(BUSTUB_PAGE_SIZE);
+  EXPECT_FALSE(CompressionUtil::Decompress(compressed.data(), compressed.size() / 2, output.data(), output.size()));
+  EXPECT_FALSE(CompressionUtil::Decompress(compressed.data(), compressed.size(), output.data(), output.size() - 1));
+  compressed[1] = 0x7f;
+  compressed[0] = 0x0f;
+  EXPECT_FALSE(CompressionUtil::Decompress(compressed.data(), compressed.size(), output.data(), output.size()));
+}
+
+TEST(CompressedPageCacheTest, SampleTest) {
+  std::vector<char> page(BUSTUB_PAGE_SIZE, 0);
+  std::vector<char> output(BUSTUB_PAGE_SIZE);
+  CompressedPageCache cache(100, BUSTUB_PAGE_SIZE);
+
+  // Scenario: a page is handed back once, then it is gone.
+  for (page_id_t i = 0; i < 3; i++) {
+    page[0] = static_cast<char>(i + 1);
+    ASSERT_TRUE(cache.Insert(i, page.data()));
+  }
+  EXPECT_EQ(3, cache.GetNumPages());
+  ASSERT_TRUE(cache.Take(1, output.data()));
+  EXPECT_EQ(2, output[0]);
+  EXPECT_FALSE(cache.Take(1, output.data()));
+  EXPECT_EQ(1, cache.GetHitCount());
+
+  // Scenario: storing beyond the capacity drops the oldest pages first.
+  const size_t page_cost = cache.GetSize() / cache.GetNumPages();
+  for (page_id_t i = 3; cache.GetSize() + page_cost <= cache.GetCapacity(); i++) {
+    ASSERT_TRUE(cache.Insert(i, page.data()));
+  }
+  ASSERT_TRUE(cache.Insert(100, page.data()));
+  EXPECT_FALSE(cache.Take(0, output.data()));
+  EXPECT_TRUE(cache.Take(2, output.data()));
+  EXPECT_LE(cache.GetSize(), cache.GetCapacity());
+
+  // Scenario: a page that does not compress is not stored, and replaces an older copy of itself.
+  std::mt19937 rng(15445);
+  for (auto &byte : page) {
+    byte = static_cast<char>(rng());
+  }
+  EXPECT_FALSE(cache.Insert(100, page.data()));
+  EXPECT_FALSE(cache.Take(100, output.data()));
+
+  // Scenario: erased pages are gone.
+  cache.Erase(3);
+  EXPECT_FALSE(cache.Take(3, output.data()));
+}
+
+TEST(CompressedPageCacheTest, ReserveTest) {
+  std::vector<char> page(BUSTUB_PAGE_SIZE, 0);
+  std::vector<char> output(BUSTUB_PAGE_SIZE);
+  CompressedPageCache cache(1 << 20, BUSTUB_PAGE_SIZE);
+
+  // Scenario: a copy compressed after its reservation is stored, once.
+  page[0] = 1;
+  auto ticket = cache.Reserve(0);
+  ASSERT_TRUE(cache.Insert(0, page.data(), ticket));
+  EXPECT_FALSE(cache.Insert(0, page.data(), ticket));
+  ASSERT_TRUE(cache.Take(0, output.data()));
+  EXPECT_EQ(1, output[0]);
+
+  // Scenario: the page was taken back, deleted or reserved again before its copy landed, the late copy is dropped.
+  ticket = cache.Reserve(1);
+  EXPECT_FALSE(cache.Take(1, output.data()));
+  EXPECT_FALSE(cache.Insert(1, page.data(), ticket));
+  ticket = cache.Reserve(1);
+  cache.Erase(1);
+  EXPECT_FALSE(cache.Insert(1, page.data(), ticket));
+  ticket = cache.Reserve(1);
+  auto newer_ticket = cache.Reserve(1);
+  page[0] = 2;
+  ASSERT_TRUE(cache.Insert(1, page.data(), newer_ticket));
+  page[0] = 3;
+  EXPECT_FALSE(cache.Insert(1, page.data(), ticket));
+  ASSERT_TRUE(cache.Take(1, output.data()));
+  EXPECT_EQ(2, output[0]);
+  EXPECT_EQ(0, cache.GetNumPages());
+}
+
+TEST(CompressedPageCacheTest, BufferPoolTest) {
+  const size_t buffer_pool_size = 4;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  bpm->SetCompressedCacheSize(1 << 20);
+
+  page_id_t page_id;
+  for (page_id_t i = 0; i < 12; i++) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(bpm->FlushPage(page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(12 - buffer_pool_size, bpm->GetStats().compressed_pages_);
+
+  // Scenario: pages evicted from the pool come back from the compressed cache, without a disk read.
+  const auto reads = disk_manager->GetReadLatency().count_;
+  for (page_id_t i = 0; i < 8; i++) {
+    auto guard = bpm->FetchPageRead(i);
+    EXPECT_EQ("page " + std::to_string(i), std::string(guard.GetData()));
+  }
+  EXPECT_EQ(reads, disk_manager->GetReadLatency().count_);
+  EXPECT_EQ(8, bpm->GetStats().compressed_hits_);
+
+  // Scenario: a page changed in the pool is written back when evicted, and its compressed copy is the new version.
+  {
+    auto guard = bpm->FetchPageWrite(0);
+    snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "page 0 changed");
+  }
+  for (page_id_t i = 8; i < 12; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i));
+    ASSERT_TRUE(bpm->UnpinPage(i, false));
+  }
+  std::vector<char> on_disk(BUSTUB_PAGE_SIZE);
+  disk_manager->ReadPage(0, on_disk.data());
+  EXPECT_EQ("page 0 changed", std::string(on_disk.data()));
+  EXPECT_EQ("page 0 changed", std::string(bpm->FetchPageRead(0).GetData()));
+  EXPECT_EQ(reads + 1, disk_manager->GetReadLatency().count_);
+
+  // Scenario: deleting a page drops its compressed copy.
+  const auto pages = bpm->GetStats().compressed_pages_;
+  ASSERT_TRUE(bpm->DeletePage(1));
+  EXPECT_EQ(pages - 1, bpm->GetStats().compressed_pages_);
+
+  // Scenario: prefetches are served from the compressed cache too.
+  ASSERT_TRUE(bpm->Prefetch(2));
+  EXPECT_EQ("page 2", std::string(bpm->FetchPageRead(2).GetData()));
+  EXPECT_EQ(reads + 1, disk_manager->GetReadLatency().count_);
+
+  // Scenario: without the compressed cache, evicted pages are read from disk.
+  bpm->SetCompressedCacheSize(0);
+  for (page_id_t i = 4; i < 12; i++) {
+    EXPECT_EQ("page " + std::to_string(i), std::string(bpm->FetchPageRead(i).GetData()));
+  }
+  EXPECT_GT(disk_manager->GetReadLatency().count_, reads + 1);
+}
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_test.cpp
+//
+// Identification: test/buffer/frame_arena_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/frame_arena.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+TEST(FrameArenaTest, SampleTest) {
+  const size_t num_frames = 10;
+  FrameArena arena(num_frames, BUSTUB_PAGE_SIZE, {});
+
+  // Scenario: frames are aligned, zeroed, and do not overlap.
+  std::set<char *> frames;
+  for (size_t i = 0; i < num_frames; i++) {
+    char *frame = arena.GetFrame(static_cast<frame_id_t>(i));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(frame) % BUSTUB_PAGE_ALIGNMENT);
+    for (size_t j = 0; j < BUSTUB_PAGE_SIZE; j++) {
+      ASSERT_EQ(0, frame[j]);
+    }
+    frames.insert(frame);
+  }
+  ASSERT_EQ(num_frames, frames.size());
+  for (auto it = frames.begin(); std::next(it) != frames.end(); ++it) {
+    EXPECT_GE(*std::next(it) - *it, BUSTUB_PAGE_SIZE);
+  }
+
+  // Scenario: writing a whole frame leaves its neighbours alone.
+  memset(arena.GetFrame(4), 0xff, BUSTUB_PAGE_SIZE);
+  EXPECT_EQ(0, arena.GetFrame(3)[BUSTUB_PAGE_SIZE - 1]);
+  EXPECT_EQ(0, arena.GetFrame(5)[0]);
+}
+
+TEST(FrameArenaTest, OptionsTest) {
+  // Scenario: every combination of options gives usable frames, whether or not the machine has a hugetlbfs pool or
+  // several NUMA nodes.
+  for (auto huge_pages : {HugePageMode::None, HugePageMode::Transparent, HugePageMode::Explicit}) {
+    for (auto numa_placement : {NumaPlacement::FirstTouch, NumaPlacement::Interleave}) {
+      FrameArenaOptions options;
+      options.huge_pages_ = huge_pages;
+      options.numa_placement_ = numa_placement;
+      FrameArena arena(3, BUSTUB_PAGE_SIZE, options);
+      EXPECT_TRUE(huge_pages == HugePageMode::Explicit || !arena.IsHugeTlb());
+      for (frame_id_t i = 0; i < 3; i++) {
+        memset(arena.GetFrame(i), i + 1, BUSTUB_PAGE_SIZE);
+      }
+      for (frame_id_t i = 0; i < 3; i++) {
+        EXPECT_EQ(i + 1, arena.GetFrame(i)[0]);
+        EXPECT_EQ(i + 1, arena.GetFrame(i)[BUSTUB_PAGE_SIZE - 1]);
+      }
+    }
+  }
+}
+
+TEST(FrameArenaTest, BufferPoolTest) {
+  auto disk_manager = std::make_unique<DiskManagerMemory>(100);
+  FrameArenaOptions options;
+  options.huge_pages_ = HugePageMode::Explicit;
+  options.numa_placement_ = NumaPlacement::Interleave;
+  auto bpm = std::make_unique<BufferPoolManager>(4, disk_manager.get(), LRUK_REPLACER_K, nullptr, ReplacerType::LRUK,
+                                                 options);
+
+  // Scenario: the metadata of each frame sits on its own cache lines, and pages survive eviction.
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(bpm->GetPages()) % BUSTUB_CACHE_LINE_SIZE);
+  EXPECT_EQ(0, sizeof(Page) % BUSTUB_CACHE_LINE_SIZE);
+  for (page_id_t i = 0; i < 8; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(i, page_id);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(page->GetData()) % BUSTUB_PAGE_ALIGNMENT);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", i);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (page_id_t i = 0; i < 8; i++) {
+    auto guard = bpm->FetchPageRead(i);
+    EXPECT_EQ("page " + std::to_string(i), std::string(guard.GetData()));
+  }
+}
+
+}  // namespace bustub
@@ -16,7 +16,7 @@
 
 namespace bustub {
 
-TEST(LRUKReplacerTest, DISABLED_SampleTest) {
+TEST(LRUKReplacerTest, SampleTest) {
   LRUKReplacer lru_replacer(7, 2);
 
   // Scenario: add six elements to the replacer. We have [1,2,3,4,5]. Frame 6 is non-evictable.
@@ -95,4 +95,110 @@ TEST(LRUKReplacerTest, DISABLED_SampleTest) {
   ASSERT_EQ(false, lru_replacer.Evict(&value));
   ASSERT_EQ(0, lru_replacer.Size());
 }
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  LRUKReplacer lru_replacer(7, 2);
+  frame_id_t value;
+
+  // Scenario: frames 1 and 2 are the working set, frames 3, 4 and 5 are read by a sequential scan.
+  lru_replacer.RecordAccess(1, AccessType::Get);
+  lru_replacer.RecordAccess(2, AccessType::Get);
+  lru_replacer.RecordAccess(2, AccessType::Get);
+  lru_replacer.RecordAccess(3, AccessType::Scan);
+  lru_replacer.RecordAccess(4, AccessType::Scan);
+  lru_replacer.RecordAccess(5, AccessType::Scan);
+  for (frame_id_t fid = 1; fid <= 5; fid++) {
+    lru_replacer.SetEvictable(fid, true);
+  }
+
+  // Scenario: the scan passes over frame 1 again and touches frame 3 a second time. A scan does not promote a frame of
+  // the working set, and scan-only frames are evicted first, least recently used first: [4,5,3,1,2].
+  lru_replacer.RecordAccess(1, AccessType::Scan);
+  lru_replacer.RecordAccess(3, AccessType::Scan);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(4, value);
+
+  // Scenario: a regular access turns frame 5 into a working set frame with +inf backward k-distance. The order of
+  // eviction is now [3,1,5,2].
+  lru_replacer.RecordAccess(5, AccessType::Get);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(5, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_EQ(0, lru_replacer.Size());
+}
+
+TEST(LRUKReplacerTest, PrefetchTest) {
+  LRUKReplacer lru_replacer(7, 2);
+  frame_id_t value;
+
+  // Scenario: frames 1 and 2 are the working set, frame 3 was read by a scan, frames 4 and 5 were read ahead of it.
+  lru_replacer.RecordAccess(1, AccessType::Get);
+  lru_replacer.RecordAccess(2, AccessType::Get);
+  lru_replacer.RecordAccess(2, AccessType::Get);
+  lru_replacer.RecordAccess(3, AccessType::Scan);
+  lru_replacer.RecordAccess(4, AccessType::Prefetch);
+  lru_replacer.RecordAccess(5, AccessType::Prefetch);
+  for (frame_id_t fid = 1; fid <= 5; fid++) {
+    lru_replacer.SetEvictable(fid, true);
+  }
+
+  // Scenario: the scan reaches frame 4, which becomes a regular scan-only frame. Frame 5 is still waiting for the scan
+  // and is only evicted before the frames with k accesses: [3,4,1,5,2].
+  lru_replacer.RecordAccess(4, AccessType::Scan);
+  for (frame_id_t expected : {3, 4, 1, 5, 2}) {
+    ASSERT_EQ(true, lru_replacer.Evict(&value));
+    ASSERT_EQ(expected, value);
+  }
+  ASSERT_EQ(0, lru_replacer.Size());
+
+  // Scenario: frame 1 is a cold page of the working set, frame 2 was read ahead. While the scan may still get to
+  // frame 2, frame 1 goes first.
+  lru_replacer.RecordAccess(1, AccessType::Get);
+  lru_replacer.RecordAccess(2, AccessType::Prefetch);
+  lru_replacer.SetEvictable(1, true);
+  lru_replacer.SetEvictable(2, true);
+  for (int i = 0; i < 6; i++) {
+    lru_replacer.RecordAccess(3, AccessType::Get);
+  }
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+
+  // Scenario: once the pool has seen more accesses than it has frames, the unused read-ahead of frame 2 goes before
+  // the cold frame 1.
+  lru_replacer.RecordAccess(1, AccessType::Get);
+  lru_replacer.SetEvictable(1, true);
+  lru_replacer.RecordAccess(3, AccessType::Get);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+}
+
+TEST(LRUKReplacerTest, HotFramesTest) {
+  LRUKReplacer lru_replacer(7, 2);
+
+  // Scenario: the same frames as above, and frame 6 is pinned. Pinned frames come first, then the evictable frames in
+  // the reverse of the eviction order [3,4,1,5,2]. Frame 0 was never accessed.
+  lru_replacer.RecordAccess(1, AccessType::Get);
+  lru_replacer.RecordAccess(2, AccessType::Get);
+  lru_replacer.RecordAccess(2, AccessType::Get);
+  lru_replacer.RecordAccess(3, AccessType::Scan);
+  lru_replacer.RecordAccess(4, AccessType::Prefetch);
+  lru_replacer.RecordAccess(5, AccessType::Prefetch);
+  lru_replacer.RecordAccess(6, AccessType::Get);
+  for (frame_id_t fid = 1; fid <= 5; fid++) {
+    lru_replacer.SetEvictable(fid, true);
+  }
+  lru_replacer.RecordAccess(4, AccessType::Scan);
+  ASSERT_EQ((std::vector<frame_id_t>{6, 2, 5, 1, 4, 3}), lru_replacer.GetHotFrames());
+
+  // Scenario: evicted frames are no longer listed.
+  frame_id_t value;
+  ASSERT_EQ(true, lru_replacer.Evict(&value));
+  ASSERT_EQ((std::vector<frame_id_t>{6, 2, 5, 1, 4}), lru_replacer.GetHotFrames());
+}
 }  // namespace bustub
@@ -19,44 +19,66 @@
 
 namespace bustub {
 
-TEST(LRUReplacerTest, DISABLED_SampleTest) {
+TEST(LRUReplacerTest, SampleTest) {
   LRUReplacer lru_replacer(7);
 
-  // Scenario: unpin six elements, i.e. add them to the replacer.
-  lru_replacer.Unpin(1);
-  lru_replacer.Unpin(2);
-  lru_replacer.Unpin(3);
-  lru_replacer.Unpin(4);
-  lru_replacer.Unpin(5);
-  lru_replacer.Unpin(6);
-  lru_replacer.Unpin(1);
+  // Scenario: access six frames and make them evictable, i.e. add them to the replacer.
+  for (frame_id_t i = 1; i <= 6; ++i) {
+    lru_replacer.RecordAccess(i);
+    lru_replacer.SetEvictable(i, true);
+  }
+  // Accessing 1 again makes it the most recently used frame.
+  lru_replacer.RecordAccess(1);
   EXPECT_EQ(6, lru_replacer.Size());
 
   // Scenario: get three victims from the lru.
   int value;
-  lru_replacer.Victim(&value);
-  EXPECT_EQ(1, value);
-  lru_replacer.Victim(&value);
+  lru_replacer.Evict(&value);
   EXPECT_EQ(2, value);
-  lru_replacer.Victim(&value);
+  lru_replacer.Evict(&value);
   EXPECT_EQ(3, value);
+  lru_replacer.Evict(&value);
+  EXPECT_EQ(4, value);
 
   // Scenario: pin elements in the replacer.
-  // Note that 3 has already been victimized, so pinning 3 should have no effect.
-  lru_replacer.Pin(3);
-  lru_replacer.Pin(4);
+  // Note that 3 has already been evicted, so pinning 3 should have no effect.
+  lru_replacer.SetEvictable(3, false);
+  lru_replacer.SetEvictable(5, false);
   EXPECT_EQ(2, lru_replacer.Size());
 
-  // Scenario: unpin 4. We expect that the reference bit of 4 will be set to 1.
-  lru_replacer.Unpin(4);
+  // Scenario: access and unpin 5, which makes it the most recently used frame.
+  lru_replacer.RecordAccess(5);
+  lru_replacer.SetEvictable(5, true);
 
   // Scenario: continue looking for victims. We expect these victims.
-  lru_replacer.Victim(&value);
-  EXPECT_EQ(5, value);
-  lru_replacer.Victim(&value);
+  lru_replacer.Evict(&value);
   EXPECT_EQ(6, value);
-  lru_replacer.Victim(&value);
-  EXPECT_EQ(4, value);
+  lru_replacer.Evict(&value);
+  EXPECT_EQ(1, value);
+  lru_replacer.Evict(&value);
+  EXPECT_EQ(5, value);
+  EXPECT_EQ(false, lru_replacer.Evict(&value));
+}
+
+TEST(LRUReplacerTest, ScanTest) {
+  LRUReplacer lru_replacer(7);
+
+  // Scenario: a frame brought in by a scan is the next victim, and scan accesses do not move a frame.
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(3, AccessType::Scan);
+  lru_replacer.RecordAccess(1, AccessType::Scan);
+  for (frame_id_t i = 1; i <= 3; ++i) {
+    lru_replacer.SetEvictable(i, true);
+  }
+
+  int value;
+  lru_replacer.Evict(&value);
+  EXPECT_EQ(3, value);
+  lru_replacer.Evict(&value);
+  EXPECT_EQ(1, value);
+  lru_replacer.Evict(&value);
+  EXPECT_EQ(2, value);
 }
 
 }  // namespace bustub
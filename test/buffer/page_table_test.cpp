@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table_test.cpp
+//
+// Identification: test/buffer/page_table_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/page_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(PageTableTest, SampleTest) {
+  PageTable page_table(8);
+  frame_id_t frame_id;
+
+  // Scenario: an entry is found right away, but only reported ready once it is marked so.
+  page_table.Insert(3, 0);
+  ASSERT_TRUE(page_table.Find(3, &frame_id));
+  EXPECT_EQ(0, frame_id);
+  EXPECT_FALSE(page_table.FindReady(3, &frame_id));
+  page_table.SetReady(3);
+  ASSERT_TRUE(page_table.FindReady(3, &frame_id));
+  EXPECT_EQ(0, frame_id);
+  EXPECT_FALSE(page_table.Find(4, &frame_id));
+  EXPECT_EQ(1, page_table.Size());
+
+  // Scenario: inserting a page again remaps it, and the new entry is not ready.
+  page_table.Insert(3, 5);
+  ASSERT_TRUE(page_table.Find(3, &frame_id));
+  EXPECT_EQ(5, frame_id);
+  EXPECT_FALSE(page_table.FindReady(3, &frame_id));
+  EXPECT_EQ(1, page_table.Size());
+
+  // Scenario: erased entries are gone, erasing a missing page is a no-op.
+  page_table.Erase(3);
+  page_table.Erase(4);
+  EXPECT_FALSE(page_table.Find(3, &frame_id));
+  EXPECT_EQ(0, page_table.Size());
+}
+
+TEST(PageTableTest, ChurnTest) {
+  // Scenario: keep the table full while pages come and go, so that it has to clean up its tombstones.
+  const size_t num_frames = 16;
+  PageTable page_table(num_frames);
+  frame_id_t frame_id;
+
+  for (page_id_t page_id = 0; page_id < 10000; ++page_id) {
+    if (page_id >= static_cast<page_id_t>(num_frames)) {
+      page_table.Erase(page_id - num_frames);
+    }
+    page_table.Insert(page_id, page_id % num_frames);
+    page_table.SetReady(page_id);
+    ASSERT_EQ(std::min<size_t>(page_id + 1, num_frames), page_table.Size());
+  }
+  for (page_id_t page_id = 0; page_id < 10000; ++page_id) {
+    if (page_id < 10000 - static_cast<page_id_t>(num_frames)) {
+      EXPECT_FALSE(page_table.Find(page_id, &frame_id));
+    } else {
+      ASSERT_TRUE(page_table.FindReady(page_id, &frame_id));
+      EXPECT_EQ(page_id % num_frames, frame_id);
+    }
+  }
+}
+
+TEST(PageTableTest, ConcurrentReadTest) {
+  // Scenario: lock-free readers never see a page mapped to a frame it was not inserted with.
+  const size_t num_frames = 64;
+  PageTable page_table(num_frames);
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_frames / 2); ++page_id) {
+    page_table.Insert(page_id, page_id);
+    page_table.SetReady(page_id);
+  }
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&] {
+      frame_id_t frame_id;
+      while (!done) {
+        for (page_id_t page_id = 0; page_id < 100000; page_id += 7) {
+          if (page_table.FindReady(page_id, &frame_id)) {
+            ASSERT_EQ(page_id % static_cast<page_id_t>(num_frames), frame_id);
+          }
+        }
+      }
+    });
+  }
+
+  // The writer keeps half of the frames mapped while it churns through pages.
+  for (page_id_t page_id = num_frames / 2; page_id < 100000; ++page_id) {
+    page_table.Erase(page_id - num_frames / 2);
+    page_table.Insert(page_id, page_id % num_frames);
+    page_table.SetReady(page_id);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,231 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/exception.h"
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const size_t num_instances = 5;
+  const size_t buffer_pool_size = 2;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get(), k);
+  EXPECT_EQ(num_instances * buffer_pool_size, bpm->GetPoolSize());
+
+  // Scenario: New pages are spread round-robin across the instances, one page id per instance.
+  page_id_t page_id_temp;
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_instances * buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    page_ids.push_back(page_id_temp);
+  }
+  std::sort(page_ids.begin(), page_ids.end());
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    EXPECT_EQ(static_cast<page_id_t>(i), page_ids[i]);
+  }
+
+  // Scenario: Once every instance is full, we should not be able to create any new pages.
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: Unpinning a page only frees a frame in the instance that owns it.
+  EXPECT_EQ(true, bpm->UnpinPage(3, true));
+  EXPECT_EQ(false, bpm->UnpinPage(3, true));
+  auto *page = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(3, page_id_temp % static_cast<page_id_t>(num_instances));
+  EXPECT_EQ(nullptr, bpm->FetchPage(3));
+
+  // Scenario: After unpinning everything, all the pages can be fetched back with their content.
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  for (auto id : page_ids) {
+    bpm->UnpinPage(id, true);
+  }
+  for (auto id : page_ids) {
+    auto guard = bpm->FetchPageRead(id);
+    EXPECT_EQ(0, strcmp(guard.GetData(), fmt::format("page {}", id).c_str()));
+  }
+
+  // Scenario: Deleting a pinned page fails, deleting an unpinned page succeeds.
+  page = bpm->FetchPage(page_ids[0]);
+  EXPECT_EQ(false, bpm->DeletePage(page_ids[0]));
+  EXPECT_EQ(true, bpm->UnpinPage(page_ids[0], false));
+  EXPECT_EQ(true, bpm->DeletePage(page_ids[0]));
+
+  disk_manager->ShutDown();
+}
+
+TEST(ParallelBufferPoolManagerTest, SegmentTest) {
+  const size_t num_instances = 4;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, 16, disk_manager.get(), 2);
+
+  // Scenario: pages created in a segment, or near a page of one, stay in its extents whichever instance creates them.
+  const segment_id_t segments[] = {bpm->CreateSegment(), bpm->CreateSegment()};
+  std::vector<page_id_t> pages[2];
+  for (int i = 0; i < 2; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPageInSegment(&page_id, segments[i]));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    pages[i].push_back(page_id);
+  }
+  for (size_t round = 0; round < 2 * EXTENT_PAGES; round++) {
+    for (int i = 0; i < 2; i++) {
+      page_id_t page_id;
+      ASSERT_NE(nullptr, bpm->NewPageNear(&page_id, pages[i].back()));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      pages[i].push_back(page_id);
+    }
+  }
+  for (int i = 0; i < 2; i++) {
+    for (auto page_id : pages[i]) {
+      EXPECT_EQ(segments[i], disk_manager->GetSegment(page_id)) << page_id;
+    }
+    EXPECT_EQ(3, disk_manager->GetSegmentExtents(segments[i]).size());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, FetchPagesTest) {
+  const size_t num_instances = 3;
+  const size_t buffer_pool_size = 4;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get(), 2);
+
+  page_id_t page_id;
+  for (size_t i = 0; i < 2 * num_instances * buffer_pool_size; i++) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: a batch spread over every instance, resident and evicted pages mixed, comes back in the order asked for.
+  const std::vector<page_id_t> page_ids{20, 1, 13, 5, 22, 9, 0};
+  char expected[BUSTUB_PAGE_SIZE];
+  auto guards = bpm->FetchPagesRead(page_ids);
+  ASSERT_EQ(page_ids.size(), guards.size());
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    ASSERT_FALSE(guards[i].IsEmpty());
+    EXPECT_EQ(page_ids[i], guards[i].PageId());
+    snprintf(expected, BUSTUB_PAGE_SIZE, "page %d", page_ids[i]);
+    EXPECT_STREQ(expected, guards[i].GetData());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, CorruptionTest) {
+  const std::string db_name = "test.db";
+  const size_t num_instances = 3;
+  const size_t buffer_pool_size = 2;
+  remove(db_name.c_str());
+
+  DbFileOptions options;
+  options.checksums_ = true;
+  auto disk_manager = std::make_unique<DiskManagerPosix>(db_name, false, BUSTUB_PAGE_SIZE, options);
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get(), 2);
+
+  page_id_t page_id;
+  for (size_t i = 0; i < 2 * num_instances * buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+  bpm->FlushAllPages();
+  // Pages 0 to 5 were evicted. Corrupt page 4, which belongs to the second instance.
+  {
+    std::fstream file(db_name, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(DB_FILE_HEADER_SIZE + 4 * BUSTUB_PAGE_SIZE + 2);
+    file.write("?", 1);
+  }
+
+  // Scenario: a batch with a corrupt page throws, and the pages the other instances fetched for it are not pinned.
+  EXPECT_THROW(bpm->FetchPages({0, 4, 2}), PageCorruptionException);
+  EXPECT_FALSE(bpm->UnpinPage(0, false));
+  EXPECT_FALSE(bpm->UnpinPage(2, false));
+
+  // Scenario: every frame of every instance can still be pinned.
+  const std::vector<page_id_t> page_ids{0, 1, 2, 6, 7, 8};
+  auto pages = bpm->FetchPages(page_ids);
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    ASSERT_NE(nullptr, pages[i]) << page_ids[i];
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 8;
+  const size_t num_threads = 8;
+  const size_t num_pages = 256;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get());
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    auto guard = bpm->NewPageGuarded(&page_id);
+    *guard.AsMut<page_id_t>() = page_id;
+    page_ids.push_back(page_id);
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&bpm, &page_ids, tid] {
+      std::default_random_engine gen(tid);
+      std::uniform_int_distribution<size_t> dist(0, page_ids.size() - 1);
+      for (size_t i = 0; i < 2000; ++i) {
+        auto page_id = page_ids[dist(gen)];
+        if (i % 4 == 0) {
+          auto guard = bpm->FetchPageWrite(page_id);
+          ASSERT_EQ(page_id, *guard.As<page_id_t>());
+          *guard.AsMut<page_id_t>() = page_id;
+        } else {
+          auto guard = bpm->FetchPageRead(page_id);
+          ASSERT_EQ(page_id, *guard.As<page_id_t>());
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  disk_manager->ShutDown();
+}
+
+}  // namespace bustub
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer_test.cpp
+//
+// Identification: test/buffer/two_queue_replacer_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <vector>
+
+#include "buffer/two_queue_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(TwoQueueReplacerTest, SampleTest) {
+  // 8 frames, so A1in should hold 2 frames and A1out remembers 4 pages.
+  TwoQueueReplacer replacer(8);
+
+  // Scenario: pages seen once go to A1in.
+  for (frame_id_t i = 0; i < 4; ++i) {
+    replacer.RecordAccess(i, AccessType::Get, 100 + i);
+    replacer.SetEvictable(i, true);
+  }
+  // A second access while the page is in A1in does not promote it.
+  replacer.RecordAccess(0, AccessType::Get, 100);
+  EXPECT_EQ(4, replacer.Size());
+
+  // Scenario: A1in is over its target size, so it is evicted first, in FIFO order. Pages 100 and 101 go to A1out.
+  frame_id_t value;
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+
+  // Scenario: page 100 comes back while in A1out and goes to Am. Page 101 comes back through a scan, which does not
+  // promote it.
+  replacer.RecordAccess(0, AccessType::Get, 100);
+  replacer.SetEvictable(0, true);
+  replacer.RecordAccess(1, AccessType::Scan, 101);
+  replacer.SetEvictable(1, true);
+
+  // Scenario: A1in = {2, 3, 1} is evicted until it is back to its target size, then Am = {0} goes before the rest of
+  // A1in.
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+  EXPECT_FALSE(replacer.Evict(&value));
+  EXPECT_EQ(0, replacer.Size());
+}
+
+TEST(TwoQueueReplacerTest, PinTest) {
+  TwoQueueReplacer replacer(8);
+
+  // Scenario: Am is LRU ordered, and pinned frames are skipped in both queues.
+  for (frame_id_t i = 0; i < 3; ++i) {
+    replacer.RecordAccess(i, AccessType::Get, 100 + i);
+    replacer.SetEvictable(i, true);
+  }
+  frame_id_t value;
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  replacer.RecordAccess(0, AccessType::Get, 100);
+  replacer.SetEvictable(0, true);
+  replacer.RecordAccess(3, AccessType::Get, 103);
+  replacer.RecordAccess(4, AccessType::Get, 104);
+  replacer.SetEvictable(4, true);
+  // A1in = {1, 2, 3 (pinned), 4}, Am = {0}.
+  replacer.SetEvictable(1, false);
+  EXPECT_EQ(3, replacer.Size());
+
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(4, value);
+  ASSERT_TRUE(replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_FALSE(replacer.Evict(&value));
+
+  // Scenario: removing a pinned frame is an error, removing an unknown frame does nothing.
+  EXPECT_THROW(replacer.Remove(1), std::logic_error);
+  replacer.Remove(5);
+  replacer.SetEvictable(1, true);
+  replacer.Remove(1);
+  EXPECT_EQ(0, replacer.Size());
+}
+
+}  // namespace bustub
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// metrics_test.cpp
+//
+// Identification: test/common/metrics_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sstream>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "common/metrics.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(MetricsTest, StripedCounterTest) {
+  StripedCounter counter;
+  EXPECT_EQ(0, counter.Get());
+
+  // Scenario: concurrent adds from many threads are all counted.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&counter] {
+      for (int j = 0; j < 1000; j++) {
+        counter.Add();
+      }
+      counter.Add(10);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(8 * 1010, counter.Get());
+}
+
+TEST(MetricsTest, LatencyHistogramTest) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.GetSnapshot().count_);
+  EXPECT_EQ(0, histogram.GetSnapshot().PercentileMicros(99));
+
+  // Scenario: latencies land in power of two buckets of microseconds.
+  histogram.Record(std::chrono::nanoseconds(500));
+  histogram.Record(std::chrono::microseconds(1));
+  histogram.Record(std::chrono::microseconds(3));
+  histogram.Record(std::chrono::microseconds(100));
+  auto snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(4, snapshot.count_);
+  EXPECT_EQ(1, snapshot.buckets_[0]);
+  EXPECT_EQ(1, snapshot.buckets_[1]);
+  EXPECT_EQ(1, snapshot.buckets_[2]);
+  EXPECT_EQ(1, snapshot.buckets_[7]);
+  EXPECT_DOUBLE_EQ(104.5 / 4, snapshot.MeanMicros());
+
+  // Scenario: percentiles report the upper end of their bucket.
+  EXPECT_EQ(1, snapshot.PercentileMicros(25));
+  EXPECT_EQ(4, snapshot.PercentileMicros(75));
+  EXPECT_EQ(128, snapshot.PercentileMicros(99));
+
+  // Scenario: very long latencies go to the last bucket, and snapshots add up.
+  histogram.Record(std::chrono::hours(1));
+  snapshot += histogram.GetSnapshot();
+  EXPECT_EQ(9, snapshot.count_);
+  EXPECT_EQ(1, snapshot.buckets_[LatencyHistogram::NUM_BUCKETS - 1]);
+}
+
+TEST(MetricsTest, ShowBufferPoolStatsTest) {
+  BustubInstance instance;
+  std::stringstream result;
+  SimpleStreamWriter writer(result, true, "=");
+  instance.ExecuteSql("CREATE TABLE t (a int);", writer);
+
+  // Scenario: SHOW bpm_stats and the \bpm shell command list the counters as name/value rows.
+  for (const auto *sql : {"SHOW bpm_stats;", "\\bpm"}) {
+    result.str("");
+    ASSERT_TRUE(instance.ExecuteSql(sql, writer));
+    const auto output = result.str();
+    EXPECT_NE(std::string::npos, output.find("pool_size=128=")) << output;
+    EXPECT_NE(std::string::npos, output.find("hit_ratio=")) << output;
+    EXPECT_NE(std::string::npos, output.find("evictions=0=")) << output;
+    EXPECT_NE(std::string::npos, output.find("disk_read.p99_us=")) << output;
+  }
+}
+
+}  // namespace bustub
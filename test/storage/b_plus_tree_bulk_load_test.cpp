@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_builder.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using Builder = BPlusTreeBuilder<GenericKey<8>, RID, GenericComparator<8>>;
+using InternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+
+/**
+ * Check that every page of the subtree is within its size bounds, and collect its leaves from left to right.
+ * @return the height of the subtree
+ */
+auto CheckSubtree(BufferPoolManager *bpm, page_id_t page_id, bool is_root, std::vector<page_id_t> *leaves) -> int {
+  auto guard = bpm->FetchPageRead(page_id);
+  const auto *page = guard.As<BPlusTreePage>();
+  EXPECT_LE(page->GetSize(), page->GetMaxSize());
+  if (!is_root) {
+    EXPECT_GE(page->GetSize(), page->GetMinSize());
+  }
+  if (page->IsLeafPage()) {
+    leaves->push_back(page_id);
+    return 1;
+  }
+  const auto *internal = guard.As<InternalPage>();
+  EXPECT_GE(internal->GetSize(), 2);
+  int height = -1;
+  for (int i = 0; i < internal->GetSize(); i++) {
+    const int child_height = CheckSubtree(bpm, internal->ValueAt(i), false, leaves);
+    EXPECT_TRUE(height == -1 || height == child_height);
+    height = child_height;
+  }
+  return height + 1;
+}
+
+TEST(BPlusTreeBulkLoadTest, BuilderTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  std::mt19937 rng(445);
+
+  for (auto [leaf_max_size, internal_max_size] : {std::pair{2, 3}, std::pair{3, 3}, std::pair{4, 5}}) {
+    for (int64_t num_keys = 0; num_keys < 80; num_keys += 3) {
+      auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+      auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+      page_id_t header_page_id;
+      bpm->NewPage(&header_page_id);
+      Tree tree("foo_pk", header_page_id, bpm.get(), comparator, leaf_max_size, internal_max_size);
+
+      // Scenario: every key is added twice in random order, and the sort spills runs of 7 entries, except the last 1 to
+      // 7 entries which stay in memory.
+      std::vector<int64_t> keys(num_keys);
+      std::iota(keys.begin(), keys.end(), 0);
+      Builder builder(&tree, comparator, 7 * (sizeof(GenericKey<8>) + sizeof(RID)), 100);
+      GenericKey<8> index_key;
+      for (int32_t slot = 0; slot < 2; slot++) {
+        std::shuffle(keys.begin(), keys.end(), rng);
+        for (auto key : keys) {
+          index_key.SetFromInteger(key);
+          builder.Add(index_key, RID(static_cast<page_id_t>(key), slot));
+        }
+      }
+      EXPECT_EQ(num_keys == 0 ? 0 : (num_keys * 2 - 1) / 7, builder.GetNumRuns());
+      ASSERT_EQ(num_keys, builder.Finish());
+
+      // Scenario: the first entry added with a key wins, and the keys come out in order.
+      int64_t next_key = 0;
+      for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+        ASSERT_EQ(next_key, (*iter).first.ToString());
+        EXPECT_EQ(RID(static_cast<page_id_t>(next_key), 0), (*iter).second);
+        next_key++;
+      }
+      EXPECT_EQ(num_keys, next_key);
+
+      // Scenario: every page is within its size bounds, all leaves are at the same depth and laid out in key order.
+      std::vector<page_id_t> leaves;
+      if (num_keys > 0) {
+        CheckSubtree(bpm.get(), tree.GetRootPageId(), true, &leaves);
+      }
+      EXPECT_TRUE(std::is_sorted(leaves.begin(), leaves.end()));
+
+      // Scenario: the tree can be changed as usual afterwards.
+      index_key.SetFromInteger(num_keys);
+      EXPECT_TRUE(tree.Insert(index_key, RID(static_cast<page_id_t>(num_keys), 0)));
+      keys.push_back(num_keys);
+      std::shuffle(keys.begin(), keys.end(), rng);
+      for (auto key : keys) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key, nullptr);
+        std::vector<RID> rids;
+        EXPECT_FALSE(tree.GetValue(index_key, &rids));
+      }
+      EXPECT_TRUE(tree.IsEmpty());
+      bpm->UnpinPage(header_page_id, true);
+    }
+  }
+}
+
+TEST(BPlusTreeBulkLoadTest, FillFactorTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  // Scenario: leaves are packed to the fill factor, but never under their min size.
+  for (auto [fill_percent, num_leaves] : {std::pair{100, 10}, std::pair{50, 20}, std::pair{10, 20}}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+    page_id_t header_page_id;
+    bpm->NewPage(&header_page_id);
+    Tree tree("foo_pk", header_page_id, bpm.get(), comparator, 10, 10);
+
+    int64_t next_key = 0;
+    tree.BulkLoad(
+        [&next_key](GenericKey<8> *key, RID *rid) {
+          if (next_key == 100) {
+            return false;
+          }
+          key->SetFromInteger(next_key);
+          *rid = RID(next_key++);
+          return true;
+        },
+        fill_percent);
+    std::vector<page_id_t> leaves;
+    CheckSubtree(bpm.get(), tree.GetRootPageId(), true, &leaves);
+    EXPECT_EQ(num_leaves, leaves.size());
+
+    // Scenario: a bulk load into a tree that is not empty, or from keys out of order, is refused.
+    auto out_of_order = [](GenericKey<8> *key, RID *rid) {
+      key->SetFromInteger(0);
+      return true;
+    };
+    EXPECT_THROW(tree.BulkLoad(out_of_order, fill_percent), std::logic_error);
+    bpm->UnpinPage(header_page_id, true);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_duplicate_test.cpp
+//
+// Identification: test/storage/b_plus_tree_duplicate_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+TEST(BPlusTreeDuplicateTest, TiebreakerTest) {
+  auto key_schema = ParseCreateStatement("a int");
+  NormalizedComparator<16> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  BPlusTree<NormalizedKey<16>, RID, NormalizedComparator<16>> tree("foo_pk", header_page_id, bpm.get(), comparator, 3,
+                                                                    3);
+
+  // Scenario: few distinct keys with many rids each, so that the entries of a key span several leaves.
+  std::mt19937 rng(445);
+  std::map<int32_t, std::vector<RID>> entries;
+  NormalizedKey<16> index_key;
+  for (int i = 0; i < 400; i++) {
+    const auto column = static_cast<int32_t>(rng() % 7) - 3;
+    const RID rid(static_cast<page_id_t>(rng() % 50), rng() % 50);
+    index_key.SetFromKey(Tuple({Value(TypeId::INTEGER, column)}, key_schema.get()), *key_schema, rid);
+    auto &rids = entries[column];
+    const bool is_new = std::find(rids.begin(), rids.end(), rid) == rids.end();
+    EXPECT_EQ(is_new, tree.Insert(index_key, rid));
+    if (is_new) {
+      rids.push_back(rid);
+    }
+  }
+
+  // Scenario: remove a third of the entries by key and rid, which leaves the other entries of the key alone.
+  for (auto &[column, rids] : entries) {
+    std::shuffle(rids.begin(), rids.end(), rng);
+    const size_t keep = rids.size() - rids.size() / 3;
+    for (size_t i = keep; i < rids.size(); i++) {
+      index_key.SetFromKey(Tuple({Value(TypeId::INTEGER, column)}, key_schema.get()), *key_schema, rids[i]);
+      tree.Remove(index_key, nullptr);
+    }
+    rids.resize(keep);
+  }
+
+  // Scenario: a key without rid finds every entry with its columns, in rid order.
+  std::vector<RID> result;
+  for (int32_t column = -4; column <= 4; column++) {
+    result.clear();
+    index_key.SetFromKey(Tuple({Value(TypeId::INTEGER, column)}, key_schema.get()), *key_schema);
+    auto expected = entries[column];
+    std::sort(expected.begin(), expected.end(), [](const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); });
+    EXPECT_EQ(!expected.empty(), tree.GetValue(index_key, &result)) << column;
+    EXPECT_EQ(expected, result) << column;
+  }
+}
+
+TEST(BPlusTreeDuplicateTest, IndexTest) {
+  auto schema = ParseCreateStatement("a int,b int");
+  for (std::vector<uint32_t> key_attrs : {std::vector<uint32_t>{0}, std::vector<uint32_t>{0, 1}}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+    BPlusTreeIndexForTwoIntegerColumn index(
+        std::make_unique<IndexMetadata>("foo_idx", "foo", schema.get(), key_attrs), bpm.get());
+
+    // Scenario: a secondary index holds every tuple with the same key, and forgets them one at a time.
+    const auto *key_schema = index.GetKeySchema();
+    auto key_of = [&](int32_t a) {
+      std::vector<Value> values{Value(TypeId::INTEGER, a), Value(TypeId::INTEGER, 7)};
+      values.resize(key_attrs.size());
+      return Tuple(values, key_schema);
+    };
+    for (int32_t slot = 0; slot < 100; slot++) {
+      EXPECT_TRUE(index.InsertEntry(key_of(slot % 3), RID(1, slot), nullptr));
+    }
+    EXPECT_FALSE(index.InsertEntry(key_of(0), RID(1, 0), nullptr));
+
+    std::vector<RID> result;
+    index.ScanKey(key_of(1), &result, nullptr);
+    EXPECT_EQ(33, result.size());
+    index.DeleteEntry(key_of(1), RID(1, 4), nullptr);
+    result.clear();
+    index.ScanKey(key_of(1), &result, nullptr);
+    EXPECT_EQ(32, result.size());
+    EXPECT_EQ(result.end(), std::find(result.begin(), result.end(), RID(1, 4)));
+    result.clear();
+    index.ScanKey(key_of(3), &result, nullptr);
+    EXPECT_TRUE(result.empty());
+  }
+}
+
+}  // namespace bustub
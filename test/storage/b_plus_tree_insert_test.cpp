@@ -23,7 +23,7 @@ namespace bustub {
 
 using bustub::DiskManagerUnlimitedMemory;
 
-TEST(BPlusTreeTests, DISABLED_InsertTest1) {
+TEST(BPlusTreeTests, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -62,7 +62,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest2) {
+TEST(BPlusTreeTests, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -120,7 +120,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest2) {
   delete bpm;
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest3) {
+TEST(BPlusTreeTests, InsertTest3) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -184,4 +184,61 @@ TEST(BPlusTreeTests, DISABLED_InsertTest3) {
   delete transaction;
   delete bpm;
 }
+
+TEST(BPlusTreeTests, PageSizeTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  using LeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+
+  const size_t page_size = 8 * BUSTUB_PAGE_SIZE;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>(page_size);
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  ASSERT_EQ(page_size, bpm->GetPageSize());
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  // With the default sizes, the pages of the tree fill the pages of the buffer pool.
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm.get(), comparator);
+  GenericKey<8> index_key;
+  RID rid;
+  auto transaction = std::make_unique<Transaction>(0);
+
+  const int64_t num_keys = LeafPage::Capacity(page_size);
+  ASSERT_GT(num_keys, 7 * LeafPage::Capacity(BUSTUB_PAGE_SIZE));
+  for (int64_t key = num_keys; key > 0; key--) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, rid, transaction.get()));
+  }
+  {
+    auto guard = bpm->FetchPageRead(tree.GetRootPageId());
+    auto root = guard.As<LeafPage>();
+    ASSERT_TRUE(root->IsLeafPage());
+    EXPECT_EQ(num_keys, root->GetSize());
+  }
+
+  // One more key splits the root leaf.
+  rid.Set(0, num_keys + 1);
+  index_key.SetFromInteger(num_keys + 1);
+  ASSERT_TRUE(tree.Insert(index_key, rid, transaction.get()));
+  {
+    auto guard = bpm->FetchPageRead(tree.GetRootPageId());
+    EXPECT_FALSE(guard.As<BPlusTreePage>()->IsLeafPage());
+  }
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= num_keys + 1; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(key, rids[0].GetSlotNum());
+  }
+
+  // The space per key is counted in pages of the buffer pool: two leaves and their root.
+  auto stats = tree.GetStats();
+  EXPECT_EQ(3, stats.NumPages());
+  EXPECT_DOUBLE_EQ(static_cast<double>(3 * page_size) / static_cast<double>(num_keys + 1), stats.BytesPerKey());
+
+  bpm->UnpinPage(page_id, true);
+}
 }  // namespace bustub
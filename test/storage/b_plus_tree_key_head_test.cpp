@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_head_test.cpp
+//
+// Identification: test/storage/b_plus_tree_key_head_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/normalized_key.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+auto Normalize(const Value &value, size_t size = 64) -> std::string {
+  std::string out(size, '\0');
+  NormalizedKeyWriter writer(out.data(), out.size());
+  writer.Append(value);
+  out.resize(writer.Size());
+  return out;
+}
+
+/** Check that the encodings of values given in increasing order increase, and that their prefixes do not decrease. */
+void CheckOrder(const std::vector<Value> &values) {
+  for (size_t i = 1; i < values.size(); i++) {
+    ASSERT_TRUE(values[i - 1].IsNull() || values[i - 1].CompareLessThan(values[i]) == CmpBool::CmpTrue) << i;
+    EXPECT_LT(Normalize(values[i - 1]), Normalize(values[i])) << i;
+    for (size_t size = 1; size < 6; size++) {
+      EXPECT_LE(Normalize(values[i - 1], size), Normalize(values[i], size)) << i;
+    }
+  }
+}
+
+TEST(NormalizedKeyTest, OrderTest) {
+  // Scenario: NULL comes first, and signed integers order across zero.
+  CheckOrder({ValueFactory::GetNullValueByType(TypeId::INTEGER), ValueFactory::GetIntegerValue(-1000000),
+              ValueFactory::GetIntegerValue(-1), ValueFactory::GetIntegerValue(0), ValueFactory::GetIntegerValue(1),
+              ValueFactory::GetIntegerValue(255), ValueFactory::GetIntegerValue(256)});
+  CheckOrder({ValueFactory::GetBigIntValue(-(int64_t{1} << 40)), ValueFactory::GetBigIntValue(-7),
+              ValueFactory::GetBigIntValue(7), ValueFactory::GetBigIntValue(int64_t{1} << 40)});
+  CheckOrder({ValueFactory::GetSmallIntValue(-300), ValueFactory::GetSmallIntValue(-2),
+              ValueFactory::GetSmallIntValue(2), ValueFactory::GetSmallIntValue(300)});
+  CheckOrder({ValueFactory::GetDecimalValue(-1e10), ValueFactory::GetDecimalValue(-1.5),
+              ValueFactory::GetDecimalValue(-0.25), ValueFactory::GetDecimalValue(0),
+              ValueFactory::GetDecimalValue(0.25), ValueFactory::GetDecimalValue(2.5),
+              ValueFactory::GetDecimalValue(1e300)});
+
+  // Scenario: -0.0 and 0.0 are equal, and so are their encodings.
+  EXPECT_EQ(Normalize(ValueFactory::GetDecimalValue(-0.0)), Normalize(ValueFactory::GetDecimalValue(0.0)));
+
+  // Scenario: a varchar orders before its extensions, even those that start with '\0', which is escaped.
+  CheckOrder({ValueFactory::GetVarcharValue(""), ValueFactory::GetVarcharValue("a"),
+              ValueFactory::GetVarcharValue("a\0", 3, false), ValueFactory::GetVarcharValue("a\0b", 4, false),
+              ValueFactory::GetVarcharValue("ab"), ValueFactory::GetVarcharValue("b")});
+  EXPECT_EQ(std::string("\x01"
+                        "a\0\xff"
+                        "b\0\0",
+                        7),
+            Normalize(ValueFactory::GetVarcharValue("a\0b", 4, false)));
+}
+
+TEST(NormalizedKeyTest, ComparatorTest) {
+  auto key_schema = ParseCreateStatement("a int,b bigint");
+  GenericComparator<16> generic_comparator(key_schema.get());
+  NormalizedComparator<24> normalized_comparator(key_schema.get());
+  std::mt19937 rng(445);
+  std::uniform_int_distribution<int32_t> first(-3, 3);
+  std::uniform_int_distribution<int64_t> second(-(int64_t{1} << 50), int64_t{1} << 50);
+
+  // Scenario: normalized keys compare like generic keys built from the same tuples.
+  auto make_tuple = [&] {
+    return Tuple({Value(TypeId::INTEGER, first(rng)), Value(TypeId::BIGINT, second(rng) >> (rng() % 64))},
+                 key_schema.get());
+  };
+  for (int i = 0; i < 2000; i++) {
+    auto lhs_tuple = make_tuple();
+    auto rhs_tuple = i % 10 == 0 ? lhs_tuple : make_tuple();
+    GenericKey<16> lhs_generic;
+    GenericKey<16> rhs_generic;
+    lhs_generic.SetFromKey(lhs_tuple, *key_schema);
+    rhs_generic.SetFromKey(rhs_tuple, *key_schema);
+    NormalizedKey<24> lhs_normalized;
+    NormalizedKey<24> rhs_normalized;
+    lhs_normalized.SetFromKey(lhs_tuple, *key_schema);
+    rhs_normalized.SetFromKey(rhs_tuple, *key_schema);
+    EXPECT_EQ(generic_comparator(lhs_generic, rhs_generic), normalized_comparator(lhs_normalized, rhs_normalized));
+  }
+
+  // Scenario: the test-only integer keys round trip.
+  NormalizedKey<24> key;
+  for (int64_t value : {int64_t{-5}, int64_t{0}, int64_t{1} << 40}) {
+    key.SetFromInteger(value);
+    EXPECT_EQ(value, key.ToString());
+  }
+
+  // Scenario: a key whose encoding does not fit is rejected rather than truncated.
+  auto varchar_schema = ParseCreateStatement("a varchar(32)");
+  Tuple tuple({ValueFactory::GetVarcharValue("a string of twenty bytes")}, varchar_schema.get());
+  EXPECT_THROW(key.SetFromKey(tuple, *varchar_schema), Exception);
+}
+
+/** Insert and remove random keys, then check that the tree finds exactly the keys left, in order. */
+template <class KeyType, class KeyComparator>
+void RandomInsertRemove() {
+  auto key_schema = ParseCreateStatement("a bigint");
+  KeyComparator comparator(key_schema.get());
+  std::mt19937 rng(445);
+
+  for (auto [leaf_max_size, internal_max_size] : {std::pair{0, 0}, std::pair{5, 4}}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+    page_id_t header_page_id;
+    bpm->NewPage(&header_page_id);
+    BPlusTree<KeyType, RID, KeyComparator> tree("foo_pk", header_page_id, bpm.get(), comparator, leaf_max_size,
+                                                internal_max_size);
+
+    // Scenario: keys cluster around a few bases, so pages share long prefixes that inserts keep breaking.
+    std::set<int64_t> keys;
+    const std::vector<int64_t> bases = {-(int64_t{1} << 40), 0, int64_t{1} << 40};
+    std::uniform_int_distribution<int64_t> offset(0, 3000);
+    KeyType index_key;
+    for (int i = 0; i < 6000; i++) {
+      const int64_t key = bases[rng() % bases.size()] + offset(rng);
+      index_key.SetFromInteger(key);
+      if (rng() % 3 == 0) {
+        tree.Remove(index_key, nullptr);
+        keys.erase(key);
+      } else {
+        EXPECT_EQ(keys.insert(key).second, tree.Insert(index_key, RID(key)));
+      }
+    }
+
+    std::vector<RID> rids;
+    for (const auto &base : bases) {
+      for (int64_t key = base - 1; key <= base + 3001; key++) {
+        rids.clear();
+        index_key.SetFromInteger(key);
+        EXPECT_EQ(keys.count(key) == 1, tree.GetValue(index_key, &rids)) << key;
+      }
+    }
+
+    auto it = keys.begin();
+    for (auto iter = tree.Begin(); !iter.IsEnd(); ++iter, ++it) {
+      ASSERT_NE(keys.end(), it);
+      EXPECT_EQ(*it, (*iter).first.ToString());
+    }
+    EXPECT_EQ(keys.end(), it);
+
+    // Scenario: the stats count every key, and the internal pages below the root, which spans every base, keep the
+    // sign and high bytes of their keys as prefix.
+    auto stats = tree.GetStats();
+    EXPECT_EQ(keys.size(), stats.num_keys_);
+    EXPECT_GE(stats.internal_prefix_bytes_, 4 * (stats.internal_pages_ - 1));
+  }
+}
+
+TEST(BPlusTreeKeyHeadTest, RandomTest) { RandomInsertRemove<GenericKey<8>, GenericComparator<8>>(); }
+
+TEST(BPlusTreeKeyHeadTest, NormalizedKeyTest) { RandomInsertRemove<NormalizedKey<24>, NormalizedComparator<24>>(); }
+
+}  // namespace bustub
@@ -10,11 +10,24 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstring>
+#include <fstream>
+#include <future>  // NOLINT
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
+#include "common/util/crc32c_util.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/disk/disk_manager_uring.h"
+#include "storage/disk/double_write_buffer.h"
 
 namespace bustub {
 
@@ -24,13 +37,22 @@ class DiskManagerTest : public ::testing::Test {
   void SetUp() override {
     remove("test.db");
     remove("test.log");
+    remove("test.dwb");
   }
 
   // This function is called after every test.
   void TearDown() override {
     remove("test.db");
     remove("test.log");
+    remove("test.dwb");
   };
+
+  /** Overwrite bytes of a page in the database file behind the disk manager's back. */
+  static void ScribbleOnPage(page_id_t page_id, size_t page_size, size_t offset, const std::string &bytes) {
+    std::fstream file("test.db", std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(DB_FILE_HEADER_SIZE + page_id * page_size + offset);
+    file.write(bytes.data(), bytes.size());
+  }
 };
 
 // NOLINTNEXTLINE
@@ -52,6 +74,15 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
   dm.ReadPage(5, buf);
   EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
 
+  // Pages at and past the end of the file were never written, and read as zeros over whatever the buffer held.
+  for (page_id_t page_id : {6, 9}) {
+    std::memcpy(buf, data, sizeof(buf));
+    dm.ReadPage(page_id, buf);
+    for (char c : buf) {
+      ASSERT_EQ(0, c) << page_id;
+    }
+  }
+
   dm.ShutDown();
 }
 
@@ -72,6 +103,521 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixConcurrentReadWriteTest) {
+  const int num_threads = 8;
+  const int pages_per_thread = 64;
+
+  for (bool direct_io : {false, true}) {
+    auto dm = std::make_unique<DiskManagerPosix>("test.db", direct_io);
+
+    // Every thread owns a disjoint set of pages, writes them, and reads back both its own pages and those of the
+    // other threads while they are being written. Reads of another thread's page must only see zeros or that
+    // thread's data.
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([&dm, tid] {
+        char data[BUSTUB_PAGE_SIZE];
+        char buf[BUSTUB_PAGE_SIZE];
+        for (int i = 0; i < pages_per_thread; i++) {
+          page_id_t page_id = i * num_threads + tid;
+          std::memset(data, 'a' + tid, sizeof(data));
+          dm->WritePage(page_id, data);
+          dm->ReadPage(page_id, buf);
+          ASSERT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+          page_id_t other = i * num_threads + (tid + 1) % num_threads;
+          dm->ReadPage(other, buf);
+          for (char c : buf) {
+            ASSERT_TRUE(c == 0 || c == static_cast<char>('a' + (tid + 1) % num_threads));
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    dm->Sync();
+    EXPECT_EQ(num_threads * pages_per_thread, dm->GetNumWrites());
+    dm->ShutDown();
+
+    // Everything must be there after reopening the file.
+    dm = std::make_unique<DiskManagerPosix>("test.db", direct_io);
+    char buf[BUSTUB_PAGE_SIZE];
+    for (page_id_t page_id = 0; page_id < num_threads * pages_per_thread; page_id++) {
+      dm->ReadPage(page_id, buf);
+      EXPECT_EQ(static_cast<char>('a' + page_id % num_threads), buf[BUSTUB_PAGE_SIZE - 1]);
+    }
+    dm->ShutDown();
+    remove("test.db");
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, UringAsyncReadWriteTest) {
+  const int num_pages = 512;
+  auto dm = std::make_unique<DiskManagerUring>("test.db", false, 32);
+
+  // Keep many requests in flight at once, more than the queue depth, and submit them as one batch.
+  std::vector<std::vector<char>> data(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<std::future<bool>> futures;
+  for (int i = 0; i < num_pages; i++) {
+    snprintf(data[i].data(), BUSTUB_PAGE_SIZE, "page %d", i);
+    std::promise<bool> promise;
+    futures.emplace_back(promise.get_future());
+    dm->WritePageAsync(i, data[i].data(), std::move(promise));
+  }
+  dm->SubmitPageRequests();
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  EXPECT_EQ(num_pages, dm->GetNumWrites());
+
+  std::vector<std::vector<char>> bufs(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  futures.clear();
+  for (int i = num_pages - 1; i >= 0; i--) {
+    std::promise<bool> promise;
+    futures.emplace_back(promise.get_future());
+    dm->ReadPageAsync(i, bufs[i].data(), std::move(promise));
+  }
+  dm->SubmitPageRequests();
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  EXPECT_EQ(data, bufs);
+
+  // Requests on the same page complete in issue order, even within one batch.
+  char buf1[BUSTUB_PAGE_SIZE];
+  char buf2[BUSTUB_PAGE_SIZE];
+  std::promise<bool> p1;
+  std::promise<bool> p2;
+  std::promise<bool> p3;
+  std::promise<bool> p4;
+  auto f1 = p1.get_future();
+  auto f2 = p2.get_future();
+  auto f3 = p3.get_future();
+  auto f4 = p4.get_future();
+  dm->WritePageAsync(num_pages, data[0].data(), std::move(p1));
+  dm->ReadPageAsync(num_pages, buf1, std::move(p2));
+  dm->WritePageAsync(num_pages, data[1].data(), std::move(p3));
+  dm->ReadPageAsync(num_pages, buf2, std::move(p4));
+  dm->SubmitPageRequests();
+  f1.get();
+  f2.get();
+  f3.get();
+  f4.get();
+  EXPECT_EQ(0, std::memcmp(buf1, data[0].data(), BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(0, std::memcmp(buf2, data[1].data(), BUSTUB_PAGE_SIZE));
+
+  // Reading past the end of the file zero-fills the page.
+  std::memset(buf1, 1, sizeof(buf1));
+  dm->ReadPage(num_pages * 2, buf1);
+  for (char c : buf1) {
+    ASSERT_EQ(0, c);
+  }
+
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PageSizeTest) {
+  const size_t page_size = 4 * BUSTUB_PAGE_SIZE;
+  std::vector<char> data(page_size);
+  std::vector<char> buf(page_size);
+
+  for (int backend = 0; backend < 3; backend++) {
+    auto open = [backend](size_t page_size) -> std::unique_ptr<DiskManager> {
+      if (backend == 0) {
+        return std::make_unique<DiskManager>("test.db", page_size);
+      }
+      if (backend == 1) {
+        return std::make_unique<DiskManagerPosix>("test.db", true, page_size);
+      }
+      return std::make_unique<DiskManagerUring>("test.db", false, URING_QUEUE_DEPTH, page_size);
+    };
+    remove("test.db");
+
+    // Scenario: the page size is chosen when the file is created.
+    auto dm = open(page_size);
+    EXPECT_EQ(page_size, dm->GetPageSize());
+    for (page_id_t page_id = 0; page_id < 3; page_id++) {
+      std::fill(data.begin(), data.end(), static_cast<char>('a' + page_id));
+      data[page_size - 1] = 'z';
+      dm->WritePage(page_id, data.data());
+    }
+    dm->ShutDown();
+
+    // Scenario: reopening the file keeps the page size it was created with.
+    dm = open(BUSTUB_PAGE_SIZE);
+    EXPECT_EQ(page_size, dm->GetPageSize());
+    for (page_id_t page_id = 0; page_id < 3; page_id++) {
+      dm->ReadPage(page_id, buf.data());
+      EXPECT_EQ(static_cast<char>('a' + page_id), buf[0]);
+      EXPECT_EQ('z', buf[page_size - 1]);
+    }
+    dm->ShutDown();
+  }
+
+  // Scenario: page sizes must be powers of two between 4KB and 64KB.
+  remove("test.db");
+  EXPECT_THROW(DiskManager("test.db", 1000), Exception);
+  EXPECT_THROW(DiskManager("test.db", 2 * BUSTUB_MAX_PAGE_SIZE), Exception);
+  EXPECT_THROW(DiskManagerUnlimitedMemory(3 * BUSTUB_PAGE_SIZE), Exception);
+
+  // Scenario: a file without a database header is refused, unless it could be a database from before there was one.
+  {
+    std::ofstream file("test.db", std::ios::binary | std::ios::trunc);
+    file << std::string(DB_FILE_HEADER_SIZE + 100, 'x');
+  }
+  EXPECT_THROW(DiskManager("test.db"), Exception);
+  EXPECT_THROW(DiskManagerPosix("test.db"), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, LegacyFileTest) {
+  std::vector<char> buf(BUSTUB_PAGE_SIZE);
+
+  for (int backend = 0; backend < 2; backend++) {
+    auto open = [backend]() -> std::unique_ptr<DiskManager> {
+      if (backend == 0) {
+        return std::make_unique<DiskManager>("test.db", 4 * BUSTUB_PAGE_SIZE, DbFileOptions{true, false});
+      }
+      return std::make_unique<DiskManagerPosix>("test.db", false, 4 * BUSTUB_PAGE_SIZE, DbFileOptions{true, false});
+    };
+
+    // Scenario: a file written before the header existed holds 4KB pages from offset 0.
+    {
+      std::ofstream file("test.db", std::ios::binary | std::ios::trunc);
+      for (char c : {'a', 'b', 'c'}) {
+        file << std::string(BUSTUB_PAGE_SIZE, c);
+      }
+    }
+
+    // Scenario: it is opened with 4KB pages and without checksums, whatever the options ask for, and keeps its layout.
+    auto dm = open();
+    EXPECT_EQ(BUSTUB_PAGE_SIZE, dm->GetPageSize());
+    EXPECT_EQ(3, dm->GetNumPages());
+    for (page_id_t page_id = 0; page_id < 3; page_id++) {
+      dm->ReadPage(page_id, buf.data());
+      EXPECT_EQ(static_cast<char>('a' + page_id), buf[0]);
+      EXPECT_EQ(static_cast<char>('a' + page_id), buf[BUSTUB_PAGE_SIZE - 1]);
+    }
+    EXPECT_EQ(3, dm->AllocatePage());
+    std::fill(buf.begin(), buf.end(), 'd');
+    dm->WritePage(3, buf.data());
+    dm->ShutDown();
+
+    std::ifstream file("test.db", std::ios::binary | std::ios::ate);
+    EXPECT_EQ(4 * BUSTUB_PAGE_SIZE, file.tellg());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, Crc32cTest) {
+  // Scenario: the check value of CRC-32C, and an empty buffer.
+  EXPECT_EQ(0xe3069283, Crc32cUtil::Checksum("123456789", 9));
+  EXPECT_EQ(0xe3069283, Crc32cUtil::ChecksumPortable("123456789", 9));
+  EXPECT_EQ(0, Crc32cUtil::Checksum("", 0));
+
+  // Scenario: the hardware path agrees with the portable one on every length and alignment, and checksums chain.
+  std::mt19937 generator(42);
+  std::vector<char> data(3 * BUSTUB_PAGE_SIZE + 17);
+  for (auto &byte : data) {
+    byte = static_cast<char>(generator());
+  }
+  for (size_t size : {1, 7, 8, 9, 100, 383, 384, 385, 1000, 3072, 4096, 4103, 12288}) {
+    for (size_t start : {0, 1, 3}) {
+      const char *buffer = data.data() + start;
+      const uint32_t crc = Crc32cUtil::ChecksumPortable(buffer, size);
+      EXPECT_EQ(crc, Crc32cUtil::Checksum(buffer, size)) << size << " bytes at " << start;
+      EXPECT_EQ(crc, Crc32cUtil::Checksum(buffer + size / 3, size - size / 3, Crc32cUtil::Checksum(buffer, size / 3)));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ChecksumTest) {
+  const size_t page_size = 2 * BUSTUB_PAGE_SIZE;
+  std::vector<char> data(page_size);
+  std::vector<char> buf(page_size);
+  DbFileOptions options;
+  options.checksums_ = true;
+
+  for (int backend = 0; backend < 3; backend++) {
+    auto open = [backend, page_size](const DbFileOptions &options) -> std::unique_ptr<DiskManager> {
+      if (backend == 0) {
+        return std::make_unique<DiskManager>("test.db", page_size, options);
+      }
+      if (backend == 1) {
+        return std::make_unique<DiskManagerPosix>("test.db", true, page_size, options);
+      }
+      return std::make_unique<DiskManagerUring>("test.db", false, URING_QUEUE_DEPTH, page_size, options);
+    };
+    remove("test.db");
+
+    // Scenario: a file created with checksums reserves the end of every page for them, and pages read back whole.
+    auto dm = open(options);
+    EXPECT_TRUE(dm->HasChecksums());
+    ASSERT_EQ(page_size - PAGE_CHECKSUM_SIZE, dm->GetUsablePageSize());
+    for (page_id_t page_id = 0; page_id < 3; page_id++) {
+      std::fill(data.begin(), data.end(), static_cast<char>('a' + page_id));
+      dm->WritePage(page_id, data.data());
+    }
+    for (page_id_t page_id = 0; page_id < 3; page_id++) {
+      dm->ReadPage(page_id, buf.data());
+      EXPECT_EQ(std::string(dm->GetUsablePageSize(), static_cast<char>('a' + page_id)),
+                std::string(buf.data(), dm->GetUsablePageSize()));
+    }
+
+    // Scenario: a page that was never written reads as zeros.
+    dm->ReadPage(3, buf.data());
+    EXPECT_EQ(std::string(page_size, '\0'), std::string(buf.data(), page_size));
+    dm->ShutDown();
+
+    // Scenario: reopening the file keeps its checksums, whatever the options say.
+    dm = open({});
+    EXPECT_TRUE(dm->HasChecksums());
+
+    // Scenario: a flipped byte, a torn write and a page written at the wrong place all fail the read, synchronous
+    // and asynchronous alike.
+    ScribbleOnPage(1, page_size, 100, "x");
+    ScribbleOnPage(2, page_size, page_size / 2, std::string(page_size / 2, '\0'));
+    dm->ReadPage(0, data.data());
+    {
+      std::fstream file("test.db", std::ios::binary | std::ios::in | std::ios::out);
+      file.seekp(DB_FILE_HEADER_SIZE + 3 * page_size);
+      file.write(data.data(), page_size);
+    }
+    for (page_id_t page_id = 1; page_id < 4; page_id++) {
+      try {
+        dm->ReadPage(page_id, buf.data());
+        ADD_FAILURE() << "page " << page_id << " is corrupt";
+      } catch (const PageCorruptionException &e) {
+        EXPECT_EQ(page_id, e.GetPageId());
+        EXPECT_EQ(ExceptionType::CORRUPTION, e.GetType());
+      }
+      std::promise<bool> promise;
+      auto future = promise.get_future();
+      dm->ReadPageAsync(page_id, buf.data(), std::move(promise));
+      dm->SubmitPageRequests();
+      EXPECT_THROW(future.get(), PageCorruptionException);
+    }
+    dm->ReadPage(0, buf.data());
+    dm->ShutDown();
+  }
+
+  // Scenario: files are created without checksums by default.
+  remove("test.db");
+  DiskManager dm("test.db");
+  EXPECT_FALSE(dm.HasChecksums());
+  EXPECT_EQ(BUSTUB_PAGE_SIZE, dm.GetUsablePageSize());
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DoubleWriteTest) {
+  std::vector<char> data(BUSTUB_PAGE_SIZE);
+  std::vector<char> buf(BUSTUB_PAGE_SIZE);
+  DbFileOptions options;
+  options.checksums_ = true;
+  options.double_write_ = true;
+  auto fill = [&data](page_id_t page_id, int version) {
+    std::fill(data.begin(), data.end(), static_cast<char>(page_id + version * 16));
+  };
+  // Pages read back carry their checksum in the trailer, which the written copies do not.
+  const size_t usable_size = BUSTUB_PAGE_SIZE - PAGE_CHECKSUM_SIZE;
+  auto same = [&buf, usable_size](const std::vector<char> &page) {
+    return memcmp(page.data(), buf.data(), usable_size) == 0;
+  };
+
+  for (bool uring : {false, true}) {
+    remove("test.db");
+    std::unique_ptr<DiskManagerPosix> dm;
+    if (uring) {
+      dm = std::make_unique<DiskManagerUring>("test.db", false, URING_QUEUE_DEPTH, BUSTUB_PAGE_SIZE, options);
+    } else {
+      dm = std::make_unique<DiskManagerPosix>("test.db", false, BUSTUB_PAGE_SIZE, options);
+    }
+    ASSERT_NE(nullptr, dm->GetDoubleWriteBuffer());
+
+    // Scenario: synchronous writes go through the buffer one by one, asynchronous ones in a single batch per submit,
+    // even when there are more of them than slots.
+    for (page_id_t page_id = 0; page_id < 5; page_id++) {
+      fill(page_id, 0);
+      dm->WritePage(page_id, data.data());
+    }
+    EXPECT_EQ(5, dm->GetDoubleWriteBuffer()->GetNumSyncs());
+    const page_id_t num_pages = DOUBLE_WRITE_BUFFER_PAGES + 10;
+    std::vector<std::vector<char>> pages(num_pages);
+    std::vector<std::future<bool>> futures;
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      fill(page_id, 1);
+      pages[page_id] = data;
+      auto promise = std::promise<bool>();
+      futures.push_back(promise.get_future());
+      dm->WritePageAsync(page_id, pages[page_id].data(), std::move(promise));
+    }
+    // A read from the thread that holds the writes back sees them.
+    auto promise = std::promise<bool>();
+    auto read = promise.get_future();
+    dm->ReadPageAsync(3, buf.data(), std::move(promise));
+    dm->SubmitPageRequests();
+    EXPECT_TRUE(read.get());
+    EXPECT_TRUE(same(pages[3]));
+    for (auto &future : futures) {
+      EXPECT_TRUE(future.get());
+    }
+    // The 59 slots left after the synchronous writes, then the start of the ring again.
+    EXPECT_EQ(5 + 2, dm->GetDoubleWriteBuffer()->GetNumSyncs());
+
+    // Scenario: the process dies, and a write it had started turns out to be torn; reopening the file repairs it from
+    // the double-write buffer.
+    dm.reset();
+    ScribbleOnPage(num_pages - 1, BUSTUB_PAGE_SIZE, BUSTUB_PAGE_SIZE / 2, std::string(BUSTUB_PAGE_SIZE / 2, 'x'));
+    DiskManagerPosix reopened("test.db");
+    EXPECT_EQ(nullptr, reopened.GetDoubleWriteBuffer());
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      reopened.ReadPage(page_id, buf.data());
+      ASSERT_TRUE(same(pages[page_id])) << page_id;
+    }
+    reopened.ShutDown();
+    EXPECT_FALSE(std::ifstream("test.dwb").good());
+  }
+
+  // Scenario: a clean shutdown leaves nothing to repair.
+  remove("test.db");
+  DiskManagerPosix dm("test.db", false, BUSTUB_PAGE_SIZE, options);
+  dm.WritePage(0, data.data());
+  EXPECT_TRUE(std::ifstream("test.dwb").good());
+  // The pages of the free-space map are torn like any other, so they go through the buffer too.
+  const page_id_t free_page = dm.AllocatePage();
+  dm.DeallocatePage(free_page);
+  dm.SaveFreeSpaceMap(dm.GetFreePages());
+  EXPECT_EQ(2, dm.GetDoubleWriteBuffer()->GetNumSyncs());
+  dm.ShutDown();
+  EXPECT_FALSE(std::ifstream("test.dwb").good());
+
+  // Scenario: a double-write buffer file whose last batch is torn only restores its intact slots.
+  {
+    DoubleWriteBuffer buffer("test.dwb", BUSTUB_PAGE_SIZE, [] {}, 4);
+    fill(1, 2);
+    auto ignore = [](page_id_t, const char *) {};
+    buffer.Write({{1, data.data()}, {2, data.data()}}, ignore);
+  }
+  {
+    std::fstream file("test.dwb", std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(BUSTUB_PAGE_ALIGNMENT + BUSTUB_PAGE_SIZE + 10);
+    file.write("torn", 4);
+  }
+  std::vector<page_id_t> restored;
+  auto restore = [&](page_id_t page_id, const char *page) {
+    restored.push_back(page_id);
+    EXPECT_EQ(0, memcmp(page, data.data(), BUSTUB_PAGE_SIZE));
+  };
+  EXPECT_EQ(1, DoubleWriteBuffer::Recover("test.dwb", BUSTUB_PAGE_SIZE, restore));
+  EXPECT_EQ(std::vector<page_id_t>{1}, restored);
+  EXPECT_EQ(0, DoubleWriteBuffer::Recover("test.dwb", 2 * BUSTUB_PAGE_SIZE, [](page_id_t, const char *) {}));
+}
+
+TEST_F(DiskManagerTest, FreeSpaceMapTest) {
+  std::vector<char> data(BUSTUB_PAGE_SIZE, 'a');
+  {
+    DiskManager dm("test.db");
+    for (page_id_t page_id = 0; page_id < 10; page_id++) {
+      ASSERT_EQ(page_id, dm.AllocatePage());
+      dm.WritePage(page_id, data.data());
+    }
+
+    // Scenario: freed pages are reused, the closest to the hint first, or the lowest without a hint.
+    for (page_id_t page_id : {2, 5, 6, 8, 9}) {
+      dm.DeallocatePage(page_id);
+    }
+    EXPECT_FALSE(dm.IsAllocated(5));
+    EXPECT_TRUE(dm.IsAllocated(4));
+    EXPECT_EQ(5, dm.AllocatePage(4));
+    EXPECT_EQ(2, dm.AllocatePage());
+    EXPECT_TRUE(dm.IsAllocated(5));
+
+    // Scenario: with a stride, the ids skipped to reach the residue become free pages.
+    EXPECT_EQ(11, dm.AllocatePage(INVALID_PAGE_ID, 4, 3));
+    EXPECT_EQ((std::vector<page_id_t>{6, 8, 9, 10}), dm.GetFreePages());
+
+    // Scenario: vacuuming cuts the free pages at the end of the file off, and only those.
+    dm.DeallocatePage(11);
+    EXPECT_EQ(2, dm.Vacuum(dm.GetFreePages()));
+    EXPECT_EQ(8, dm.GetNumPages());
+    EXPECT_EQ(std::vector<page_id_t>{6}, dm.GetFreePages());
+    dm.ShutDown();
+  }
+
+  // Scenario: the free-space map is saved in the file; reusing a page drops it, so that a crash cannot hand the page
+  // out twice.
+  {
+    DiskManager dm("test.db");
+    EXPECT_EQ(std::vector<page_id_t>{6}, dm.GetFreePages());
+    EXPECT_EQ(6, dm.AllocatePage());
+    dm.ShutDown();
+  }
+  {
+    DiskManager dm("test.db");
+    EXPECT_TRUE(dm.GetFreePages().empty());
+    EXPECT_EQ(8, dm.AllocatePage());
+    dm.DeallocatePage(3);
+    dm.SaveFreeSpaceMap(dm.GetFreePages());
+    dm.ShutDown();
+  }
+
+  // Scenario: a damaged map is ignored, leaking its pages rather than handing out pages in use.
+  ScribbleOnPage(3, BUSTUB_PAGE_SIZE, 20, "x");
+  DiskManager dm("test.db");
+  EXPECT_TRUE(dm.GetFreePages().empty());
+  EXPECT_EQ(8, dm.AllocatePage());
+  dm.ShutDown();
+}
+
+TEST_F(DiskManagerTest, SegmentTest) {
+  DiskManager dm("test.db");
+  EXPECT_EQ(0, dm.AllocatePage());
+  const segment_id_t table = dm.CreateSegment();
+  const segment_id_t index = dm.CreateSegment();
+
+  // Scenario: segments grow by whole extents, so that the pages of one stay contiguous while both grow together.
+  // The pages skipped to align an extent are free pages outside of every segment.
+  page_id_t table_page = dm.AllocatePage(INVALID_PAGE_ID, 1, 0, table);
+  page_id_t index_page = dm.AllocatePage(INVALID_PAGE_ID, 1, 0, index);
+  EXPECT_EQ(EXTENT_PAGES, table_page);
+  EXPECT_EQ(2 * EXTENT_PAGES, index_page);
+  for (int i = 1; i < EXTENT_PAGES; i++) {
+    table_page = dm.AllocatePage(table_page);
+    index_page = dm.AllocatePage(index_page);
+    EXPECT_EQ(EXTENT_PAGES + i, table_page);
+    EXPECT_EQ(2 * EXTENT_PAGES + i, index_page);
+  }
+  EXPECT_EQ(3 * EXTENT_PAGES, dm.AllocatePage(table_page));
+  EXPECT_EQ((std::vector<page_id_t>{EXTENT_PAGES, 3 * EXTENT_PAGES}), dm.GetSegmentExtents(table));
+  EXPECT_EQ(table, dm.GetSegment(EXTENT_PAGES + 2));
+  EXPECT_EQ(INVALID_SEGMENT_ID, dm.GetSegment(1));
+  EXPECT_EQ(1, dm.AllocatePage());
+
+  // Scenario: a freed page is reused by its own segment only.
+  dm.DeallocatePage(EXTENT_PAGES + 2);
+  EXPECT_FALSE(dm.IsAllocated(EXTENT_PAGES + 2));
+  EXPECT_EQ(4 * EXTENT_PAGES, dm.AllocatePage(INVALID_PAGE_ID, 1, 0, index));
+  EXPECT_EQ(2, dm.AllocatePage());
+  EXPECT_EQ(EXTENT_PAGES + 2, dm.AllocatePage(INVALID_PAGE_ID, 1, 0, table));
+
+  // Scenario: with a stride, the pages of the residue in the extent are used.
+  EXPECT_EQ(3 * EXTENT_PAGES + 3, dm.AllocatePage(3 * EXTENT_PAGES, 4, 3));
+
+  // Scenario: the free pages of an extent are listed as free, but vacuuming leaves the extent alone.
+  const auto free_pages = dm.GetFreePages();
+  EXPECT_EQ(4 * EXTENT_PAGES + EXTENT_PAGES - 1, free_pages.back());
+  EXPECT_EQ(0, dm.Vacuum(free_pages));
+  EXPECT_EQ(4 * EXTENT_PAGES + 1, dm.AllocatePage(4 * EXTENT_PAGES));
+  dm.ShutDown();
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler_test.cpp
+//
+// Identification: test/storage/disk_scheduler_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <vector>
+
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_scheduler.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, ScheduleWriteReadPageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get());
+
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  auto promise1 = disk_scheduler->CreatePromise();
+  auto future1 = promise1.get_future();
+  auto promise2 = disk_scheduler->CreatePromise();
+  auto future2 = promise2.get_future();
+
+  disk_scheduler->Schedule({/*is_write=*/true, data, /*page_id=*/0, std::move(promise1)});
+  disk_scheduler->Schedule({/*is_write=*/false, buf, /*page_id=*/0, std::move(promise2)});
+
+  ASSERT_TRUE(future1.get());
+  ASSERT_TRUE(future2.get());
+  ASSERT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  disk_scheduler = nullptr;  // Call the DiskScheduler destructor to finish all scheduled jobs.
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, PerPageOrderTest) {
+  const size_t num_pages = 16;
+  const size_t num_rounds = 50;
+
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get(), 4);
+
+  // Requests on the same page must be executed in the order they were scheduled, even though requests on different
+  // pages are spread across workers. Every read must observe the write scheduled right before it.
+  std::vector<std::vector<char>> writes(num_pages * num_rounds, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<std::vector<char>> reads(num_pages * num_rounds, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<std::future<bool>> futures;
+  for (size_t round = 0; round < num_rounds; round++) {
+    for (size_t page = 0; page < num_pages; page++) {
+      auto idx = round * num_pages + page;
+      snprintf(writes[idx].data(), BUSTUB_PAGE_SIZE, "page %zu round %zu", page, round);
+
+      auto write_promise = disk_scheduler->CreatePromise();
+      futures.emplace_back(write_promise.get_future());
+      disk_scheduler->Schedule(
+          {true, writes[idx].data(), static_cast<page_id_t>(page), std::move(write_promise)});
+
+      auto read_promise = disk_scheduler->CreatePromise();
+      futures.emplace_back(read_promise.get_future());
+      disk_scheduler->Schedule({false, reads[idx].data(), static_cast<page_id_t>(page), std::move(read_promise)});
+    }
+  }
+
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  for (size_t idx = 0; idx < writes.size(); idx++) {
+    ASSERT_EQ(writes[idx], reads[idx]);
+  }
+
+  disk_scheduler = nullptr;
+  dm->ShutDown();
+}
+
+}  // namespace bustub
@@ -23,7 +23,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(PageGuardTest, DISABLED_SampleTest) {
+TEST(PageGuardTest, SampleTest) {
   const std::string db_name = "test.db";
   const size_t buffer_pool_size = 5;
   const size_t k = 2;
@@ -48,4 +48,52 @@ TEST(PageGuardTest, DISABLED_SampleTest) {
   disk_manager->ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST(PageGuardTest, OptimisticTest) {
+  const size_t buffer_pool_size = 2;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_shared<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_shared<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  page_id_t page_id0;
+  page_id_t page_id1;
+  auto *page0 = bpm->NewPage(&page_id0);
+  ASSERT_NE(nullptr, page0);
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id1));
+  EXPECT_TRUE(bpm->UnpinPage(page_id0, false));
+  EXPECT_TRUE(bpm->UnpinPage(page_id1, false));
+
+  // Scenario: an optimistic read takes no pin, and stays valid until the page is written.
+  auto guard = bpm->FetchPageOptimistic(page_id0);
+  ASSERT_TRUE(guard.Validate());
+  EXPECT_EQ(page_id0, guard.PageId());
+  EXPECT_EQ(page0->GetData(), guard.GetData());
+  EXPECT_EQ(0, page0->GetPinCount());
+  {
+    auto read_guard = bpm->FetchPageRead(page_id0);
+    EXPECT_TRUE(guard.Validate());
+  }
+  {
+    auto write_guard = bpm->FetchPageWrite(page_id0);
+    EXPECT_FALSE(guard.Validate());
+    // A page that is being written cannot be read optimistically.
+    EXPECT_FALSE(bpm->FetchPageOptimistic(page_id0).Validate());
+  }
+  EXPECT_FALSE(guard.Validate());
+
+  // Scenario: the read is invalidated when the frame is given to another page.
+  guard = bpm->FetchPageOptimistic(page_id0);
+  ASSERT_TRUE(guard.Validate());
+  page_id_t page_id2;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id2));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id2));
+  EXPECT_FALSE(guard.Validate());
+
+  // Scenario: pages that are not in the buffer pool are not read from disk.
+  EXPECT_FALSE(bpm->FetchPageOptimistic(page_id0).Validate());
+
+  disk_manager->ShutDown();
+}
+
 }  // namespace bustub
@@ -13,14 +13,17 @@
 #include <algorithm>
 #include <cstdio>
 #include <iostream>
+#include <random>
 #include <string>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -61,4 +64,86 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, GetTuplesTest) {
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}}};
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(TUPLE_FETCH_BATCH_PAGES + 4, disk_manager.get());
+  TableHeap table(bpm.get());
+
+  std::vector<RID> rids;
+  for (int i = 0; i < 3000; ++i) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(40, 'a' + i % 26))},
+                &schema);
+    rids.push_back(*table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple));
+  }
+  ASSERT_GT(rids.back().GetPageId() - rids.front().GetPageId(), TUPLE_FETCH_BATCH_PAGES * 2);
+
+  // Scenario: a batch of rids in random order, spread over more pages than a single fetch pins and with several rids
+  // on the same page, comes back in the order it was asked for.
+  std::vector<int> indices;
+  std::mt19937 rng(15445);
+  std::uniform_int_distribution<int> dist(0, static_cast<int>(rids.size()) - 1);
+  std::vector<RID> batch;
+  for (int i = 0; i < 500; ++i) {
+    indices.push_back(dist(rng));
+    batch.push_back(rids[indices.back()]);
+  }
+  auto tuples = table.GetTuples(batch);
+  ASSERT_EQ(batch.size(), tuples.size());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    EXPECT_EQ(batch[i], tuples[i].second.GetRid());
+    EXPECT_EQ(indices[i], tuples[i].second.GetValue(&schema, 0).GetAs<int32_t>());
+    EXPECT_FALSE(tuples[i].first.is_deleted_);
+  }
+
+  // Scenario: every page was unpinned, and an empty batch reads nothing.
+  for (size_t i = 0; i < bpm->GetPoolSize(); ++i) {
+    EXPECT_EQ(0, bpm->GetPages()[i].GetPinCount());
+  }
+  EXPECT_TRUE(table.GetTuples({}).empty());
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, GetTuplesSmallPoolTest) {
+  Schema schema{{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}}};
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get());
+  ASSERT_LT(BUFFER_POOL_SIZE, TUPLE_FETCH_BATCH_PAGES);
+  TableHeap table(bpm.get());
+
+  std::vector<RID> rids;
+  for (int i = 0; i < 2000; ++i) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(40, 'a' + i % 26))},
+                &schema);
+    rids.push_back(*table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple));
+  }
+  ASSERT_GT(rids.back().GetPageId() - rids.front().GetPageId(), TUPLE_FETCH_BATCH_PAGES * 2);
+
+  // Scenario: the pool cannot pin a whole batch, so the batches shrink to what it can pin.
+  std::vector<RID> batch(rids.rbegin(), rids.rend());
+  auto tuples = table.GetTuples(batch);
+  ASSERT_EQ(batch.size(), tuples.size());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    EXPECT_EQ(batch[i], tuples[i].second.GetRid());
+    EXPECT_EQ(static_cast<int>(batch.size() - 1 - i), tuples[i].second.GetValue(&schema, 0).GetAs<int32_t>());
+  }
+
+  // Scenario: with every frame pinned elsewhere, not even a single page can be read, which the caller can handle.
+  std::vector<page_id_t> pinned(BUFFER_POOL_SIZE);
+  for (auto &page_id : pinned) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  EXPECT_THROW(table.GetTuples(batch), Exception);
+  for (auto page_id : pinned) {
+    bpm->UnpinPage(page_id, false);
+  }
+
+  // Scenario: once the frames are unpinned, the same batch reads again and leaves nothing pinned.
+  EXPECT_EQ(batch.size(), table.GetTuples(batch).size());
+  for (size_t i = 0; i < bpm->GetPoolSize(); ++i) {
+    EXPECT_EQ(0, bpm->GetPages()[i].GetPinCount());
+  }
+}
+
 }  // namespace bustub
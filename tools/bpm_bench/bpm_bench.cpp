@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <memory>
@@ -13,13 +14,16 @@
 #include "argparse/argparse.hpp"
 #include "binder/binder.h"
 #include "buffer/buffer_pool_manager.h"
-#include "buffer/lru_k_replacer.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "buffer/replacer_factory.h"
 #include "common/config.h"
 #include "common/exception.h"
 #include "common/util/string_util.h"
 #include "fmt/core.h"
 #include "fmt/std.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/disk/disk_manager_uring.h"
 
 #include <sys/time.h>
 
@@ -35,22 +39,40 @@ static const size_t LRU_K_SIZE = 16;
 static const size_t BUSTUB_PAGE_CNT = 6400;
 static const size_t BUSTUB_BPM_SIZE = 64;
 
+auto Percentile(std::vector<uint64_t> *samples, double percentile) -> uint64_t {
+  if (samples->empty()) {
+    return 0;
+  }
+  auto nth = samples->begin() + static_cast<size_t>(percentile * (samples->size() - 1));
+  std::nth_element(samples->begin(), nth, samples->end());
+  return *nth;
+}
+
 struct BpmTotalMetrics {
   uint64_t scan_cnt_{0};
   uint64_t get_cnt_{0};
+  std::vector<uint64_t> scan_fetch_us_;
+  std::vector<uint64_t> get_fetch_us_;
   uint64_t start_time_{0};
   std::mutex mutex_;
 
   void Begin() { start_time_ = ClockMs(); }
 
-  void ReportScan(uint64_t scan_cnt) {
+  void ReportScan(uint64_t scan_cnt, const std::vector<uint64_t> &fetch_us) {
     std::unique_lock<std::mutex> l(mutex_);
     scan_cnt_ += scan_cnt;
+    scan_fetch_us_.insert(scan_fetch_us_.end(), fetch_us.begin(), fetch_us.end());
   }
 
-  void ReportGet(uint64_t get_cnt) {
+  void ReportGet(uint64_t get_cnt, const std::vector<uint64_t> &fetch_us) {
     std::unique_lock<std::mutex> l(mutex_);
     get_cnt_ += get_cnt;
+    get_fetch_us_.insert(get_fetch_us_.end(), fetch_us.begin(), fetch_us.end());
+  }
+
+  void ReportLatency() {
+    fmt::print("scan fetch p99 latency (us): {}\n", Percentile(&scan_fetch_us_, 0.99));
+    fmt::print("get fetch p99 latency (us): {}\n", Percentile(&get_fetch_us_, 0.99));
   }
 
   void Report() {
@@ -71,6 +93,7 @@ struct BpmMetrics {
   uint64_t last_report_at_{0};
   uint64_t last_cnt_{0};
   uint64_t cnt_{0};
+  std::vector<uint64_t> fetch_us_;
   std::string reporter_;
   uint64_t duration_ms_;
 
@@ -79,6 +102,11 @@ struct BpmMetrics {
 
   void Tick() { cnt_ += 1; }
 
+  void RecordFetch(std::chrono::steady_clock::time_point start) {
+    fetch_us_.push_back(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+  }
+
   void Begin() { start_time_ = ClockMs(); }
 
   void Report() {
@@ -104,12 +132,36 @@ struct BpmMetrics {
 auto main(int argc, char **argv) -> int {
   using bustub::AccessType;
   using bustub::BufferPoolManager;
+  using bustub::DiskManager;
+  using bustub::DiskManagerPosix;
   using bustub::DiskManagerUnlimitedMemory;
+  using bustub::DiskManagerUring;
+  using bustub::FrameArenaOptions;
+  using bustub::HugePageMode;
+  using bustub::NumaPlacement;
+  using bustub::ParallelBufferPoolManager;
+  using bustub::ReplacerFactory;
   using bustub::page_id_t;
 
   argparse::ArgumentParser program("bustub-bpm-bench");
   program.add_argument("--duration").help("run bpm bench for n milliseconds");
   program.add_argument("--latency").help("set disk latency to n milliseconds");
+  program.add_argument("--shards").help("split the buffer pool into n independent instances");
+  program.add_argument("--disk").help("disk manager to use: memory (default), fstream, pread, direct or uring");
+  program.add_argument("--replacer").help("replacement policy to use: lruk (default), lru, clock, 2q or arc");
+  program.add_argument("--scan-threads").help("number of scan threads");
+  program.add_argument("--get-threads").help("number of get threads");
+  program.add_argument("--pages").help("number of pages, fewer than the pool size keeps them all resident");
+  program.add_argument("--flusher").help("percentage of frames the background writer keeps clean, 0 (default) is off");
+  program.add_argument("--huge-pages").help("huge pages for the frames: none, thp (default) or hugetlb");
+  program.add_argument("--numa").help("placement of the frames on NUMA nodes: first-touch (default) or interleave");
+  program.add_argument("--page-size").help("page size of the database in bytes, 4096 (default) to 65536");
+  program.add_argument("--compressed-cache").help("MiB of compressed copies of evicted pages, 0 (default) is off");
+  program.add_argument("--checksums").help("stamp and verify page checksums").default_value(false).implicit_value(true);
+  program.add_argument("--double-write")
+      .help("write pages through a double-write buffer, not with memory or fstream")
+      .default_value(false)
+      .implicit_value(true);
 
   try {
     program.parse_args(argc, argv);
@@ -129,14 +181,151 @@ auto main(int argc, char **argv) -> int {
     latency_ms = std::stoi(program.get("--latency"));
   }
 
-  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
-  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+  uint64_t shards = 1;
+  if (program.present("--shards")) {
+    shards = std::stoi(program.get("--shards"));
+  }
+  if (shards == 0 || shards > BUSTUB_BPM_SIZE) {
+    std::cerr << "--shards must be between 1 and " << BUSTUB_BPM_SIZE << std::endl;
+    return 1;
+  }
+
+  uint64_t scan_threads = BUSTUB_SCAN_THREAD;
+  if (program.present("--scan-threads")) {
+    scan_threads = std::stoi(program.get("--scan-threads"));
+  }
+
+  uint64_t get_threads = BUSTUB_GET_THREAD;
+  if (program.present("--get-threads")) {
+    get_threads = std::stoi(program.get("--get-threads"));
+  }
+
+  uint64_t page_cnt = BUSTUB_PAGE_CNT;
+  if (program.present("--pages")) {
+    page_cnt = std::stoi(program.get("--pages"));
+  }
+  if (page_cnt == 0) {
+    std::cerr << "--pages must be positive" << std::endl;
+    return 1;
+  }
+
+  uint64_t flusher = 0;
+  if (program.present("--flusher")) {
+    flusher = std::stoi(program.get("--flusher"));
+  }
+  if (flusher > 100) {
+    std::cerr << "--flusher must be between 0 and 100" << std::endl;
+    return 1;
+  }
+
+  std::string disk = "memory";
+  if (program.present("--disk")) {
+    disk = program.get("--disk");
+  }
+
+  std::string replacer = "lruk";
+  if (program.present("--replacer")) {
+    replacer = program.get("--replacer");
+  }
+  auto replacer_type = ReplacerFactory::ParseReplacerType(replacer);
+  if (!replacer_type.has_value()) {
+    std::cerr << "unknown replacer " << replacer << std::endl;
+    return 1;
+  }
+
+  FrameArenaOptions arena_options;
+  std::string huge_pages = "thp";
+  if (program.present("--huge-pages")) {
+    huge_pages = program.get("--huge-pages");
+  }
+  if (huge_pages == "none") {
+    arena_options.huge_pages_ = HugePageMode::None;
+  } else if (huge_pages == "thp") {
+    arena_options.huge_pages_ = HugePageMode::Transparent;
+  } else if (huge_pages == "hugetlb") {
+    arena_options.huge_pages_ = HugePageMode::Explicit;
+  } else {
+    std::cerr << "unknown huge page mode " << huge_pages << std::endl;
+    return 1;
+  }
+  std::string numa = "first-touch";
+  if (program.present("--numa")) {
+    numa = program.get("--numa");
+  }
+  if (numa == "first-touch") {
+    arena_options.numa_placement_ = NumaPlacement::FirstTouch;
+  } else if (numa == "interleave") {
+    arena_options.numa_placement_ = NumaPlacement::Interleave;
+  } else {
+    std::cerr << "unknown NUMA placement " << numa << std::endl;
+    return 1;
+  }
+
+  size_t page_size = bustub::BUSTUB_PAGE_SIZE;
+  if (program.present("--page-size")) {
+    page_size = std::stoi(program.get("--page-size"));
+  }
+  if (!bustub::IsValidPageSize(page_size)) {
+    std::cerr << "--page-size must be a power of two from 4096 to 65536" << std::endl;
+    return 1;
+  }
+
+  uint64_t compressed_cache_mb = 0;
+  if (program.present("--compressed-cache")) {
+    compressed_cache_mb = std::stoi(program.get("--compressed-cache"));
+  }
+
+  bustub::DbFileOptions db_file_options;
+  db_file_options.checksums_ = program.get<bool>("--checksums");
+  db_file_options.double_write_ = program.get<bool>("--double-write");
+
+  const std::string db_file = "bpm_bench.db";
+  remove(db_file.c_str());
+  std::unique_ptr<DiskManager> disk_manager;
+  DiskManagerUnlimitedMemory *memory_disk_manager = nullptr;
+  if (disk == "memory") {
+    auto dm = std::make_unique<DiskManagerUnlimitedMemory>(page_size);
+    memory_disk_manager = dm.get();
+    disk_manager = std::move(dm);
+  } else if (disk == "fstream") {
+    disk_manager = std::make_unique<DiskManager>(db_file, page_size, db_file_options);
+  } else if (disk == "pread") {
+    disk_manager = std::make_unique<DiskManagerPosix>(db_file, false, page_size, db_file_options);
+  } else if (disk == "direct") {
+    disk_manager = std::make_unique<DiskManagerPosix>(db_file, true, page_size, db_file_options);
+  } else if (disk == "uring") {
+    disk_manager =
+        std::make_unique<DiskManagerUring>(db_file, true, bustub::URING_QUEUE_DEPTH, page_size, db_file_options);
+  } else {
+    std::cerr << "unknown disk manager " << disk << std::endl;
+    return 1;
+  }
+  if (memory_disk_manager == nullptr && latency_ms > 0) {
+    std::cerr << "--latency only applies to the memory disk manager" << std::endl;
+    return 1;
+  }
+
+  // keep the total number of frames fixed so that different shard counts are comparable
+  std::unique_ptr<BufferPoolManager> bpm;
+  if (shards > 1) {
+    bpm = std::make_unique<ParallelBufferPoolManager>(shards, BUSTUB_BPM_SIZE / shards, disk_manager.get(),
+                                                      LRU_K_SIZE, nullptr, *replacer_type, arena_options);
+  } else {
+    bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE, nullptr,
+                                              *replacer_type, arena_options);
+  }
+  bpm->SetCompressedCacheSize(compressed_cache_mb << 20);
   std::vector<page_id_t> page_ids;
 
-  fmt::print(stderr, "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}\n",
-             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE);
+  fmt::print(stderr,
+             "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}, shards={}, disk={}, "
+             "replacer={}, scan_threads={}, get_threads={}, flusher={}, huge_pages={}, numa={}, page_size={}, "
+             "compressed_cache_mb={}, checksums={}, double_write={}\n",
+             page_cnt, duration_ms, latency_ms, LRU_K_SIZE, bpm->GetPoolSize(), shards, disk, replacer, scan_threads,
+             get_threads, flusher, huge_pages, numa, page_size, compressed_cache_mb, db_file_options.checksums_,
+             db_file_options.double_write_);
 
-  for (size_t i = 0; i < BUSTUB_PAGE_CNT; i++) {
+  for (size_t i = 0; i < page_cnt; i++) {
     page_id_t page_id;
     auto *page = bpm->NewPage(&page_id);
     if (page == nullptr) {
@@ -150,7 +339,12 @@ auto main(int argc, char **argv) -> int {
   }
 
   // enable disk latency after creating all pages
-  disk_manager->SetLatency(latency_ms);
+  if (memory_disk_manager != nullptr) {
+    memory_disk_manager->SetLatency(latency_ms);
+  }
+  if (flusher > 0) {
+    bpm->StartFlusher(flusher);
+  }
 
   fmt::print(stderr, "[info] benchmark start\n");
 
@@ -159,15 +353,17 @@ auto main(int argc, char **argv) -> int {
 
   std::vector<std::thread> threads;
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_SCAN_THREAD; thread_id++) {
-    threads.emplace_back(std::thread([thread_id, &page_ids, &bpm, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; thread_id < scan_threads; thread_id++) {
+    threads.emplace_back(std::thread([thread_id, page_cnt, scan_threads, &page_ids, &bpm, duration_ms, &total_metrics] {
       BpmMetrics metrics(fmt::format("scan {:>2}", thread_id), duration_ms);
       metrics.Begin();
 
-      size_t page_idx = BUSTUB_PAGE_CNT * thread_id / BUSTUB_SCAN_THREAD;
+      size_t page_idx = page_cnt * thread_id / scan_threads;
 
       while (!metrics.ShouldFinish()) {
+        auto start = std::chrono::steady_clock::now();
         auto *page = bpm->FetchPage(page_ids[page_idx], AccessType::Scan);
+        metrics.RecordFetch(start);
         if (page == nullptr) {
           continue;
         }
@@ -181,27 +377,29 @@ auto main(int argc, char **argv) -> int {
         page->WUnlatch();
 
         bpm->UnpinPage(page->GetPageId(), true, AccessType::Scan);
-        page_idx = (page_idx + 1) % BUSTUB_PAGE_CNT;
+        page_idx = (page_idx + 1) % page_cnt;
         metrics.Tick();
         metrics.Report();
       }
 
-      total_metrics.ReportScan(metrics.cnt_);
+      total_metrics.ReportScan(metrics.cnt_, metrics.fetch_us_);
     }));
   }
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_GET_THREAD; thread_id++) {
-    threads.emplace_back(std::thread([thread_id, &page_ids, &bpm, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; thread_id < get_threads; thread_id++) {
+    threads.emplace_back(std::thread([thread_id, page_cnt, &page_ids, &bpm, duration_ms, &total_metrics] {
       std::random_device r;
       std::default_random_engine gen(r());
-      zipfian_int_distribution<size_t> dist(0, BUSTUB_PAGE_CNT - 1, 0.8);
+      zipfian_int_distribution<size_t> dist(0, page_cnt - 1, 0.8);
 
       BpmMetrics metrics(fmt::format("get  {:>2}", thread_id), duration_ms);
       metrics.Begin();
 
       while (!metrics.ShouldFinish()) {
         auto page_idx = dist(gen);
+        auto start = std::chrono::steady_clock::now();
         auto *page = bpm->FetchPage(page_ids[page_idx], AccessType::Get);
+        metrics.RecordFetch(start);
         if (page == nullptr) {
           continue;
         }
@@ -218,7 +416,7 @@ auto main(int argc, char **argv) -> int {
         metrics.Report();
       }
 
-      total_metrics.ReportGet(metrics.cnt_);
+      total_metrics.ReportGet(metrics.cnt_, metrics.fetch_us_);
     }));
   }
 
@@ -228,5 +426,31 @@ auto main(int argc, char **argv) -> int {
 
   total_metrics.Report();
 
+  auto hit_rate = [&bpm](AccessType access_type) {
+    auto hits = bpm->GetHitCount(access_type);
+    auto total = hits + bpm->GetMissCount(access_type);
+    return total == 0 ? 0.0 : hits / static_cast<double>(total);
+  };
+  fmt::print("scan hit rate: {:.4f}\n", hit_rate(AccessType::Scan));
+  fmt::print("get hit rate: {:.4f}\n", hit_rate(AccessType::Get));
+  uint64_t hits = 0;
+  uint64_t accesses = 0;
+  for (auto access_type : {AccessType::Unknown, AccessType::Get, AccessType::Scan}) {
+    hits += bpm->GetHitCount(access_type);
+    accesses += bpm->GetHitCount(access_type) + bpm->GetMissCount(access_type);
+  }
+  fmt::print("hit ratio: {:.4f}\n", accesses == 0 ? 0.0 : hits / static_cast<double>(accesses));
+  total_metrics.ReportLatency();
+  const auto stats = bpm->GetStats();
+  fmt::print("disk reads: {}\n", disk_manager->GetReadLatency().count_);
+  fmt::print("compressed cache hits: {}\n", stats.compressed_hits_);
+
+  bpm = nullptr;
+  disk_manager->ShutDown();
+  if (memory_disk_manager == nullptr) {
+    remove(db_file.c_str());
+    remove("bpm_bench.log");
+  }
+
   return 0;
 }
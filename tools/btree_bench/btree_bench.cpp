@@ -43,10 +43,13 @@ struct BTreeTotalMetrics {
   uint64_t write_cnt_{0};
   uint64_t read_cnt_{0};
   uint64_t start_time_{0};
+  uint64_t end_time_{0};
   std::mutex mutex_;
 
   void Begin() { start_time_ = ClockMs(); }
 
+  void End() { end_time_ = ClockMs(); }
+
   void ReportWrite(uint64_t scan_cnt) {
     std::unique_lock<std::mutex> l(mutex_);
     write_cnt_ += scan_cnt;
@@ -57,15 +60,16 @@ struct BTreeTotalMetrics {
     read_cnt_ += get_cnt;
   }
 
-  void Report() {
-    auto now = ClockMs();
-    auto elsped = now - start_time_;
+  void Report(const bustub::BPlusTreeStats &stats) {
+    auto elsped = end_time_ - start_time_;
     auto write_per_sec = write_cnt_ / static_cast<double>(elsped) * 1000;
     auto read_per_sec = read_cnt_ / static_cast<double>(elsped) * 1000;
 
     fmt::print("<<< BEGIN\n");
     fmt::print("write: {}\n", write_per_sec);
     fmt::print("read: {}\n", read_per_sec);
+    fmt::print("pages: {}\n", stats.NumPages());
+    fmt::print("bytes_per_key: {}\n", stats.BytesPerKey());
     fmt::print(">>> END\n");
   }
 };
@@ -119,6 +123,8 @@ auto main(int argc, char **argv) -> int {
 
   argparse::ArgumentParser program("bustub-btree-bench");
   program.add_argument("--duration").help("run btree bench for n milliseconds");
+  program.add_argument("--read-threads").help("number of read threads");
+  program.add_argument("--write-threads").help("number of write threads");
 
   try {
     program.parse_args(argc, argv);
@@ -133,11 +139,22 @@ auto main(int argc, char **argv) -> int {
     duration_ms = std::stoi(program.get("--duration"));
   }
 
+  uint64_t read_threads = BUSTUB_READ_THREAD;
+  if (program.present("--read-threads")) {
+    read_threads = std::stoi(program.get("--read-threads"));
+  }
+
+  uint64_t write_threads = BUSTUB_WRITE_THREAD;
+  if (program.present("--write-threads")) {
+    write_threads = std::stoi(program.get("--write-threads"));
+  }
+
   auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
   auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
 
-  fmt::print(stderr, "[info] total_keys={}, duration_ms={}, lru_k_size={}, bpm_size={}\n", TOTAL_KEYS, duration_ms,
-             LRU_K_SIZE, BUSTUB_BPM_SIZE);
+  fmt::print(stderr,
+             "[info] total_keys={}, duration_ms={}, lru_k_size={}, bpm_size={}, read_threads={}, write_threads={}\n",
+             TOTAL_KEYS, duration_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE, read_threads, write_threads);
 
   auto key_schema = bustub::ParseCreateStatement("a bigint");
   bustub::GenericComparator<8> comparator(key_schema.get());
@@ -164,13 +181,13 @@ auto main(int argc, char **argv) -> int {
 
   std::vector<std::thread> threads;
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_READ_THREAD; thread_id++) {
-    threads.emplace_back(std::thread([thread_id, &index, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; thread_id < read_threads; thread_id++) {
+    threads.emplace_back(std::thread([thread_id, read_threads, &index, duration_ms, &total_metrics] {
       BTreeMetrics metrics(fmt::format("read  {:>2}", thread_id), duration_ms);
       metrics.Begin();
 
-      size_t key_start = TOTAL_KEYS / BUSTUB_READ_THREAD * thread_id;
-      size_t key_end = TOTAL_KEYS / BUSTUB_READ_THREAD * (thread_id + 1);
+      size_t key_start = TOTAL_KEYS / read_threads * thread_id;
+      size_t key_end = TOTAL_KEYS / read_threads * (thread_id + 1);
       std::random_device r;
       std::default_random_engine gen(r());
       std::uniform_int_distribution<size_t> dis(key_start, key_end - 1);
@@ -210,13 +227,13 @@ auto main(int argc, char **argv) -> int {
     }));
   }
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_WRITE_THREAD; thread_id++) {
-    threads.emplace_back(std::thread([thread_id, &index, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; thread_id < write_threads; thread_id++) {
+    threads.emplace_back(std::thread([thread_id, write_threads, &index, duration_ms, &total_metrics] {
       BTreeMetrics metrics(fmt::format("write {:>2}", thread_id), duration_ms);
       metrics.Begin();
 
-      size_t key_start = TOTAL_KEYS / BUSTUB_WRITE_THREAD * thread_id;
-      size_t key_end = TOTAL_KEYS / BUSTUB_WRITE_THREAD * (thread_id + 1);
+      size_t key_start = TOTAL_KEYS / write_threads * thread_id;
+      size_t key_end = TOTAL_KEYS / write_threads * (thread_id + 1);
       std::random_device r;
       std::default_random_engine gen(r());
       std::uniform_int_distribution<size_t> dis(key_start, key_end - 1);
@@ -261,7 +278,14 @@ auto main(int argc, char **argv) -> int {
     thread.join();
   }
 
-  total_metrics.Report();
+  total_metrics.End();
+
+  auto stats = index.GetStats();
+  const double avg_internal_prefix_bytes =
+      stats.internal_pages_ == 0 ? 0 : static_cast<double>(stats.internal_prefix_bytes_) / stats.internal_pages_;
+  fmt::print(stderr, "[info] height={}, leaf_pages={}, internal_pages={}, keys={}, avg_internal_prefix_bytes={:.2f}\n",
+             stats.height_, stats.leaf_pages_, stats.internal_pages_, stats.num_keys_, avg_internal_prefix_bytes);
+  total_metrics.Report(stats);
 
   return 0;
 }
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "fmt/core.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/normalized_key.h"
+#include "storage/table/tuple.h"
+#include "test_util.h"  // NOLINT
+
+struct KeyBenchResult {
+  double sort_compares_per_sec_;
+  double lookups_per_sec_;
+};
+
+/**
+ * Sorts the keys of the tuples, then binary searches for each of them in turn, the way a B+ tree page is searched.
+ * Every comparison goes through the comparator of the key type.
+ */
+template <class KeyType, class KeyComparator>
+auto RunBench(const std::vector<bustub::Tuple> &tuples, bustub::Schema *key_schema, size_t lookups)
+    -> KeyBenchResult {
+  KeyComparator comparator(key_schema);
+  std::vector<KeyType> keys(tuples.size());
+  for (size_t i = 0; i < tuples.size(); i++) {
+    keys[i].SetFromKey(tuples[i], *key_schema);
+  }
+
+  size_t compares = 0;
+  auto start = std::chrono::steady_clock::now();
+  std::sort(keys.begin(), keys.end(), [&](const KeyType &lhs, const KeyType &rhs) {
+    compares++;
+    return comparator(lhs, rhs) < 0;
+  });
+  auto sort_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::mt19937_64 gen(0x12345);
+  std::uniform_int_distribution<size_t> dis(0, keys.size() - 1);
+  size_t found = 0;
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < lookups; i++) {
+    const KeyType &key = keys[dis(gen)];
+    auto it = std::lower_bound(keys.begin(), keys.end(), key,
+                               [&](const KeyType &lhs, const KeyType &rhs) { return comparator(lhs, rhs) < 0; });
+    found += static_cast<size_t>(it != keys.end() && comparator(*it, key) == 0);
+  }
+  auto lookup_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (found != lookups) {
+    throw std::runtime_error("key not found");
+  }
+  return {compares / sort_elapsed, lookups / lookup_elapsed};
+}
+
+/**
+ * Compares GenericComparator, which decodes both keys into Values for every comparison, with NormalizedComparator,
+ * which compares keys encoded once into memcmp-ordered bytes, on keys of two integer columns.
+ */
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-key-bench");
+  program.add_argument("--keys").help("number of keys to sort and search");
+  program.add_argument("--lookups").help("number of binary searches");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_keys = 100000;
+  if (program.present("--keys")) {
+    num_keys = std::stoul(program.get("--keys"));
+  }
+
+  size_t lookups = 1000000;
+  if (program.present("--lookups")) {
+    lookups = std::stoul(program.get("--lookups"));
+  }
+
+  fmt::print(stderr, "[info] keys={}, lookups={}\n", num_keys, lookups);
+
+  auto key_schema = bustub::ParseCreateStatement("a int,b int");
+  // The first column has few distinct values, so that comparisons often go on to the second one.
+  std::mt19937_64 gen(0x54321);
+  std::uniform_int_distribution<int32_t> first(-100, 100);
+  std::uniform_int_distribution<int32_t> second(-1000000000, 1000000000);
+  std::vector<bustub::Tuple> tuples;
+  tuples.reserve(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    std::vector<bustub::Value> values{bustub::Value(bustub::TypeId::INTEGER, first(gen)),
+                                      bustub::Value(bustub::TypeId::INTEGER, second(gen))};
+    tuples.emplace_back(values, key_schema.get());
+  }
+
+  auto generic =
+      RunBench<bustub::GenericKey<8>, bustub::GenericComparator<8>>(tuples, key_schema.get(), lookups);
+  auto normalized =
+      RunBench<bustub::NormalizedKey<24>, bustub::NormalizedComparator<24>>(tuples, key_schema.get(), lookups);
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("generic sort compares: {:.0f}\n", generic.sort_compares_per_sec_);
+  fmt::print("generic lookups: {:.0f}\n", generic.lookups_per_sec_);
+  fmt::print("normalized sort compares: {:.0f}\n", normalized.sort_compares_per_sec_);
+  fmt::print("normalized lookups: {:.0f}\n", normalized.lookups_per_sec_);
+  fmt::print("lookup speedup: {:.2f}\n", normalized.lookups_per_sec_ / generic.lookups_per_sec_);
+  fmt::print(">>> END\n");
+
+  return 0;
+}
@@ -0,0 +1,108 @@
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cpp_random_distributions/zipfian_int_distribution.h>
+
+#include "argparse/argparse.hpp"
+#include "buffer/replacer_factory.h"
+#include "common/config.h"
+#include "fmt/core.h"
+
+/**
+ * Drives a replacer the way the buffer pool does: every operation touches a frame (RecordAccess, then pins and
+ * unpins it with SetEvictable), and a miss evicts a victim first. Frames are picked from a zipfian distribution so
+ * that the replacer holds a mix of hot and cold frames.
+ */
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  using bustub::AccessType;
+  using bustub::frame_id_t;
+  using bustub::page_id_t;
+  using bustub::ReplacerFactory;
+
+  argparse::ArgumentParser program("bustub-replacer-bench");
+  program.add_argument("--frames").help("number of frames in the replacer");
+  program.add_argument("--k").help("lookback constant of the replacer");
+  program.add_argument("--ops").help("number of accesses to replay");
+  program.add_argument("--replacer").help("replacement policy to use: lruk (default), lru, clock, 2q or arc");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t frames = 65536;
+  if (program.present("--frames")) {
+    frames = std::stoul(program.get("--frames"));
+  }
+
+  size_t k = 16;
+  if (program.present("--k")) {
+    k = std::stoul(program.get("--k"));
+  }
+
+  size_t ops = 1000000;
+  if (program.present("--ops")) {
+    ops = std::stoul(program.get("--ops"));
+  }
+
+  std::string replacer_name = "lruk";
+  if (program.present("--replacer")) {
+    replacer_name = program.get("--replacer");
+  }
+  auto replacer_type = ReplacerFactory::ParseReplacerType(replacer_name);
+  if (!replacer_type.has_value()) {
+    std::cerr << "unknown replacer " << replacer_name << std::endl;
+    return 1;
+  }
+
+  fmt::print(stderr, "[info] frames={}, k={}, ops={}, replacer={}\n", frames, k, ops, replacer_name);
+
+  auto replacer = ReplacerFactory::CreateReplacer(*replacer_type, frames, k);
+  // Pages come from a space twice the size of the replacer, so a fair share of the accesses miss and evict.
+  const size_t pages = frames * 2;
+  std::vector<frame_id_t> page_table(pages, -1);
+  std::vector<size_t> frame_to_page(frames);
+  std::mt19937_64 gen(0x12345);
+  zipfian_int_distribution<size_t> dist(0, pages - 1, 0.8);
+
+  size_t evictions = 0;
+  size_t next_free_frame = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < ops; i++) {
+    auto page = dist(gen);
+    auto frame_id = page_table[page];
+    if (frame_id == -1) {
+      if (next_free_frame < frames) {
+        frame_id = static_cast<frame_id_t>(next_free_frame++);
+      } else {
+        if (!replacer->Evict(&frame_id)) {
+          fmt::print(stderr, "no evictable frame\n");
+          return 1;
+        }
+        page_table[frame_to_page[frame_id]] = -1;
+        evictions++;
+      }
+      page_table[page] = frame_id;
+      frame_to_page[frame_id] = page;
+    }
+    replacer->RecordAccess(frame_id, i % 8 == 0 ? AccessType::Scan : AccessType::Get, static_cast<page_id_t>(page));
+    replacer->SetEvictable(frame_id, false);
+    replacer->SetEvictable(frame_id, true);
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("ops: {:.0f}\n", ops / elapsed);
+  fmt::print("evictions: {}\n", evictions);
+  fmt::print("hit ratio: {:.4f}\n", 1.0 - (evictions + next_free_frame) / static_cast<double>(ops));
+  fmt::print(">>> END\n");
+
+  return 0;
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <memory>
@@ -10,6 +11,7 @@
 
 #include "argparse/argparse.hpp"
 #include "binder/binder.h"
+#include "buffer/buffer_pool_manager.h"
 #include "common/bustub_instance.h"
 #include "common/exception.h"
 #include "common/util/string_util.h"
@@ -27,6 +29,15 @@ auto ClockMs() -> uint64_t {
   return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
 }
 
+auto Percentile(std::vector<uint64_t> *samples, double percentile) -> uint64_t {
+  if (samples->empty()) {
+    return 0;
+  }
+  auto nth = samples->begin() + static_cast<size_t>(percentile * (samples->size() - 1));
+  std::nth_element(samples->begin(), nth, samples->end());
+  return *nth;
+}
+
 static const size_t BUSTUB_TERRIER_THREAD = 2;
 static const size_t BUSTUB_TERRIER_CNT = 100;
 
@@ -37,6 +48,8 @@ struct TerrierTotalMetrics {
   uint64_t committed_update_txn_cnt_{0};
   uint64_t aborted_verify_txn_cnt_{0};
   uint64_t committed_verify_txn_cnt_{0};
+  std::vector<uint64_t> count_txn_us_;
+  std::vector<uint64_t> update_txn_us_;
   uint64_t start_time_{0};
   std::mutex mutex_;
 
@@ -48,16 +61,18 @@ struct TerrierTotalMetrics {
     committed_verify_txn_cnt_ += committed_cnt;
   }
 
-  void ReportCount(uint64_t aborted_cnt, uint64_t committed_cnt) {
+  void ReportCount(uint64_t aborted_cnt, uint64_t committed_cnt, const std::vector<uint64_t> &txn_us) {
     std::unique_lock<std::mutex> l(mutex_);
     aborted_count_txn_cnt_ += aborted_cnt;
     committed_count_txn_cnt_ += committed_cnt;
+    count_txn_us_.insert(count_txn_us_.end(), txn_us.begin(), txn_us.end());
   }
 
-  void ReportUpdate(uint64_t aborted_cnt, uint64_t committed_cnt) {
+  void ReportUpdate(uint64_t aborted_cnt, uint64_t committed_cnt, const std::vector<uint64_t> &txn_us) {
     std::unique_lock<std::mutex> l(mutex_);
     aborted_update_txn_cnt_ += aborted_cnt;
     committed_update_txn_cnt_ += committed_cnt;
+    update_txn_us_.insert(update_txn_us_.end(), txn_us.begin(), txn_us.end());
   }
 
   void Report() {
@@ -75,6 +90,9 @@ struct TerrierTotalMetrics {
     fmt::print("verify: {}\n", verify_txn_per_sec);
 
     fmt::print(">>> END\n");
+
+    fmt::print("update p99 latency (us): {}\n", Percentile(&update_txn_us_, 0.99));
+    fmt::print("count p99 latency (us): {}\n", Percentile(&count_txn_us_, 0.99));
   }
 };
 
@@ -85,17 +103,35 @@ struct TerrierMetrics {
   uint64_t last_aborted_txn_cnt_{0};
   uint64_t committed_txn_cnt_{0};
   uint64_t aborted_txn_cnt_{0};
+  /** Latency of every transaction, i.e. the time since the previous one ended. */
+  std::vector<uint64_t> txn_us_;
+  std::chrono::steady_clock::time_point last_txn_end_;
   std::string reporter_;
   uint64_t duration_ms_;
 
   explicit TerrierMetrics(std::string reporter, uint64_t duration_ms)
       : reporter_(std::move(reporter)), duration_ms_(duration_ms) {}
 
-  void TxnAborted() { aborted_txn_cnt_ += 1; }
+  void TxnAborted() {
+    aborted_txn_cnt_ += 1;
+    TxnEnded();
+  }
+
+  void TxnCommitted() {
+    committed_txn_cnt_ += 1;
+    TxnEnded();
+  }
 
-  void TxnCommitted() { committed_txn_cnt_ += 1; }
+  void TxnEnded() {
+    auto now = std::chrono::steady_clock::now();
+    txn_us_.push_back(std::chrono::duration_cast<std::chrono::microseconds>(now - last_txn_end_).count());
+    last_txn_end_ = now;
+  }
 
-  void Begin() { start_time_ = ClockMs(); }
+  void Begin() {
+    start_time_ = ClockMs();
+    last_txn_end_ = std::chrono::steady_clock::now();
+  }
 
   void Report() {
     auto now = ClockMs();
@@ -141,6 +177,7 @@ auto main(int argc, char **argv) -> int {
   program.add_argument("--force-create-index").help("create index in terrier bench");
   program.add_argument("--force-enable-update").help("use update statement in terrier bench");
   program.add_argument("--nft").help("number of NFTs in the bench");
+  program.add_argument("--flusher").help("run the background writer of the buffer pool (default: yes)");
 
   size_t bustub_nft_num = 10;
 
@@ -155,6 +192,10 @@ auto main(int argc, char **argv) -> int {
   auto bustub = std::make_unique<bustub::BustubInstance>();
   auto writer = bustub::SimpleStreamWriter(std::cerr);
 
+  if (program.present("--flusher") && !ParseBool(program.get("--flusher")) && bustub->buffer_pool_manager_ != nullptr) {
+    bustub->buffer_pool_manager_->StopFlusher();
+  }
+
   // create schema
   auto schema = "CREATE TABLE nft(id int, terrier int);";
   std::cerr << "x: create schema" << std::endl;
@@ -336,7 +377,7 @@ auto main(int argc, char **argv) -> int {
             metrics.Report();
           }
 
-          total_metrics.ReportUpdate(metrics.aborted_txn_cnt_, metrics.committed_txn_cnt_);
+          total_metrics.ReportUpdate(metrics.aborted_txn_cnt_, metrics.committed_txn_cnt_, metrics.txn_us_);
         }));
   }
 
@@ -375,7 +416,7 @@ auto main(int argc, char **argv) -> int {
         metrics.Report();
       }
 
-      total_metrics.ReportCount(metrics.aborted_txn_cnt_, metrics.committed_txn_cnt_);
+      total_metrics.ReportCount(metrics.aborted_txn_cnt_, metrics.committed_txn_cnt_, metrics.txn_us_);
     }));
   }
 